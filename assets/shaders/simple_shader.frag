@@ -3,6 +3,13 @@
 layout(location = 0) in vec3 vertexColor;
 layout(location = 0) out vec4 outColor;
 
+// 0 = vertex colors, 1 = grayscale
+layout(constant_id = 0) const uint COLOR_MODE = 0;
+
 void main() {
-  outColor = vec4(vertexColor, 1.0);
+  vec3 color = vertexColor;
+  if (COLOR_MODE == 1) {
+    color = vec3(dot(vertexColor, vec3(0.299, 0.587, 0.114)));
+  }
+  outColor = vec4(color, 1.0);
 }
\ No newline at end of file
@@ -1,20 +1,46 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
 layout(location = 0) out vec3 vertexColor;
 
-vec3 colors[3] = vec3[](
-vec3(1.0, 0.0, 0.0),
-vec3(0.0, 1.0, 0.0),
-vec3(0.0, 0.0, 1.0)
-);
+struct Vertex {
+  vec4 position;
+  vec4 color;
+};
 
-vec2 positions[3] = vec2[](
-  vec2(0.0, -0.5),
-  vec2(0.5, 0.5),
-  vec2(-0.5, 0.5)
-);
+struct Instance {
+  uint transformIndex;
+  uint padding[3];
+  vec4 color;
+};
+
+// Bindless storage buffers, see VulkanBindlessDescriptors
+layout(set = 0, binding = 1) readonly buffer Vertices {
+  Vertex vertices[];
+} vertexBuffers[];
+
+layout(set = 0, binding = 1) readonly buffer Instances {
+  Instance instances[];
+} instanceBuffers[];
+
+// World matrices of the transform hierarchy, see TransformHierarchy
+layout(set = 0, binding = 1) readonly buffer Transforms {
+  mat4 transforms[];
+} transformBuffers[];
+
+layout(push_constant) uniform DrawConstants {
+  mat4 viewProjection;
+  uint vertexBufferIndex;
+  uint instanceBufferIndex;
+  uint transformBufferIndex;
+} drawConstants;
 
 void main() {
-  gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-  vertexColor = colors[gl_VertexIndex];
-}
\ No newline at end of file
+  // Vertices are pulled from the storage buffer, gl_VertexIndex is the index from the index buffer plus the vertex offset of the mesh.
+  // gl_InstanceIndex includes firstInstance, so per-draw and indirect submission select the instance with it as well.
+  Vertex vertex = vertexBuffers[drawConstants.vertexBufferIndex].vertices[gl_VertexIndex];
+  Instance instance = instanceBuffers[drawConstants.instanceBufferIndex].instances[gl_InstanceIndex];
+  mat4 world = transformBuffers[drawConstants.transformBufferIndex].transforms[instance.transformIndex];
+  gl_Position = drawConstants.viewProjection * world * vec4(vertex.position.xy, 0.0, 1.0);
+  vertexColor = vertex.color.rgb * instance.color.rgb;
+}
@@ -71,7 +71,7 @@ namespace VulkandemoCLI {
             ss << " -A x64";
 #endif
             ss << " && ";
-            ss << "cmake --build " << buildDirectory << " --config " << buildType;
+            ss << "cmake --build " << buildDirectory << " --config " << buildType << " --parallel";
 
             std::string command = ss.str();
 #ifdef VDC_DEBUG
@@ -1,9 +1,15 @@
 #include "CompileShadersCommand.h"
+#include <algorithm>
 #include <sstream>
 
 namespace VulkandemoCLI {
 
     CLI::Command createCompileShadersCommand() {
+        CLI::Option buildDirectoryOption;
+        buildDirectoryOption.Name = "buildDir";
+        buildDirectoryOption.Usage = "Where the build files generated with CMake are stored";
+        buildDirectoryOption.Aliases = {"d"};
+
         CLI::Option releaseOption;
         releaseOption.Name = "release";
         releaseOption.Usage = "Use Release mode";
@@ -11,25 +17,30 @@ namespace VulkandemoCLI {
 
         CLI::Command command;
         command.Name = "shaders";
-        command.Usage = "Compile shaders";
+        command.Usage = "Compile shaders that are out of date (Requires a generated build directory)";
         command.Options = {
+                buildDirectoryOption,
                 releaseOption
         };
         command.Action = [](const CLI::Context& context) -> void {
-            const char* assetsDirectoryName = "assets";
-            const char* shaderDirectoryName = "shaders";
-
-            const char* binDirectoryName = "bin";
-            const char* buildTypeDirName = context.hasOption("release") ? "release" : "debug";
+            const char* buildType = context.hasOption("release") ? "Release" : "Debug";
+            const char* shadersTargetName = "shaders";
 
-            const char* cmakeScriptsDirectoryName = "cmake";
-            const char* cmakeScriptName = "compile_shaders.cmake";
+            const CLI::Option* buildDirectoryOption = context.getOption("buildDir");
+            std::string buildDirectory;
+            if (buildDirectoryOption != nullptr && buildDirectoryOption->Value.length() > 0) {
+                buildDirectory = buildDirectoryOption->Value;
+            } else {
+                std::string buildTypeCopy(buildType);
+                std::transform(buildTypeCopy.begin(), buildTypeCopy.end(), buildTypeCopy.begin(), ::tolower);
+                buildDirectory = "cmake-build-" + buildTypeCopy;
+            }
 
             std::stringstream ss;
-            ss << "cmake";
-            ss << " -DSHADER_ASSETS_DIR=" << assetsDirectoryName << "/" << shaderDirectoryName;
-            ss << " -DSHADER_OUTPUT_DIR=" << binDirectoryName << "/" << buildTypeDirName << "/" << shaderDirectoryName;
-            ss << " -P " << cmakeScriptsDirectoryName << "/" << cmakeScriptName;
+            ss << "cmake --build " << buildDirectory;
+            ss << " --config " << buildType;
+            ss << " --target " << shadersTargetName;
+            ss << " --parallel";
             std::string command = ss.str();
 
 #ifdef VDC_DEBUG
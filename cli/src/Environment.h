@@ -4,6 +4,8 @@
     #define VDC_PLATFORM_WINDOWS
 #elif defined(__APPLE__) || defined(__MACH__)
     #define VDC_PLATFORM_MACOS
+#elif defined(__linux__)
+    #define VDC_PLATFORM_LINUX
 #else
     #error "Unsupported platform"
 #endif
@@ -0,0 +1,253 @@
+#include "PackAssetsCommand.h"
+#include "Environment.h"
+#include "../../src/AssetArchiveFormat.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#ifdef VDC_LZ4
+    #include <lz4hc.h>
+#endif
+#ifdef VDC_ZSTD
+    #include <zstd.h>
+#endif
+
+namespace VulkandemoCLI {
+
+    using namespace Vulkandemo;
+
+    struct PackedFile {
+        std::string Path;
+        std::string Data;
+        AssetArchiveEntry Entry{};
+    };
+
+    static uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    static bool parseCompression(std::string_view name, AssetCompression* compression) {
+        if (name == "none") {
+            *compression = AssetCompression::None;
+            return true;
+        }
+#ifdef VDC_LZ4
+        if (name == "lz4") {
+            *compression = AssetCompression::LZ4;
+            return true;
+        }
+#endif
+#ifdef VDC_ZSTD
+        if (name == "zstd") {
+            *compression = AssetCompression::Zstd;
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    static std::vector<std::string> splitList(std::string_view list) {
+        std::vector<std::string> items;
+        size_t begin = 0;
+        while (begin <= list.length()) {
+            size_t end = std::min(list.find(',', begin), list.length());
+            if (end > begin) {
+                items.emplace_back(list.substr(begin, end - begin));
+            }
+            begin = end + 1;
+        }
+        return items;
+    }
+
+    static std::string compress([[maybe_unused]] const std::string& data, AssetCompression compression) {
+        std::string compressed;
+        switch (compression) {
+#ifdef VDC_LZ4
+            case AssetCompression::LZ4: {
+                compressed.resize(LZ4_compressBound((int) data.size()));
+                int compressedSize = LZ4_compress_HC(data.data(), compressed.data(), (int) data.size(), (int) compressed.size(), LZ4HC_CLEVEL_MAX);
+                compressed.resize(compressedSize > 0 ? compressedSize : 0);
+                break;
+            }
+#endif
+#ifdef VDC_ZSTD
+            case AssetCompression::Zstd: {
+                compressed.resize(ZSTD_compressBound(data.size()));
+                size_t compressedSize = ZSTD_compress(compressed.data(), compressed.size(), data.data(), data.size(), ZSTD_maxCLevel());
+                compressed.resize(ZSTD_isError(compressedSize) ? 0 : compressedSize);
+                break;
+            }
+#endif
+            default:
+                break;
+        }
+        return compressed;
+    }
+
+    CLI::Command createPackAssetsCommand(const FileSystem& fileSystem) {
+        CLI::Option directoryOption;
+        directoryOption.Name = "dir";
+        directoryOption.Usage = "Directory to pack. Paths in the archive are relative to it (Defaults to bin/<build type>)";
+        directoryOption.Aliases = {"d"};
+
+        CLI::Option outputOption;
+        outputOption.Name = "output";
+        outputOption.Usage = "Archive to write (Defaults to <dir>/assets.vdpk)";
+        outputOption.Aliases = {"o"};
+
+        CLI::Option includeOption;
+        includeOption.Name = "include";
+        includeOption.Usage = "Comma separated directories in <dir> to pack, everything else (e.g. the executable and logs) is left out";
+        includeOption.DefaultValue = "shaders,assets";
+        includeOption.Aliases = {"i"};
+
+        CLI::Option compressionOption;
+        compressionOption.Name = "compression";
+        compressionOption.Usage = "Per-entry compression. Must be none, lz4 or zstd";
+        compressionOption.DefaultValue = "none";
+        compressionOption.Aliases = {"c"};
+
+        CLI::Option releaseOption;
+        releaseOption.Name = "release";
+        releaseOption.Usage = "Use Release mode";
+        releaseOption.Aliases = {"r"};
+
+        CLI::Command command;
+        command.Name = "pack";
+        command.Usage = "Pack assets into a single archive";
+        command.Options = {
+                directoryOption,
+                outputOption,
+                includeOption,
+                compressionOption,
+                releaseOption
+        };
+        command.Action = [&](const CLI::Context& context) -> void {
+            const char* binDirectoryName = "bin";
+            const char* buildTypeDirName = context.hasOption("release") ? "release" : "debug";
+
+            const CLI::Option* directoryOption = context.getOption("dir");
+            std::filesystem::path directory;
+            if (directoryOption != nullptr && directoryOption->Value.length() > 0) {
+                directory = std::string(directoryOption->Value);
+            } else {
+                directory = std::filesystem::path(binDirectoryName) / buildTypeDirName;
+            }
+
+            const CLI::Option* outputOption = context.getOption("output");
+            std::filesystem::path output;
+            if (outputOption != nullptr && outputOption->Value.length() > 0) {
+                output = std::string(outputOption->Value);
+            } else {
+                output = directory / "assets.vdpk";
+            }
+
+            const CLI::Option* includeOption = context.getOption("include");
+            std::string_view includeList;
+            if (includeOption != nullptr) {
+                includeList = includeOption->getValue();
+            } else {
+                includeList = context.Command->getOption("include")->DefaultValue;
+            }
+
+            const CLI::Option* compressionOption = context.getOption("compression");
+            std::string_view compressionName;
+            if (compressionOption != nullptr) {
+                compressionName = compressionOption->getValue();
+            } else {
+                compressionName = context.Command->getOption("compression")->DefaultValue;
+            }
+            AssetCompression compression;
+            if (!parseCompression(compressionName, &compression)) {
+                printf("Could not use compression [%s]\n", std::string(compressionName).c_str());
+                return;
+            }
+
+            std::error_code errorCode;
+            if (!std::filesystem::is_directory(directory, errorCode)) {
+                printf("Could not find directory [%s]\n", directory.string().c_str());
+                return;
+            }
+
+            std::vector<PackedFile> files;
+            for (const std::string& includedDirectoryName : splitList(includeList)) {
+                std::filesystem::path includedDirectory = directory / includedDirectoryName;
+                if (!std::filesystem::is_directory(includedDirectory, errorCode)) {
+                    continue;
+                }
+                for (const auto& directoryEntry : std::filesystem::recursive_directory_iterator(includedDirectory)) {
+                    if (!directoryEntry.is_regular_file() || directoryEntry.path().extension() == ".vdpk") {
+                        continue;
+                    }
+                    PackedFile file;
+                    file.Path = std::filesystem::relative(directoryEntry.path(), directory).generic_string();
+                    file.Data = fileSystem.readFile(directoryEntry.path().string());
+                    files.push_back(std::move(file));
+                }
+            }
+
+            std::string paths;
+            uint64_t totalSize = 0;
+            uint64_t totalStoredSize = 0;
+            for (PackedFile& file : files) {
+                AssetArchiveEntry& entry = file.Entry;
+                entry.PathHash = hashAssetPath(file.Path.data(), file.Path.length());
+                entry.PathOffset = (uint32_t) paths.size();
+                entry.PathLength = (uint32_t) file.Path.length();
+                entry.Size = file.Data.size();
+                entry.Compression = AssetCompression::None;
+                paths += file.Path;
+
+                // Only keep the compressed data if it is worth decompressing instead of mapping the entry directly
+                std::string compressed = compress(file.Data, compression);
+                if (!compressed.empty() && compressed.size() < file.Data.size() * 9 / 10) {
+                    file.Data = std::move(compressed);
+                    entry.Compression = compression;
+                }
+                entry.StoredSize = file.Data.size();
+                totalSize += entry.Size;
+                totalStoredSize += entry.StoredSize;
+            }
+            std::sort(files.begin(), files.end(), [](const PackedFile& a, const PackedFile& b) {
+                return a.Entry.PathHash < b.Entry.PathHash;
+            });
+
+            AssetArchiveHeader header{};
+            memcpy(header.Magic, ASSET_ARCHIVE_MAGIC, sizeof(header.Magic));
+            header.Version = ASSET_ARCHIVE_VERSION;
+            header.EntryCount = (uint32_t) files.size();
+            header.Alignment = ASSET_ARCHIVE_ALIGNMENT;
+            header.EntriesOffset = sizeof(AssetArchiveHeader);
+            header.PathsOffset = header.EntriesOffset + files.size() * sizeof(AssetArchiveEntry);
+
+            uint64_t offset = alignUp(header.PathsOffset + paths.size(), ASSET_ARCHIVE_ALIGNMENT);
+            for (PackedFile& file : files) {
+                file.Entry.Offset = offset;
+                offset = alignUp(offset + file.Entry.StoredSize, ASSET_ARCHIVE_ALIGNMENT);
+            }
+
+            std::ofstream outputStream(output, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!outputStream) {
+                printf("Could not open file [%s]\n", output.string().c_str());
+                return;
+            }
+            outputStream.write((const char*) &header, sizeof(header));
+            for (const PackedFile& file : files) {
+                outputStream.write((const char*) &file.Entry, sizeof(file.Entry));
+            }
+            outputStream.write(paths.data(), (std::streamsize) paths.size());
+            for (const PackedFile& file : files) {
+                std::streamoff position = outputStream.tellp();
+                std::string padding(file.Entry.Offset - position, '\0');
+                outputStream.write(padding.data(), (std::streamsize) padding.size());
+                outputStream.write(file.Data.data(), (std::streamsize) file.Data.size());
+            }
+            outputStream.close();
+
+            printf("Packed [%zu] files ([%llu] bytes stored as [%llu] bytes) into [%s]\n", files.size(), (unsigned long long) totalSize, (unsigned long long) totalStoredSize, output.string().c_str());
+        };
+        return command;
+    }
+}
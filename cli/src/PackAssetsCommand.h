@@ -0,0 +1,9 @@
+#pragma once
+
+#include "FileSystem.h"
+#include <cli.h>
+
+namespace VulkandemoCLI
+{
+    CLI::Command createPackAssetsCommand(const FileSystem& fileSystem);
+}
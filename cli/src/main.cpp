@@ -3,6 +3,7 @@
 #include "FileSystem.h"
 #include "InstallDependenciesCommand.h"
 #include "InstallGLFWCommand.h"
+#include "PackAssetsCommand.h"
 #include "RunProjectCommand.h"
 #include <cli.h>
 
@@ -23,6 +24,7 @@ int main(int argc, char* argv[]) {
             VulkandemoCLI::createCompileShadersCommand(),
             VulkandemoCLI::createInstallDependenciesCommand(fileSystem),
             VulkandemoCLI::createInstallGLFWCommand(),
+            VulkandemoCLI::createPackAssetsCommand(fileSystem),
             VulkandemoCLI::createRunProjectCommand()
     };
 
@@ -1,19 +1,65 @@
-function(compile_shader SHADER)
-    set(SHADER_ASSET_PATH ${SHADER_ASSETS_DIR}/${SHADER})
-    set(SHADER_OUTPUT_PATH ${SHADER_OUTPUT_DIR}/${SHADER}.spv)
-    find_program(GLSLC glslc)
-    get_filename_component(SHADER_OUTPUT_DIRECTORY ${SHADER_OUTPUT_PATH} DIRECTORY)
-    file(MAKE_DIRECTORY ${SHADER_OUTPUT_DIRECTORY})
-    exec_program(${GLSLC} ARGS -o ${SHADER_OUTPUT_PATH} ${SHADER_ASSET_PATH})
-endfunction()
+# Compiles every GLSL shader under SOURCE_DIR to SPIR-V in OUTPUT_DIR as part of the build.
+#
+# Each shader is its own build output, so the build tool only recompiles shaders that are out of date and runs
+# the compilations in parallel. glslc writes a depfile per shader, so editing a file that is pulled in with
+# #include also recompiles the shaders that include it.
+#
+# Usage:
+#   add_shaders(<target> SOURCE_DIR <dir> OUTPUT_DIR <dir> [OUTPUTS <variable>])
+#
+# OUTPUTS receives the list of generated .spv files, e.g. to embed them with embed_shaders().
+
+function(add_shaders TARGET_NAME)
+    cmake_parse_arguments(SHADERS "" "SOURCE_DIR;OUTPUT_DIR;OUTPUTS" "" ${ARGN})
+
+    find_program(GLSLC glslc HINTS $ENV{VULKAN_SDK}/bin $ENV{VULKAN_SDK}/Bin REQUIRED)
+
+    file(GLOB_RECURSE SHADER_SOURCES CONFIGURE_DEPENDS
+            ${SHADERS_SOURCE_DIR}/*.vert
+            ${SHADERS_SOURCE_DIR}/*.frag
+            ${SHADERS_SOURCE_DIR}/*.comp
+    )
 
-function(compile_shaders WILDCARD)
-    file(GLOB files "${SHADER_ASSETS_DIR}/${WILDCARD}")
-    foreach (file ${files})
-        get_filename_component(FILENAME ${file} NAME)
-        compile_shader(${FILENAME})
+    # Generators without depfile support fall back to recompiling every shader when any include file changes
+    set(SHADER_INCLUDES "")
+    if (NOT CMAKE_GENERATOR MATCHES "Ninja|Makefiles")
+        file(GLOB_RECURSE SHADER_INCLUDES CONFIGURE_DEPENDS ${SHADERS_SOURCE_DIR}/*.glsl)
+    endif ()
+
+    set(SHADER_OUTPUTS "")
+    foreach (SHADER_SOURCE ${SHADER_SOURCES})
+        file(RELATIVE_PATH SHADER ${SHADERS_SOURCE_DIR} ${SHADER_SOURCE})
+        set(SHADER_OUTPUT ${SHADERS_OUTPUT_DIR}/${SHADER}.spv)
+        set(SHADER_DEPFILE ${CMAKE_CURRENT_BINARY_DIR}/shaders/${SHADER}.d)
+        get_filename_component(SHADER_OUTPUT_DIRECTORY ${SHADER_OUTPUT} DIRECTORY)
+        get_filename_component(SHADER_DEPFILE_DIRECTORY ${SHADER_DEPFILE} DIRECTORY)
+
+        if (CMAKE_GENERATOR MATCHES "Ninja|Makefiles")
+            add_custom_command(
+                    OUTPUT ${SHADER_OUTPUT}
+                    COMMAND ${CMAKE_COMMAND} -E make_directory ${SHADER_OUTPUT_DIRECTORY} ${SHADER_DEPFILE_DIRECTORY}
+                    COMMAND ${GLSLC} -MD -MF ${SHADER_DEPFILE} -o ${SHADER_OUTPUT} ${SHADER_SOURCE}
+                    MAIN_DEPENDENCY ${SHADER_SOURCE}
+                    DEPFILE ${SHADER_DEPFILE}
+                    COMMENT "Compiling shader ${SHADER}"
+                    VERBATIM
+            )
+        else ()
+            add_custom_command(
+                    OUTPUT ${SHADER_OUTPUT}
+                    COMMAND ${CMAKE_COMMAND} -E make_directory ${SHADER_OUTPUT_DIRECTORY}
+                    COMMAND ${GLSLC} -o ${SHADER_OUTPUT} ${SHADER_SOURCE}
+                    MAIN_DEPENDENCY ${SHADER_SOURCE}
+                    DEPENDS ${SHADER_INCLUDES}
+                    COMMENT "Compiling shader ${SHADER}"
+                    VERBATIM
+            )
+        endif ()
+        list(APPEND SHADER_OUTPUTS ${SHADER_OUTPUT})
     endforeach ()
-endfunction()
 
-compile_shaders(*.vert)
-compile_shaders(*.frag)
\ No newline at end of file
+    add_custom_target(${TARGET_NAME} ALL DEPENDS ${SHADER_OUTPUTS})
+    if (SHADERS_OUTPUTS)
+        set(${SHADERS_OUTPUTS} ${SHADER_OUTPUTS} PARENT_SCOPE)
+    endif ()
+endfunction()
@@ -0,0 +1,77 @@
+# Embeds compiled SPIR-V shaders in a generated source file that registers them with the ShaderRegistry, so the
+# app can create its shader modules without any file I/O.
+#
+# Usage (configure time):
+#   include(embed_shaders.cmake)
+#   embed_shaders(<target> SHADERS_DIR <dir> SHADERS <spv files...> OUTPUT <generated .cpp>)
+#
+# The shaders are registered by their path relative to the parent of SHADERS_DIR (e.g. "shaders/simple_shader.vert.spv"),
+# which is the same path the app uses when loading them from disk.
+
+if (NOT CMAKE_SCRIPT_MODE_FILE)
+    set(EMBED_SHADERS_SCRIPT ${CMAKE_CURRENT_LIST_FILE})
+
+    function(embed_shaders TARGET_NAME)
+        cmake_parse_arguments(EMBED "" "SHADERS_DIR;OUTPUT" "SHADERS" ${ARGN})
+        get_filename_component(EMBED_ROOT_DIR ${EMBED_SHADERS_DIR} DIRECTORY)
+        string(REPLACE ";" "|" EMBED_SHADER_LIST "${EMBED_SHADERS}")
+        add_custom_command(
+                OUTPUT ${EMBED_OUTPUT}
+                COMMAND ${CMAKE_COMMAND} "-DSHADERS=${EMBED_SHADER_LIST}" -DROOT_DIR=${EMBED_ROOT_DIR} -DOUTPUT=${EMBED_OUTPUT} -P ${EMBED_SHADERS_SCRIPT}
+                DEPENDS ${EMBED_SHADERS} ${EMBED_SHADERS_SCRIPT}
+                COMMENT "Embedding SPIR-V shaders"
+                VERBATIM
+        )
+        target_sources(${TARGET_NAME} PRIVATE ${EMBED_OUTPUT})
+        target_compile_definitions(${TARGET_NAME} PRIVATE VD_EMBED_SHADERS)
+    endfunction()
+
+    return()
+endif ()
+
+# Script mode: cmake -DSHADERS=<a.spv|b.spv> -DROOT_DIR=<dir> -DOUTPUT=<file> -P embed_shaders.cmake
+
+string(REPLACE "|" ";" SHADERS "${SHADERS}")
+
+set(ARRAYS "")
+set(ENTRIES "")
+set(SHADER_INDEX 0)
+foreach (SHADER ${SHADERS})
+    file(RELATIVE_PATH SHADER_NAME ${ROOT_DIR} ${SHADER})
+    file(SIZE ${SHADER} SHADER_SIZE)
+    math(EXPR SHADER_SIZE_REMAINDER "${SHADER_SIZE} % 4")
+    if (SHADER_SIZE EQUAL 0 OR NOT SHADER_SIZE_REMAINDER EQUAL 0)
+        message(FATAL_ERROR "${SHADER} is not a valid SPIR-V binary (size ${SHADER_SIZE} is not a non-zero multiple of 4)")
+    endif ()
+
+    # SPIR-V is a stream of little endian 32-bit words, so swap every group of 4 bytes into a word literal
+    file(READ ${SHADER} SHADER_HEX HEX)
+    string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1, " SHADER_WORDS ${SHADER_HEX})
+    # CMake regular expressions have no {n} quantifier, so eight words per line are matched explicitly
+    set(EIGHT_WORDS "0x........, 0x........, 0x........, 0x........, 0x........, 0x........, 0x........, 0x........, ")
+    string(REGEX REPLACE "(${EIGHT_WORDS})" "\\1\n            " SHADER_WORDS ${SHADER_WORDS})
+    string(REPLACE ", \n" ",\n" SHADER_WORDS "${SHADER_WORDS}")
+    string(STRIP "${SHADER_WORDS}" SHADER_WORDS)
+
+    set(ARRAY_NAME "SHADER_${SHADER_INDEX}")
+    string(APPEND ARRAYS "    // ${SHADER_NAME}\n")
+    string(APPEND ARRAYS "    alignas(4) constexpr uint32_t ${ARRAY_NAME}[] = {\n            ${SHADER_WORDS}\n    };\n\n")
+    string(APPEND ENTRIES "            {\"${SHADER_NAME}\", ${ARRAY_NAME}, sizeof(${ARRAY_NAME})},\n")
+    math(EXPR SHADER_INDEX "${SHADER_INDEX} + 1")
+endforeach ()
+
+if (SHADER_INDEX EQUAL 0)
+    message(FATAL_ERROR "No shaders to embed")
+endif ()
+
+set(CONTENT "// Generated by cmake/embed_shaders.cmake, do not edit\n\n")
+string(APPEND CONTENT "#include \"ShaderRegistry.h\"\n\n")
+string(APPEND CONTENT "#include <cstdint>\n\n")
+string(APPEND CONTENT "namespace Vulkandemo {\n\n")
+string(APPEND CONTENT "${ARRAYS}")
+string(APPEND CONTENT "    extern const EmbeddedShader EMBEDDED_SHADERS[] = {\n${ENTRIES}    };\n\n")
+string(APPEND CONTENT "    extern const uint32_t EMBEDDED_SHADER_COUNT = ${SHADER_INDEX};\n\n")
+string(APPEND CONTENT "}\n")
+
+# Only touch the output when it changed so dependent objects are not rebuilt needlessly
+file(CONFIGURE OUTPUT ${OUTPUT} CONTENT "${CONTENT}" @ONLY)
@@ -1,9 +1,4 @@
 # Run after all other rules within the target have been executed (PRE_BUILD & PRE_LINK).
-
-set(CMAKE_SCRIPTS_DIR ${CMAKE_CURRENT_LIST_DIR})
-string(TOLOWER ${CMAKE_BUILD_TYPE} BUILD_TYPE_DIR_NAME)
-
-set(SHADER_ASSETS_DIR ${ASSETS_DIR}/shaders)
-set(SHADER_OUTPUT_DIR ${BIN_DIR}/${BUILD_TYPE_DIR_NAME}/shaders)
-
-include(${CMAKE_SCRIPTS_DIR}/compile_shaders.cmake)
\ No newline at end of file
+#
+# Shaders are no longer compiled here. They are build outputs of the 'shaders' target (see compile_shaders.cmake),
+# which the executable depends on.
@@ -79,4 +79,4 @@ echo "
 #   Building project...   #
 ###########################
 "
-cmake --build "${buildDirectory}" --config "${buildType}"
\ No newline at end of file
+cmake --build "${buildDirectory}" --config "${buildType}" --parallel
\ No newline at end of file
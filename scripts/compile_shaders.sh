@@ -3,6 +3,19 @@
 # Exit when any command fails
 set -e
 
+while getopts ":b:d:" flag; do
+  case "${flag}" in
+    b)
+      buildType="$OPTARG"
+      ;;
+    d)
+      buildDirectory="$OPTARG"
+      ;;
+    \?) echo "Invalid option -$OPTARG" >&2
+    exit 1;;
+  esac
+done
+
 echo "
 #####################
 #   Setting up...   #
@@ -14,12 +27,20 @@ fi
 workingDirectory="$(pwd)"
 echo "-- Working from directory [${workingDirectory}]"
 
-cmakeScript="${workingDirectory}/cmake/compile_shaders.cmake"
-echo "-- Using CMake script [${cmakeScript}]"
+if [[ -z ${buildType} ]]; then
+  buildType="Debug"
+fi
+echo "-- Using build type [${buildType}]"
+
+if [[ -z ${buildDirectory} ]]; then
+  buildDirectory="${workingDirectory}/build"
+fi
+echo "-- Using CMake build directory [${buildDirectory}]"
 
 echo "
 ############################
 #   Compiling shaders...   #
 ############################
 "
-cmake -P "${cmakeScript}"
\ No newline at end of file
+# Shaders are build outputs of the 'shaders' target, so only out of date shaders are recompiled (in parallel)
+cmake --build "${buildDirectory}" --config "${buildType}" --target shaders --parallel
@@ -15,6 +15,8 @@ while getopts ":b:e:" flag; do
     exit 1;;
   esac
 done
+# Remaining arguments are passed to the executable, e.g. -- --benchmark
+shift $((OPTIND - 1))
 
 resolveBuildType() {
   if [[ -z ${buildType} ]]; then
@@ -51,4 +53,4 @@ echo "
 ##########################
 "
 cd "${executableDirectory}"
-./vulkandemo
\ No newline at end of file
+./vulkandemo "$@"
\ No newline at end of file
@@ -1,15 +1,43 @@
 #include "App.h"
 #include "Log.h"
+#include "ShaderRegistry.h"
 
 #include <vulkan/vulkan.h>
 
+#include <algorithm>
+
 namespace Vulkandemo {
 
     const int MAX_FRAMES_IN_FLIGHT = 2;
+    const char* ASSET_ARCHIVE_PATH = "assets.vdpk";
+    const char* VERTEX_SHADER_PATH = "shaders/simple_shader.vert.spv";
+    const char* FRAGMENT_SHADER_PATH = "shaders/simple_shader.frag.spv";
+    const char* CULLING_SHADER_PATH = "shaders/cull.comp.spv";
+    // Specialization constant selecting the color mode variant of the fragment shader, cycled with the C key
+    const uint32_t COLOR_MODE_CONSTANT_ID = 0;
+    const uint32_t COLOR_MODE_COUNT = 2;
+    // Cycled with the I key
+    const int SUBMISSION_MODE_COUNT = 5;
+    // How long the main thread sleeps at most between checks whether the window should close
+    const double EVENT_WAIT_TIMEOUT_SECONDS = 0.01;
+    const std::chrono::milliseconds MINIMIZED_POLL_INTERVAL(10);
+    const double FRAME_STATISTICS_INTERVAL_SECONDS = 5.0;
+
+    // Matches the push constant block of the vertex shader
+    struct DrawConstants {
+        glm::mat4 ViewProjection;
+        uint32_t VertexBufferIndex;
+        uint32_t InstanceBufferIndex;
+        uint32_t TransformBufferIndex;
+    };
 
     App::App(Config config)
             : config(std::move(config)),
+              jobSystem(new JobSystem(this->config.JobSystem)),
               fileSystem(new FileSystem),
+              assetArchive(new AssetArchive(fileSystem)),
+              assetLoader(new AssetLoader(config.AssetLoader, fileSystem)),
+              shaderWatcher(new ShaderWatcher(this->config.ShaderWatcher, fileSystem)),
               window(new Window(config.Window)),
               vulkan(new Vulkan(config.Vulkan, window)),
               vulkanPhysicalDevice(new VulkanPhysicalDevice(vulkan)),
@@ -17,15 +45,42 @@ namespace Vulkandemo {
               vulkanSwapChain(new VulkanSwapChain(vulkanDevice, vulkanPhysicalDevice, vulkan, window)),
               vertexShader(new VulkanShader(vulkanDevice)),
               fragmentShader(new VulkanShader(vulkanDevice)),
+              cullingShader(new VulkanShader(vulkanDevice)),
               vulkanRenderPass(new VulkanRenderPass(vulkanSwapChain, vulkanDevice)),
-              vulkanGraphicsPipeline(new VulkanGraphicsPipeline(vulkanRenderPass, vulkanSwapChain, vulkanDevice)),
+              vulkanRenderGraph(new VulkanRenderGraph(vulkanPhysicalDevice, vulkanDevice)),
+              vulkanLayoutCache(new VulkanLayoutCache(vulkanDevice)),
+              vulkanGraphicsPipelineCache(new VulkanGraphicsPipelineCache(vulkanDevice, vulkanLayoutCache, jobSystem)),
+              vulkanDescriptorAllocator(new VulkanDescriptorAllocator({MAX_FRAMES_IN_FLIGHT}, vulkanDevice)),
+              vulkanBindlessDescriptors(new VulkanBindlessDescriptors(this->config.BindlessDescriptors, vulkanPhysicalDevice, vulkanDevice)),
+              instancedScene(new InstancedScene(this->config.Scene, jobSystem)),
+              vulkanResources(new VulkanResources(vulkanPhysicalDevice, vulkanDevice)),
+              // One world matrix per instance plus the scene root
+              transformBuffer(new VulkanPerFrameBuffer({MAX_FRAMES_IN_FLIGHT, (this->config.Scene.InstanceCount + 1) * sizeof(glm::mat4)}, vulkanPhysicalDevice, vulkanDevice, vulkanBindlessDescriptors)),
+              indirectDrawBuffer(new VulkanIndirectDrawBuffer({MAX_FRAMES_IN_FLIGHT, this->config.Scene.InstanceCount}, vulkanPhysicalDevice, vulkanDevice, vulkanBindlessDescriptors)),
+              vulkanCullingPass(new VulkanCullingPass({MAX_FRAMES_IN_FLIGHT}, vulkanPhysicalDevice, vulkanDevice, vulkanLayoutCache, vulkanBindlessDescriptors)),
+              frustumCuller(new FrustumCuller(this->config.FrustumCuller, jobSystem)),
+              submissionBenchmark(new SubmissionBenchmark(this->config.Benchmark)),
               vulkanCommandPool(new VulkanCommandPool(vulkanPhysicalDevice, vulkanDevice)) {
     }
 
     App::~App() {
+        // Joins the watcher thread first since it builds pipelines from the Vulkan objects below
+        delete shaderWatcher;
         delete vulkanCommandPool;
-        delete vulkanGraphicsPipeline;
+        delete submissionBenchmark;
+        delete frustumCuller;
+        delete vulkanCullingPass;
+        delete indirectDrawBuffer;
+        delete transformBuffer;
+        delete vulkanResources;
+        delete instancedScene;
+        delete vulkanBindlessDescriptors;
+        delete vulkanDescriptorAllocator;
+        delete vulkanGraphicsPipelineCache;
+        delete vulkanLayoutCache;
+        delete vulkanRenderGraph;
         delete vulkanRenderPass;
+        delete cullingShader;
         delete fragmentShader;
         delete vertexShader;
         delete vulkanSwapChain;
@@ -33,27 +88,200 @@ namespace Vulkandemo {
         delete vulkanPhysicalDevice;
         delete vulkan;
         delete window;
+        delete assetLoader;
+        delete assetArchive;
         delete fileSystem;
+        delete jobSystem;
     }
 
     void App::run() {
+        if (config.CullingBenchmark.Enabled) {
+            Log::initialize(config.Name, config.LogLevel);
+            jobSystem->initialize();
+            jobSystem->registerThread();
+            CullingBenchmark(config.CullingBenchmark, jobSystem).run();
+            jobSystem->unregisterThread();
+            jobSystem->terminate();
+            return;
+        }
         if (!initialize()) {
             VD_LOG_CRITICAL("Could not initialize app");
             return;
         }
         VD_LOG_INFO("Running...");
+
+        // The main thread only handles window events, since GLFW requires that, while the simulation steps on one thread and frames are
+        // recorded and submitted on another
+        running = true;
+        simulationThread = std::thread(&App::runSimulation, this);
+        renderThread = std::thread(&App::runRendering, this);
         while (!window->shouldClose()) {
-            window->pollEvents();
-            drawFrame();
+            window->waitEvents(EVENT_WAIT_TIMEOUT_SECONDS);
+            assetLoader->dispatchCompleted();
+        }
+        {
+            std::lock_guard<std::mutex> lock(snapshotMutex);
+            running = false;
         }
+        snapshotCondition.notify_all();
+        simulationThread.join();
+        renderThread.join();
+
         vulkanDevice->waitUntilIdle();
         terminate();
     }
 
+    void App::runSimulation() {
+        jobSystem->registerThread();
+        SimulationClock simulationClock(config.Simulation);
+        std::chrono::steady_clock::time_point lastAdvanceTime = std::chrono::steady_clock::now();
+        double simulationSeconds = 0.0;
+        while (running) {
+            int key;
+            while (keyPresses.pop(key)) {
+                onKeyPress(key);
+            }
+
+            std::chrono::steady_clock::time_point advanceTime = std::chrono::steady_clock::now();
+            uint32_t stepCount = simulationClock.advance(std::chrono::duration<double>(advanceTime - lastAdvanceTime).count());
+            lastAdvanceTime = advanceTime;
+            if (stepCount > 0) {
+                FrameSnapshot& snapshot = frameSnapshots.getBack();
+                for (uint32_t i = 0; i < stepCount; i++) {
+                    // Only the state before the last step is kept to interpolate from
+                    if (i == stepCount - 1) {
+                        instancedScene->writeTransformSnapshot(snapshot.PreviousTransforms);
+                        snapshot.PreviousViewProjection = instancedScene->getViewProjection((float) simulationClock.getTime());
+                    }
+                    instancedScene->update((float) simulationClock.step());
+                }
+                instancedScene->writeTransformSnapshot(snapshot.Transforms);
+                snapshot.ViewProjection = instancedScene->getViewProjection((float) simulationClock.getTime());
+                snapshot.StepCount = simulationClock.getStepCount();
+                snapshot.DroppedStepCount = simulationClock.getDroppedStepCount();
+                snapshot.StepSeconds = simulationClock.getStepSeconds();
+                snapshot.DueTime = std::chrono::duration<double>(advanceTime - initializeStartTime).count() - simulationClock.getAccumulatedSeconds();
+                simulationSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - advanceTime).count();
+                snapshot.SimulationSeconds = simulationSeconds;
+                snapshot.ColorMode = colorMode;
+                snapshot.Submission = submissionMode;
+                frameSnapshots.publish();
+            }
+
+            // Sleeps until the next step is due instead of simulating ahead, so the simulation costs the same at any frame rate
+            std::unique_lock<std::mutex> lock(snapshotMutex);
+            if (stepCount > 0) {
+                snapshotPending = true;
+                snapshotCondition.notify_all();
+            }
+            snapshotCondition.wait_for(lock, std::chrono::duration<double>(simulationClock.getSecondsUntilNextStep()), [this]() {
+                return !running;
+            });
+        }
+        jobSystem->unregisterThread();
+    }
+
+    void App::runRendering() {
+        jobSystem->registerThread();
+        bool snapshotAcquired = false;
+        frameStatistics = {std::chrono::steady_clock::now()};
+        while (running) {
+            std::unique_lock<std::mutex> lock(snapshotMutex);
+            // Only the first frame waits for the simulation, later frames keep interpolating towards the latest snapshot if the next one is not
+            // ready yet
+            if (!snapshotAcquired) {
+                snapshotCondition.wait(lock, [this]() {
+                    return snapshotPending || !running;
+                });
+            }
+            if (!running) {
+                break;
+            }
+            if (snapshotPending) {
+                frameSnapshots.acquire();
+                snapshotAcquired = true;
+                snapshotPending = false;
+            }
+            lock.unlock();
+
+            // Rendering runs one step behind the simulation, between the previous and the current state of the snapshot
+            const FrameSnapshot& snapshot = frameSnapshots.getFront();
+            std::chrono::steady_clock::time_point renderStartTime = std::chrono::steady_clock::now();
+            double renderTime = std::chrono::duration<double>(renderStartTime - initializeStartTime).count();
+            auto alpha = (float) std::clamp((renderTime - snapshot.DueTime) / snapshot.StepSeconds, 0.0, 1.0);
+            drawFrame(snapshot, alpha);
+            updateFrameStatistics(snapshot, std::chrono::duration<double>(std::chrono::steady_clock::now() - renderStartTime).count());
+        }
+        jobSystem->unregisterThread();
+    }
+
+    void App::updateFrameStatistics(const FrameSnapshot& snapshot, double renderSeconds) {
+        frameStatistics.FrameCount++;
+        frameStatistics.RenderSeconds += renderSeconds;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - frameStatistics.StartTime).count();
+        if (seconds < FRAME_STATISTICS_INTERVAL_SECONDS) {
+            return;
+        }
+        uint64_t stepCount = snapshot.StepCount - frameStatistics.StepCount;
+        double simulationSeconds = snapshot.SimulationSeconds - frameStatistics.SimulationSeconds;
+        VD_LOG_INFO(
+                "Simulated [{:.2f}] steps per frame ([{}] dropped) at [{:.3f}] ms per step, rendered [{:.1f}] frames per second at [{:.3f}] ms per frame, simulation busy [{:.1f}]% and rendering busy [{:.1f}]% of the time",
+                (double) stepCount / (double) frameStatistics.FrameCount,
+                snapshot.DroppedStepCount - frameStatistics.DroppedStepCount,
+                stepCount > 0 ? simulationSeconds * 1000.0 / (double) stepCount : 0.0,
+                (double) frameStatistics.FrameCount / seconds,
+                frameStatistics.RenderSeconds * 1000.0 / (double) frameStatistics.FrameCount,
+                simulationSeconds * 100.0 / seconds,
+                frameStatistics.RenderSeconds * 100.0 / seconds
+        );
+        frameStatistics = {std::chrono::steady_clock::now(), 0, snapshot.StepCount, snapshot.DroppedStepCount, snapshot.SimulationSeconds, 0.0};
+    }
+
+    void App::onKeyPress(int key) {
+        if (key == GLFW_KEY_C) {
+            colorMode = (colorMode + 1) % COLOR_MODE_COUNT;
+            VD_LOG_INFO("Switched to color mode [{}]", colorMode.load());
+        }
+        if (key == GLFW_KEY_I && !submissionBenchmark->isEnabled()) {
+            submissionMode = (SubmissionMode) (((int) submissionMode + 1) % SUBMISSION_MODE_COUNT);
+            VD_LOG_INFO("Switched to [{}] submission", SubmissionBenchmark::getModeAsString(submissionMode));
+        }
+    }
+
     bool App::initialize() {
+        initializeStartTime = std::chrono::steady_clock::now();
         Log::initialize(config.Name, config.LogLevel);
         VD_LOG_INFO("Initializing...");
 
+        if (!jobSystem->initialize()) {
+            VD_LOG_ERROR("Could not initialize job system");
+            return false;
+        }
+        if (fileSystem->exists(ASSET_ARCHIVE_PATH)) {
+            if (!assetArchive->initialize(ASSET_ARCHIVE_PATH)) {
+                VD_LOG_ERROR("Could not initialize asset archive");
+                return false;
+            }
+            assetLoader->mount(assetArchive);
+        }
+        if (!assetLoader->initialize()) {
+            VD_LOG_ERROR("Could not initialize asset loader");
+            return false;
+        }
+        // Start reading shaders that are not embedded in the executable in the background while the window and Vulkan objects are being created
+        AssetLoader::Handle vertexShaderAsset;
+        if (ShaderRegistry::find(VERTEX_SHADER_PATH) == nullptr) {
+            vertexShaderAsset = assetLoader->load(VERTEX_SHADER_PATH, AssetLoader::Priority::Critical);
+        }
+        AssetLoader::Handle fragmentShaderAsset;
+        if (ShaderRegistry::find(FRAGMENT_SHADER_PATH) == nullptr) {
+            fragmentShaderAsset = assetLoader->load(FRAGMENT_SHADER_PATH, AssetLoader::Priority::Critical);
+        }
+        AssetLoader::Handle cullingShaderAsset;
+        if (ShaderRegistry::find(CULLING_SHADER_PATH) == nullptr) {
+            cullingShaderAsset = assetLoader->load(CULLING_SHADER_PATH, AssetLoader::Priority::Critical);
+        }
+
         if (!window->initialize()) {
             VD_LOG_ERROR("Could not initialize window");
             return false;
@@ -64,6 +292,11 @@ namespace Vulkandemo {
         window->setOnMinimize([this](bool minimized) {
             this->windowResized = true;
         });
+        window->setOnKeyPress([this](int key) {
+            if (!this->keyPresses.push(key)) {
+                VD_LOG_WARN("Could not queue key press [{}], the simulation is not keeping up", key);
+            }
+        });
 
         if (!vulkan->initialize()) {
             VD_LOG_ERROR("Could not initialize Vulkan");
@@ -77,6 +310,36 @@ namespace Vulkandemo {
             VD_LOG_ERROR("Could not initialize Vulkan device");
             return false;
         }
+        if (!vulkanGraphicsPipelineCache->initialize()) {
+            VD_LOG_ERROR("Could not initialize Vulkan graphics pipeline cache");
+            return false;
+        }
+        if (!vulkanDescriptorAllocator->initialize()) {
+            VD_LOG_ERROR("Could not initialize Vulkan descriptor allocator");
+            return false;
+        }
+        if (!vulkanBindlessDescriptors->initialize()) {
+            VD_LOG_ERROR("Could not initialize bindless Vulkan descriptors");
+            return false;
+        }
+        if (!instancedScene->initialize()) {
+            VD_LOG_ERROR("Could not initialize instanced scene");
+            return false;
+        }
+        if (!initializeSceneGeometry()) {
+            VD_LOG_ERROR("Could not initialize scene geometry");
+            return false;
+        }
+        visibleInstanceIndices.resize(instancedScene->getInstanceCount());
+        if (!transformBuffer->initialize()) {
+            VD_LOG_ERROR("Could not initialize transform buffer");
+            return false;
+        }
+        uploadedTransformVersions.assign(MAX_FRAMES_IN_FLIGHT, 0);
+        if (!indirectDrawBuffer->initialize()) {
+            VD_LOG_ERROR("Could not initialize indirect draw buffer");
+            return false;
+        }
         if (!vulkanCommandPool->initialize()) {
             VD_LOG_ERROR("Could not initialize Vulkan command pool");
             return false;
@@ -86,14 +349,22 @@ namespace Vulkandemo {
             VD_LOG_ERROR("Could not initialize Vulkan command buffers");
             return false;
         }
-        if (!vertexShader->initialize(fileSystem->readBytes("shaders/simple_shader.vert.spv"))) {
+        if (!initializeShader(vertexShader, VERTEX_SHADER_PATH, vertexShaderAsset)) {
             VD_LOG_ERROR("Could not initialize vertex shader");
             return false;
         }
-        if (!fragmentShader->initialize(fileSystem->readBytes("shaders/simple_shader.frag.spv"))) {
+        if (!initializeShader(fragmentShader, FRAGMENT_SHADER_PATH, fragmentShaderAsset)) {
             VD_LOG_ERROR("Could not initialize fragment shader");
             return false;
         }
+        if (!initializeShader(cullingShader, CULLING_SHADER_PATH, cullingShaderAsset)) {
+            VD_LOG_ERROR("Could not initialize culling shader");
+            return false;
+        }
+        if (!vulkanCullingPass->initialize(cullingShader, instancedScene->getCullingObjects(), *indirectDrawBuffer)) {
+            VD_LOG_ERROR("Could not initialize Vulkan culling pass");
+            return false;
+        }
         if (!initializeRenderingObjects()) {
             VD_LOG_ERROR("Could not initialize Vulkan swap chain");
             return false;
@@ -102,9 +373,31 @@ namespace Vulkandemo {
             VD_LOG_ERROR("Could not create Vulkan sync objects (semaphores & fences)");
             return false;
         }
+        if (config.ShaderWatcher.Enabled) {
+            shaderWatcher->setOnCompiled([this](const std::string& path, const std::vector<uint32_t>& code) {
+                this->onShaderCompiled(path, code);
+            });
+            if (!shaderWatcher->initialize()) {
+                VD_LOG_WARN("Could not initialize shader watcher, shader hot reload is disabled");
+            }
+        }
         return true;
     }
 
+    bool App::initializeShader(VulkanShader* shader, const char* path, const AssetLoader::Handle& asset) const {
+        const EmbeddedShader* embeddedShader = ShaderRegistry::find(path);
+        if (embeddedShader != nullptr) {
+            VD_LOG_DEBUG("Using embedded shader [{}]", path);
+            return shader->initialize(embeddedShader->Code, embeddedShader->Size);
+        }
+        if (asset->wait() != AssetLoader::Request::State::Loaded) {
+            VD_LOG_ERROR("Could not load shader [{}]", path);
+            return false;
+        }
+        const Asset& shaderCode = asset->getAsset();
+        return shader->initialize(shaderCode.getDataAs<uint32_t>(), shaderCode.getSize());
+    }
+
     bool App::initializeRenderingObjects() {
         if (!vulkanSwapChain->initialize()) {
             VD_LOG_ERROR("Could not initialize Vulkan swap chain");
@@ -114,22 +407,20 @@ namespace Vulkandemo {
             VD_LOG_ERROR("Could not initialize Vulkan render pass");
             return false;
         }
-        if (!vulkanGraphicsPipeline->initialize(*vertexShader, *fragmentShader)) {
-            VD_LOG_ERROR("Could not initialize Vulkan graphics pipeline");
-            return false;
-        }
         if (!initializeFramebuffers()) {
             VD_LOG_ERROR("Could not initialize Vulkan framebuffers");
             return false;
         }
+        // Pipelines are compiled on the pipeline cache workers while placeholder frames are presented, see drawFrame
+        vulkanGraphicsPipelineCache->precompile(getPipelineDescriptions());
         return true;
     }
 
     bool App::initializeFramebuffers() {
         const std::vector<VkImageView>& swapChainImageViews = vulkanSwapChain->getImageViews();
         for (auto swapChainImageView : swapChainImageViews) {
-            VulkanFramebuffer framebuffer(vulkanDevice, vulkanSwapChain, vulkanRenderPass);
-            if (!framebuffer.initialize(swapChainImageView)) {
+            VulkanFramebufferHandle framebuffer = vulkanResources->createFramebuffer(vulkanSwapChain, vulkanRenderPass, swapChainImageView);
+            if (!framebuffer.isValid()) {
                 VD_LOG_ERROR("Could not initialize framebuffers");
                 return false;
             }
@@ -143,6 +434,7 @@ namespace Vulkandemo {
         imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
         renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
         inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+        inFlightSubmissions.assign(MAX_FRAMES_IN_FLIGHT, 0);
 
         VkSemaphoreCreateInfo semaphoreInfo{};
         semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -170,16 +462,73 @@ namespace Vulkandemo {
         return true;
     }
 
+    bool App::initializeSceneGeometry() {
+        // Vertices are read by the vertex shader from a storage buffer, indices through the index buffer binding
+        const std::vector<Vertex>& vertices = instancedScene->getVertices();
+        const std::vector<uint32_t>& indices = instancedScene->getIndices();
+        VkDeviceSize verticesSize = vertices.size() * sizeof(Vertex);
+        VkDeviceSize indicesSize = indices.size() * sizeof(uint32_t);
+        VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        vertexBuffer = vulkanResources->createBuffer(verticesSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, memoryProperties);
+        if (!vertexBuffer.isValid() || !vulkanResources->getBuffer(vertexBuffer)->write(vertices.data(), verticesSize)) {
+            return false;
+        }
+        indexBuffer = vulkanResources->createBuffer(indicesSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, memoryProperties);
+        if (!indexBuffer.isValid() || !vulkanResources->getBuffer(indexBuffer)->write(indices.data(), indicesSize)) {
+            return false;
+        }
+        vertexBufferIndex = vulkanBindlessDescriptors->registerStorageBuffer(vulkanResources->getBuffer(vertexBuffer)->getBuffer());
+        if (vertexBufferIndex == VulkanBindlessDescriptors::INVALID_INDEX) {
+            return false;
+        }
+
+        // Instances only refer to their world matrix, which is uploaded every frame, so they are written once
+        std::vector<InstanceData> instances(instancedScene->getInstanceCount());
+        instancedScene->writeInstances(instances.data());
+        VkDeviceSize instancesSize = instances.size() * sizeof(InstanceData);
+        instanceBuffer = vulkanResources->createBuffer(instancesSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, memoryProperties);
+        if (!instanceBuffer.isValid() || !vulkanResources->getBuffer(instanceBuffer)->write(instances.data(), instancesSize)) {
+            return false;
+        }
+        instanceBufferIndex = vulkanBindlessDescriptors->registerStorageBuffer(vulkanResources->getBuffer(instanceBuffer)->getBuffer());
+        return instanceBufferIndex != VulkanBindlessDescriptors::INVALID_INDEX;
+    }
+
     void App::terminate() {
         VD_LOG_INFO("Terminating...");
+        if (config.ShaderWatcher.Enabled) {
+            shaderWatcher->terminate();
+        }
         terminateSyncObjects();
+        terminateReloadedPipelines();
+        vulkanGraphicsPipelineCache->terminate();
         terminateRenderingObjects();
+        vulkanRenderGraph->terminate();
+        // The device is idle, so what the deletion queue holds can be destroyed before the layouts it was created with
+        vulkanDevice->getDeletionQueue()->flush();
+        vulkanDescriptorAllocator->terminate();
+        vulkanLayoutCache->terminate();
+        vulkanCullingPass->terminate();
+        indirectDrawBuffer->terminate();
+        transformBuffer->terminate();
+        vulkanBindlessDescriptors->releaseStorageBuffer(instanceBufferIndex);
+        vulkanResources->destroyBuffer(instanceBuffer);
+        vulkanResources->destroyBuffer(indexBuffer);
+        vulkanBindlessDescriptors->releaseStorageBuffer(vertexBufferIndex);
+        vulkanResources->destroyBuffer(vertexBuffer);
+        vulkanResources->terminate();
+        instancedScene->terminate();
+        vulkanBindlessDescriptors->terminate();
+        cullingShader->terminate();
         fragmentShader->terminate();
         vertexShader->terminate();
         vulkanCommandPool->terminate();
         vulkanDevice->terminate();
         vulkan->terminate();
         window->terminate();
+        assetLoader->terminate();
+        assetArchive->terminate();
+        jobSystem->terminate();
     }
 
     void App::terminateSyncObjects() const {
@@ -194,28 +543,191 @@ namespace Vulkandemo {
 
     void App::terminateRenderingObjects() {
         terminateFramebuffers();
-        vulkanGraphicsPipeline->terminate();
         vulkanRenderPass->terminate();
         vulkanSwapChain->terminate();
     }
 
+    void App::terminateReloadedPipelines() {
+        std::lock_guard<std::mutex> lock(shaderReloadMutex);
+        terminateReloadedShader(reloadedPipeline.VertexShader);
+        terminateReloadedShader(reloadedPipeline.FragmentShader);
+        reloadedPipeline = {};
+    }
+
+    void App::terminateReloadedShader(VulkanShader* shader) {
+        if (shader == nullptr) {
+            return;
+        }
+        // The cache takes over the shader and destroys it along with its pipelines
+        vulkanGraphicsPipelineCache->evict(shader);
+    }
+
     void App::terminateFramebuffers() {
-        for (VulkanFramebuffer framebuffer : framebuffers) {
-            framebuffer.terminate();
+        for (VulkanFramebufferHandle framebuffer : framebuffers) {
+            vulkanResources->destroyFramebuffer(framebuffer);
         }
         framebuffers.clear();
-        VD_LOG_INFO("Destroyed Vulkan framebuffers");
+        VD_LOG_INFO("Retired Vulkan framebuffers");
     }
 
     bool App::recreateRenderingObjects() {
-        window->waitUntilNotMinimized();
-        vulkanDevice->waitUntilIdle();
+        // Runs on the render thread, the main thread keeps the window state up to date
+        while (window->isMinimized()) {
+            if (!running) {
+                return false;
+            }
+            std::this_thread::sleep_for(MINIMIZED_POLL_INTERVAL);
+        }
+
+        // Pipelines rebuilt on the shader watcher thread use the render pass and swap chain that are recreated here. Frames in flight keep
+        // using the old objects, which the deletion queue destroys once those frames have completed.
+        std::lock_guard<std::mutex> lock(shaderReloadMutex);
+        swapReloadedPipeline();
+        VkFormat colorFormat = vulkanRenderPass->getColorFormat();
         terminateRenderingObjects();
         vulkanPhysicalDevice->updateSwapChainInfo();
-        return initializeRenderingObjects();
+        if (!initializeRenderingObjects()) {
+            return false;
+        }
+        // Pipelines stay compatible with the recreated render pass as long as its attachment formats do not change
+        if (vulkanRenderPass->getColorFormat() != colorFormat) {
+            vulkanGraphicsPipelineCache->clear();
+            vulkanGraphicsPipelineCache->precompile(getPipelineDescriptions());
+        }
+        return true;
     }
 
-    void App::drawFrame() {
+    void App::onShaderCompiled(const std::string& path, const std::vector<uint32_t>& code) {
+        bool isVertexShader = path == VERTEX_SHADER_PATH;
+        if (!isVertexShader && path != FRAGMENT_SHADER_PATH) {
+            return;
+        }
+        auto* shader = new VulkanShader(vulkanDevice);
+        if (!shader->initialize(code.data(), code.size() * sizeof(uint32_t))) {
+            VD_LOG_ERROR("Could not reload shader [{}]", path);
+            delete shader;
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(shaderReloadMutex);
+        VulkanShader*& reloadedShader = isVertexShader ? reloadedPipeline.VertexShader : reloadedPipeline.FragmentShader;
+        terminateReloadedShader(reloadedShader);
+        reloadedShader = shader;
+
+        // Stages that did not change keep using the shader of the current pipeline
+        GraphicsPipelineDescription description = getPipelineDescription(colorMode);
+        if (reloadedPipeline.VertexShader != nullptr) {
+            description.VertexShader = reloadedPipeline.VertexShader;
+        }
+        if (reloadedPipeline.FragmentShader != nullptr) {
+            description.FragmentShader = reloadedPipeline.FragmentShader;
+        }
+        reloadedPipeline.GraphicsPipeline = vulkanGraphicsPipelineCache->getPipeline(description);
+        if (reloadedPipeline.GraphicsPipeline == nullptr) {
+            VD_LOG_ERROR("Could not rebuild Vulkan graphics pipeline for shader [{}]", path);
+            return;
+        }
+        VD_LOG_INFO("Rebuilt Vulkan graphics pipeline for shader [{}]", path);
+    }
+
+    void App::swapReloadedPipeline() {
+        if (reloadedPipeline.GraphicsPipeline == nullptr) {
+            return;
+        }
+        // Frames still in flight may use the pipelines of the old shaders, the deletion queue destroys them once those frames have completed.
+        // The cache destroys the old shaders themselves once no build in flight uses them, without waiting here.
+        if (reloadedPipeline.VertexShader != nullptr) {
+            vulkanGraphicsPipelineCache->evict(vertexShader);
+            vertexShader = reloadedPipeline.VertexShader;
+        }
+        if (reloadedPipeline.FragmentShader != nullptr) {
+            vulkanGraphicsPipelineCache->evict(fragmentShader);
+            fragmentShader = reloadedPipeline.FragmentShader;
+        }
+        reloadedPipeline = {};
+        vulkanGraphicsPipelineCache->precompile(getPipelineDescriptions());
+        VD_LOG_INFO("Swapped in reloaded Vulkan graphics pipeline");
+    }
+
+    GraphicsPipelineDescription App::getPipelineDescription(uint32_t mode) const {
+        GraphicsPipelineDescription description;
+        description.VertexShader = vertexShader;
+        description.FragmentShader = fragmentShader;
+        description.Specialization.set(COLOR_MODE_CONSTANT_ID, mode);
+        description.declarePushConstants<DrawConstants>(VK_SHADER_STAGE_VERTEX_BIT);
+        description.SetLayouts[VulkanBindlessDescriptors::BINDLESS_SET] = vulkanBindlessDescriptors->getDescriptorSetLayout();
+        description.RenderPass = vulkanRenderPass;
+        return description;
+    }
+
+    std::vector<GraphicsPipelineDescription> App::getPipelineDescriptions() const {
+        // The variant in use comes first so it is the first one to finish compiling
+        std::vector<GraphicsPipelineDescription> descriptions;
+        for (uint32_t i = 0; i < COLOR_MODE_COUNT; i++) {
+            descriptions.push_back(getPipelineDescription((colorMode + i) % COLOR_MODE_COUNT));
+        }
+        return descriptions;
+    }
+
+    uint32_t App::recordSceneDraws(const VulkanCommandBuffer& vulkanCommandBuffer, const VulkanGraphicsPipeline& vulkanGraphicsPipeline, SubmissionMode mode, const glm::mat4& viewProjection, uint32_t& drawnObjectCount) {
+        drawnObjectCount = instancedScene->getInstanceCount();
+        DrawConstants drawConstants{};
+        drawConstants.ViewProjection = viewProjection;
+        drawConstants.VertexBufferIndex = vertexBufferIndex;
+        drawConstants.InstanceBufferIndex = instanceBufferIndex;
+        drawConstants.TransformBufferIndex = transformBuffer->getBindlessIndex();
+
+        constexpr VkDeviceSize indexBufferOffset = 0;
+        vkCmdBindIndexBuffer(vulkanCommandBuffer.getCommandBuffer(), vulkanResources->getBuffer(indexBuffer)->getBuffer(), indexBufferOffset, VK_INDEX_TYPE_UINT32);
+
+        const std::vector<Mesh>& meshes = instancedScene->getMeshes();
+        const std::vector<InstanceBatch>& batches = instancedScene->getBatches();
+        if (mode == SubmissionMode::Instanced) {
+            vulkanGraphicsPipeline.pushConstants(vulkanCommandBuffer, drawConstants);
+            for (const InstanceBatch& batch : batches) {
+                const Mesh& mesh = meshes[batch.MeshIndex];
+                vkCmdDrawIndexed(vulkanCommandBuffer.getCommandBuffer(), mesh.IndexCount, batch.InstanceCount, mesh.FirstIndex, mesh.VertexOffset, batch.FirstInstance);
+            }
+            return (uint32_t) batches.size();
+        }
+        if (mode == SubmissionMode::GpuCulled && vulkanCullingPass->isSupported()) {
+            // The culling pass recorded before the render pass has written the commands and the count
+            vulkanGraphicsPipeline.pushConstants(vulkanCommandBuffer, drawConstants);
+            indirectDrawBuffer->drawWithCount(vulkanCommandBuffer);
+            return 1;
+        }
+        if (mode == SubmissionMode::Indirect || mode == SubmissionMode::CpuCulled || mode == SubmissionMode::GpuCulled) {
+            // Every draw of the pipeline collapses into one call, the draw count is read from the buffer when the device supports it.
+            // Devices that cannot cull on the GPU cull on the CPU instead.
+            uint32_t drawCount;
+            if (mode == SubmissionMode::Indirect) {
+                drawCount = instancedScene->writeDrawCommands(indirectDrawBuffer->getCommands());
+            } else {
+                uint32_t visibleCount = frustumCuller->cull(Frustum::fromViewProjection(viewProjection), instancedScene->getBoundingSpheres(), visibleInstanceIndices.data());
+                drawCount = instancedScene->writeDrawCommands(visibleInstanceIndices.data(), visibleCount, indirectDrawBuffer->getCommands());
+            }
+            drawnObjectCount = drawCount;
+            indirectDrawBuffer->setDrawCount(drawCount);
+            vulkanGraphicsPipeline.pushConstants(vulkanCommandBuffer, drawConstants);
+            if (indirectDrawBuffer->isDrawCountSupported()) {
+                indirectDrawBuffer->drawWithCount(vulkanCommandBuffer);
+                return 1;
+            }
+            return indirectDrawBuffer->draw(vulkanCommandBuffer, drawCount);
+        }
+        uint32_t drawCallCount = 0;
+        for (const InstanceBatch& batch : batches) {
+            const Mesh& mesh = meshes[batch.MeshIndex];
+            for (uint32_t i = 0; i < batch.InstanceCount; i++) {
+                vulkanGraphicsPipeline.pushConstants(vulkanCommandBuffer, drawConstants);
+                vkCmdDrawIndexed(vulkanCommandBuffer.getCommandBuffer(), mesh.IndexCount, 1, mesh.FirstIndex, mesh.VertexOffset, batch.FirstInstance + i);
+                drawCallCount++;
+            }
+        }
+        return drawCallCount;
+    }
+
+    void App::drawFrame(const FrameSnapshot& snapshot, float alpha) {
 
         /*
          * Preparation
@@ -227,6 +739,25 @@ namespace Vulkandemo {
         constexpr uint64_t waitForFenceTimeout = UINT64_MAX;
         VkFence inFlightFence = inFlightFences[currentFrame];
         vkWaitForFences(vulkanDevice->getDevice(), fenceCount, &inFlightFence, waitForAllFences, waitForFenceTimeout);
+        vulkanDevice->getDeletionQueue()->complete(inFlightSubmissions[currentFrame]);
+
+        // Descriptor sets, the transform buffer and the draw list of this frame slot are no longer in use by the GPU
+        vulkanDescriptorAllocator->beginFrame(currentFrame);
+        transformBuffer->beginFrame(currentFrame);
+        indirectDrawBuffer->beginFrame(currentFrame);
+        vulkanCullingPass->beginFrame(currentFrame, *indirectDrawBuffer);
+        // The buffer of this frame slot holds the matrices as of its previous frame, only those changed since then are written. Matrices that
+        // changed in the last step are interpolated, so they are written again by the next frame of the slot.
+        instancedScene->writeTransforms(snapshot.PreviousTransforms, snapshot.Transforms, alpha, transformBuffer->getMappedDataAs<glm::mat4>(), uploadedTransformVersions[currentFrame]);
+        uploadedTransformVersions[currentFrame] = snapshot.PreviousTransforms.Version;
+        glm::mat4 viewProjection = snapshot.PreviousViewProjection + (snapshot.ViewProjection - snapshot.PreviousViewProjection) * alpha;
+
+        // Swap in pipelines rebuilt by shader hot reload at the frame boundary, without waiting for a rebuild that is still in progress
+        std::unique_lock<std::mutex> shaderReloadLock(shaderReloadMutex, std::try_to_lock);
+        if (shaderReloadLock.owns_lock()) {
+            swapReloadedPipeline();
+            shaderReloadLock.unlock();
+        }
 
         // Acquire an image from the swap chain
         uint32_t swapChainImageIndex;
@@ -259,25 +790,86 @@ namespace Vulkandemo {
          * Recording
          */
 
+        std::chrono::steady_clock::time_point recordStartTime = std::chrono::steady_clock::now();
         VulkanCommandBuffer vulkanCommandBuffer = vulkanCommandBuffers[currentFrame];
         vulkanCommandBuffer.reset();
         vulkanCommandBuffer.begin();
 
-        vulkanRenderPass->begin(vulkanCommandBuffer, framebuffers.at(swapChainImageIndex));
-        vulkanGraphicsPipeline->bind(vulkanCommandBuffer);
+        uint32_t drawCallCount = 0;
+        uint32_t drawnObjectCount = 0;
+        // Until the pipeline has been compiled (or if it failed to compile) only the cleared render pass is presented as a placeholder frame
+        VulkanGraphicsPipeline* vulkanGraphicsPipeline = vulkanGraphicsPipelineCache->tryGetPipeline(getPipelineDescription(snapshot.ColorMode));
+        if (vulkanGraphicsPipeline != nullptr && !firstFrameRendered) {
+            firstFrameRendered = true;
+            double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - initializeStartTime).count();
+            VD_LOG_INFO("Recording first frame with compiled pipelines [{:.2f}] ms after initialization started", milliseconds);
+        }
+        SubmissionMode mode = submissionBenchmark->isEnabled() ? submissionBenchmark->getMode() : snapshot.Submission;
+        bool gpuCulled = vulkanGraphicsPipeline != nullptr && mode == SubmissionMode::GpuCulled && vulkanCullingPass->isSupported();
+
+        vulkanRenderGraph->reset();
+        RenderGraphResource swapChainImage = vulkanRenderGraph->importImage(
+                "SwapChainImage",
+                vulkanSwapChain->getImages().at(swapChainImageIndex),
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                RenderGraphAccess::SwapChainAcquire,
+                RenderGraphAccess::Present
+        );
+        vulkanRenderGraph->setOutput(swapChainImage);
+        // The draw count is read back by the culling pass statistics
+        RenderGraphResource drawList = vulkanRenderGraph->importBuffer("DrawList", indirectDrawBuffer->getBuffer(), RenderGraphAccess::None, RenderGraphAccess::HostRead);
+
+        // Culled by the graph unless the scene pass draws what it writes
+        if (vulkanCullingPass->isSupported()) {
+            RenderGraphPass cullingPass = vulkanRenderGraph->addPass("Culling", [&](const VulkanCommandBuffer& commandBuffer) {
+                vulkanCullingPass->record(commandBuffer, Frustum::fromViewProjection(viewProjection), instanceBufferIndex, transformBuffer->getBindlessIndex(), *indirectDrawBuffer);
+            });
+            vulkanRenderGraph->write(cullingPass, drawList, RenderGraphAccess::ComputeShaderWrite);
+        }
 
-        constexpr uint32_t vertexCount = 3;
-        constexpr uint32_t instanceCount = 1;
-        constexpr uint32_t firstVertex = 0;
-        constexpr uint32_t firstInstance = 0;
-        vkCmdDraw(vulkanCommandBuffer.getCommandBuffer(), vertexCount, instanceCount, firstVertex, firstInstance);
+        RenderGraphPass scenePass = vulkanRenderGraph->addPass("Scene", [&](const VulkanCommandBuffer& commandBuffer) {
+            vulkanRenderPass->begin(commandBuffer, *vulkanResources->getFramebuffer(framebuffers.at(swapChainImageIndex)));
+            if (vulkanGraphicsPipeline != nullptr) {
+                vulkanGraphicsPipeline->bind(commandBuffer);
+
+                VkViewport viewport{};
+                viewport.x = 0.0f;
+                viewport.y = 0.0f;
+                viewport.width = (float) vulkanSwapChain->getExtent().width;
+                viewport.height = (float) vulkanSwapChain->getExtent().height;
+                viewport.minDepth = 0.0f;
+                viewport.maxDepth = 1.0f;
+                vkCmdSetViewport(commandBuffer.getCommandBuffer(), 0, 1, &viewport);
+
+                VkRect2D scissor{};
+                scissor.offset = {0, 0};
+                scissor.extent = vulkanSwapChain->getExtent();
+                vkCmdSetScissor(commandBuffer.getCommandBuffer(), 0, 1, &scissor);
+
+                // Bound once, every draw selects its resources with indices passed as push constants
+                vulkanBindlessDescriptors->bind(commandBuffer, vulkanGraphicsPipeline->getPipelineLayout());
+
+                drawCallCount = recordSceneDraws(commandBuffer, *vulkanGraphicsPipeline, mode, viewProjection, drawnObjectCount);
+            }
+            vulkanRenderPass->end(commandBuffer);
+        });
+        vulkanRenderGraph->write(scenePass, swapChainImage, RenderGraphAccess::ColorAttachmentWrite);
+        // Draw lists filled on the CPU need no barrier, host writes are visible to the submission
+        if (gpuCulled) {
+            vulkanRenderGraph->read(scenePass, drawList, RenderGraphAccess::IndirectCommandRead);
+        }
 
-        vulkanRenderPass->end(vulkanCommandBuffer);
+        if (!vulkanRenderGraph->compile()) {
+            VD_LOG_CRITICAL("Could not compile render graph");
+            throw std::runtime_error("Could not compile render graph");
+        }
+        vulkanRenderGraph->execute(vulkanCommandBuffer);
 
         if (!vulkanCommandBuffer.end()) {
             VD_LOG_CRITICAL("Could not end frame");
             throw std::runtime_error("Could not end frame");
         }
+        double recordMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - recordStartTime).count();
 
         /*
          * Submission
@@ -305,6 +897,7 @@ namespace Vulkandemo {
 
         // Submit recorded graphics commands
         constexpr uint32_t submitCount = 1;
+        inFlightSubmissions[currentFrame] = vulkanDevice->getDeletionQueue()->addSubmission();
         if (vkQueueSubmit(vulkanDevice->getGraphicsQueue(), submitCount, &submitInfo, inFlightFence) != VK_SUCCESS) {
             VD_LOG_CRITICAL("Could not submit to graphics queue");
             throw std::runtime_error("Could not submit to graphics queue");
@@ -329,15 +922,28 @@ namespace Vulkandemo {
 
         // Present image to swap chain
         VkResult presentResult = vkQueuePresentKHR(vulkanDevice->getPresentQueue(), &presentInfo);
-        if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR || windowResized) {
-            windowResized = false;
+        bool resized = windowResized.exchange(false);
+        if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR || resized) {
             recreateRenderingObjects();
         } else if (presentResult != VK_SUCCESS) {
             VD_LOG_CRITICAL("Could not present image to swap chain");
             throw std::runtime_error("Could not present image to swap chain");
         }
 
+        // Placeholder frames do not draw the scene, so they are left out of the benchmark
+        if (vulkanGraphicsPipeline != nullptr) {
+            // GPU culling statistics are those of the last completed frame
+            if (gpuCulled) {
+                drawnObjectCount = vulkanCullingPass->getStatistics().DrawnObjectCount;
+            }
+            submissionBenchmark->addFrame(recordMilliseconds, drawCallCount, instancedScene->getInstanceCount(), drawnObjectCount);
+            if (submissionBenchmark->isFinished()) {
+                window->close();
+            }
+        }
+
         currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+        frameNumber++;
     }
 
 }
\ No newline at end of file
@@ -2,19 +2,46 @@
 
 #include "Log.h"
 #include "FileSystem.h"
+#include "JobSystem.h"
+#include "AssetArchive.h"
+#include "AssetLoader.h"
+#include "ShaderWatcher.h"
+#include "InstancedScene.h"
+#include "SubmissionBenchmark.h"
+#include "CullingBenchmark.h"
+#include "FrustumCuller.h"
+#include "FrameSnapshot.h"
+#include "SimulationClock.h"
+#include "TripleBuffer.h"
+#include "SpscQueue.h"
 #include "Window.h"
 #include "Vulkan.h"
 #include "VulkanPhysicalDevice.h"
 #include "VulkanDevice.h"
 #include "VulkanSwapChain.h"
 #include "VulkanRenderPass.h"
+#include "VulkanRenderGraph.h"
+#include "VulkanLayoutCache.h"
+#include "VulkanBuffer.h"
+#include "VulkanBindlessDescriptors.h"
+#include "VulkanPerFrameBuffer.h"
+#include "VulkanIndirectDrawBuffer.h"
+#include "VulkanCullingPass.h"
+#include "VulkanDescriptorAllocator.h"
 #include "VulkanGraphicsPipeline.h"
+#include "VulkanGraphicsPipelineCache.h"
 #include "VulkanFramebuffer.h"
+#include "VulkanResources.h"
 #include "VulkanCommandPool.h"
 #include "VulkanCommandBuffer.h"
 
 #include <vulkan/vulkan.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace Vulkandemo {
@@ -24,13 +51,45 @@ namespace Vulkandemo {
         struct Config {
             std::string Name;
             Log::Level LogLevel;
+            JobSystem::Config JobSystem;
+            AssetLoader::Config AssetLoader;
+            ShaderWatcher::Config ShaderWatcher;
+            VulkanBindlessDescriptors::Config BindlessDescriptors;
+            SimulationClock::Config Simulation;
+            InstancedScene::Config Scene;
+            SubmissionBenchmark::Config Benchmark;
+            FrustumCuller::Config FrustumCuller;
+            CullingBenchmark::Config CullingBenchmark;
             Window::Config Window;
             Vulkan::Config Vulkan;
         };
 
+    private:
+        // Shaders recompiled by the shader watcher and the pipeline built from them, waiting to be swapped in at the next frame boundary
+        struct ReloadedPipeline {
+            VulkanShader* VertexShader = nullptr;
+            VulkanShader* FragmentShader = nullptr;
+            // Owned by the graphics pipeline cache
+            VulkanGraphicsPipeline* GraphicsPipeline = nullptr;
+        };
+
+        // Collected by the render thread since StartTime, steps and simulation time are counted from the snapshot values in here
+        struct FrameStatistics {
+            std::chrono::steady_clock::time_point StartTime;
+            uint64_t FrameCount = 0;
+            uint64_t StepCount = 0;
+            uint64_t DroppedStepCount = 0;
+            double SimulationSeconds = 0.0;
+            double RenderSeconds = 0.0;
+        };
+
     private:
         Config config;
+        JobSystem* jobSystem;
         FileSystem* fileSystem;
+        AssetArchive* assetArchive;
+        AssetLoader* assetLoader;
+        ShaderWatcher* shaderWatcher;
         Window* window;
         Vulkan* vulkan;
         VulkanPhysicalDevice* vulkanPhysicalDevice;
@@ -38,16 +97,56 @@ namespace Vulkandemo {
         VulkanSwapChain* vulkanSwapChain;
         VulkanShader* vertexShader;
         VulkanShader* fragmentShader;
+        VulkanShader* cullingShader;
         VulkanRenderPass* vulkanRenderPass;
-        VulkanGraphicsPipeline* vulkanGraphicsPipeline;
-        std::vector<VulkanFramebuffer> framebuffers;
+        VulkanRenderGraph* vulkanRenderGraph;
+        VulkanLayoutCache* vulkanLayoutCache;
+        VulkanGraphicsPipelineCache* vulkanGraphicsPipelineCache;
+        VulkanDescriptorAllocator* vulkanDescriptorAllocator;
+        VulkanBindlessDescriptors* vulkanBindlessDescriptors;
+        InstancedScene* instancedScene;
+        VulkanResources* vulkanResources;
+        VulkanBufferHandle vertexBuffer;
+        uint32_t vertexBufferIndex = VulkanBindlessDescriptors::INVALID_INDEX;
+        VulkanBufferHandle indexBuffer;
+        VulkanBufferHandle instanceBuffer;
+        uint32_t instanceBufferIndex = VulkanBindlessDescriptors::INVALID_INDEX;
+        VulkanPerFrameBuffer* transformBuffer;
+        std::vector<uint64_t> uploadedTransformVersions;
+        VulkanIndirectDrawBuffer* indirectDrawBuffer;
+        VulkanCullingPass* vulkanCullingPass;
+        FrustumCuller* frustumCuller;
+        std::vector<uint32_t> visibleInstanceIndices;
+        SubmissionBenchmark* submissionBenchmark;
+        // Owned by the simulation thread, the render thread gets it through the frame snapshots
+        SubmissionMode submissionMode = SubmissionMode::Instanced;
+        std::vector<VulkanFramebufferHandle> framebuffers;
         VulkanCommandPool* vulkanCommandPool;
         std::vector<VulkanCommandBuffer> vulkanCommandBuffers;
         std::vector<VkSemaphore> imageAvailableSemaphores;
         std::vector<VkSemaphore> renderFinishedSemaphores;
         std::vector<VkFence> inFlightFences;
+        // Deletion queue submission of the last frame of every frame slot
+        std::vector<uint64_t> inFlightSubmissions;
         uint32_t currentFrame = 0;
-        bool windowResized = false;
+        uint64_t frameNumber = 0;
+        std::mutex shaderReloadMutex;
+        ReloadedPipeline reloadedPipeline;
+        std::atomic<uint32_t> colorMode{0};
+        std::chrono::steady_clock::time_point initializeStartTime;
+        bool firstFrameRendered = false;
+        std::atomic<bool> windowResized{false};
+        std::atomic<bool> running{false};
+        std::thread simulationThread;
+        std::thread renderThread;
+        // Key presses from the window callbacks on the main thread to the simulation thread
+        SpscQueue<int, 64> keyPresses;
+        TripleBuffer<FrameSnapshot> frameSnapshots;
+        // Guards snapshotPending, which keeps the simulation at most one snapshot ahead of rendering
+        std::mutex snapshotMutex;
+        std::condition_variable snapshotCondition;
+        bool snapshotPending = false;
+        FrameStatistics frameStatistics;
 
     public:
         explicit App(Config config);
@@ -59,12 +158,16 @@ namespace Vulkandemo {
     private:
         bool initialize();
 
+        bool initializeShader(VulkanShader* shader, const char* path, const AssetLoader::Handle& asset) const;
+
         bool initializeRenderingObjects();
 
         bool initializeFramebuffers();
 
         bool initializeSyncObjects();
 
+        bool initializeSceneGeometry();
+
         void terminate();
 
         void terminateSyncObjects() const;
@@ -73,9 +176,34 @@ namespace Vulkandemo {
 
         void terminateRenderingObjects();
 
+        void terminateReloadedPipelines();
+
+        void terminateReloadedShader(VulkanShader* shader);
+
         bool recreateRenderingObjects();
 
-        void drawFrame();
+        void runSimulation();
+
+        void runRendering();
+
+        // Logs steps per frame and the time spent simulating and rendering every few seconds
+        void updateFrameStatistics(const FrameSnapshot& snapshot, double renderSeconds);
+
+        void onKeyPress(int key);
+
+        void onShaderCompiled(const std::string& path, const std::vector<uint32_t>& code);
+
+        void swapReloadedPipeline();
+
+        GraphicsPipelineDescription getPipelineDescription(uint32_t mode) const;
+
+        std::vector<GraphicsPipelineDescription> getPipelineDescriptions() const;
+
+        // Returns the number of draw calls recorded, drawnObjectCount receives the number of instances drawn unless they are culled on the GPU
+        uint32_t recordSceneDraws(const VulkanCommandBuffer& vulkanCommandBuffer, const VulkanGraphicsPipeline& vulkanGraphicsPipeline, SubmissionMode mode, const glm::mat4& viewProjection, uint32_t& drawnObjectCount);
+
+        // Alpha blends from the previous (0) to the current (1) state of the snapshot
+        void drawFrame(const FrameSnapshot& snapshot, float alpha);
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "Archetype.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace Vulkandemo {
+
+    uint32_t ComponentType::nextId() {
+        static std::atomic<uint32_t> nextComponentId{0};
+        uint32_t id = nextComponentId++;
+        VD_ASSERT(id < MAX_COMPONENT_TYPES);
+        return id;
+    }
+
+    Archetype::Archetype(const std::vector<ComponentType>& componentTypes) {
+        columnIndices.fill(-1);
+        for (const ComponentType& componentType : componentTypes) {
+            mask |= (ComponentMask) 1 << componentType.Id;
+            columnIndices[componentType.Id] = (int32_t) columns.size();
+            columns.push_back({componentType, 0});
+        }
+
+        // As many entities as fit into a chunk once every array is aligned
+        size_t entitySize = sizeof(Entity);
+        for (const Column& column : columns) {
+            entitySize += column.Type.Size;
+        }
+        chunkCapacity = (uint32_t) std::max<size_t>(CHUNK_SIZE / entitySize, 1);
+        while (true) {
+            size_t offset = entitiesOffset + chunkCapacity * sizeof(Entity);
+            for (Column& column : columns) {
+                offset = (offset + column.Type.Alignment - 1) / column.Type.Alignment * column.Type.Alignment;
+                column.Offset = offset;
+                offset += (size_t) chunkCapacity * column.Type.Size;
+            }
+            if (offset <= CHUNK_SIZE || chunkCapacity == 1) {
+                chunkDataSize = offset;
+                break;
+            }
+            chunkCapacity--;
+        }
+    }
+
+    ComponentMask Archetype::getMask() const {
+        return mask;
+    }
+
+    uint32_t Archetype::getEntityCount() const {
+        return entityCount;
+    }
+
+    uint32_t Archetype::getChunkCapacity() const {
+        return chunkCapacity;
+    }
+
+    uint32_t Archetype::getChunkCount() const {
+        return (uint32_t) chunks.size();
+    }
+
+    uint32_t Archetype::getChunkEntityCount(uint32_t chunk) const {
+        return chunks[chunk].Count;
+    }
+
+    Entity* Archetype::getEntities(uint32_t chunk) const {
+        return (Entity*) (chunks[chunk].Data.get() + entitiesOffset);
+    }
+
+    void* Archetype::getComponents(uint32_t chunk, uint32_t componentId) const {
+        int32_t columnIndex = columnIndices[componentId];
+        return columnIndex < 0 ? nullptr : getColumn(chunk, columns[columnIndex]);
+    }
+
+    void Archetype::add(Entity entity, uint32_t& chunk, uint32_t& row) {
+        if (chunks.empty() || chunks.back().Count == chunkCapacity) {
+            Chunk newChunk;
+            newChunk.Data = std::make_unique<std::byte[]>(chunkDataSize);
+            chunks.push_back(std::move(newChunk));
+        }
+        chunk = (uint32_t) chunks.size() - 1;
+        row = chunks.back().Count++;
+        getEntities(chunk)[row] = entity;
+        entityCount++;
+    }
+
+    Entity Archetype::remove(uint32_t chunk, uint32_t row) {
+        auto lastChunk = (uint32_t) chunks.size() - 1;
+        uint32_t lastRow = chunks.back().Count - 1;
+        Entity movedEntity;
+        if (chunk != lastChunk || row != lastRow) {
+            movedEntity = getEntities(lastChunk)[lastRow];
+            getEntities(chunk)[row] = movedEntity;
+            for (const Column& column : columns) {
+                std::memcpy(getColumn(chunk, column) + (size_t) row * column.Type.Size, getColumn(lastChunk, column) + (size_t) lastRow * column.Type.Size, column.Type.Size);
+            }
+        }
+        if (--chunks.back().Count == 0) {
+            chunks.pop_back();
+        }
+        entityCount--;
+        return movedEntity;
+    }
+
+    void Archetype::clear() {
+        chunks.clear();
+        entityCount = 0;
+    }
+
+    std::byte* Archetype::getColumn(uint32_t chunk, const Column& column) const {
+        return chunks[chunk].Data.get() + column.Offset;
+    }
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Entity.h"
+#include "Assert.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Vulkandemo {
+
+    constexpr uint32_t MAX_COMPONENT_TYPES = 64;
+
+    // One bit per component type
+    using ComponentMask = uint64_t;
+
+    struct ComponentType {
+        uint32_t Id;
+        uint32_t Size;
+        uint32_t Alignment;
+
+        // Ids are assigned on first use, in the order the types are first used
+        static uint32_t nextId();
+
+        template<typename T>
+        static uint32_t getId() {
+            static const uint32_t id = nextId();
+            return id;
+        }
+
+        template<typename T>
+        static ComponentType of() {
+            // Components are moved between chunk rows with memcpy and never constructed or destroyed
+            static_assert(std::is_trivially_copyable_v<T>, "Components must be trivially copyable");
+            static_assert(alignof(T) <= alignof(std::max_align_t), "Components must not be over-aligned");
+            return {getId<T>(), (uint32_t) sizeof(T), (uint32_t) alignof(T)};
+        }
+    };
+
+}
+
+namespace Vulkandemo {
+
+    // Storage of every entity with exactly the same set of component types. Entities are packed into fixed size chunks, and within a chunk every
+    // component type is an array of its own, so iterating a component touches nothing but that component's data.
+    class Archetype {
+    public:
+        static constexpr size_t CHUNK_SIZE = 16 * 1024;
+
+    private:
+        // Array of one component type inside every chunk
+        struct Column {
+            ComponentType Type;
+            size_t Offset;
+        };
+
+        struct Chunk {
+            std::unique_ptr<std::byte[]> Data;
+            uint32_t Count = 0;
+        };
+
+    private:
+        ComponentMask mask = 0;
+        std::vector<Column> columns;
+        // Column of every component id, -1 for components the archetype does not have
+        std::array<int32_t, MAX_COMPONENT_TYPES> columnIndices{};
+        // Handles of the entities in each chunk come first
+        size_t entitiesOffset = 0;
+        uint32_t chunkCapacity = 0;
+        // At most CHUNK_SIZE, unless a single entity does not fit into it
+        size_t chunkDataSize = 0;
+        std::vector<Chunk> chunks;
+        uint32_t entityCount = 0;
+
+    public:
+        explicit Archetype(const std::vector<ComponentType>& componentTypes);
+
+        ComponentMask getMask() const;
+
+        uint32_t getEntityCount() const;
+
+        uint32_t getChunkCapacity() const;
+
+        uint32_t getChunkCount() const;
+
+        // Number of entities in the chunk, every chunk but the last is full
+        uint32_t getChunkEntityCount(uint32_t chunk) const;
+
+        Entity* getEntities(uint32_t chunk) const;
+
+        // nullptr when the archetype does not have the component
+        void* getComponents(uint32_t chunk, uint32_t componentId) const;
+
+        template<typename T>
+        T* getComponents(uint32_t chunk) const {
+            return (T*) getComponents(chunk, ComponentType::getId<T>());
+        }
+
+        // Appends the entity with uninitialized components and returns where it was placed
+        void add(Entity entity, uint32_t& chunk, uint32_t& row);
+
+        // Fills the hole with the last entity of the archetype and returns that entity, or an invalid entity if the removed one was the last
+        Entity remove(uint32_t chunk, uint32_t row);
+
+        void clear();
+
+    private:
+        std::byte* getColumn(uint32_t chunk, const Column& column) const;
+    };
+
+}
@@ -0,0 +1,33 @@
+#include "Asset.h"
+
+#include <utility>
+
+namespace Vulkandemo {
+
+    Asset::Asset(MappedFile file) : file(std::move(file)) {
+        data = this->file.getData();
+        size = this->file.getSize();
+    }
+
+    Asset::Asset(const void* data, uint64_t size) : data(data), size(size) {
+    }
+
+    const void* Asset::getData() const {
+        return data;
+    }
+
+    uint64_t Asset::getSize() const {
+        return size;
+    }
+
+    bool Asset::isLoaded() const {
+        return data != nullptr;
+    }
+
+    void Asset::release() {
+        file.close();
+        data = nullptr;
+        size = 0;
+    }
+
+}
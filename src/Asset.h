@@ -0,0 +1,39 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstdint>
+
+namespace Vulkandemo {
+
+    // Loaded asset bytes. Either owns a mapping (a loose file or a decompressed archive entry)
+    // or views memory owned by a mounted archive, which must outlive the asset.
+    class Asset {
+    private:
+        MappedFile file;
+        const void* data = nullptr;
+        uint64_t size = 0;
+
+    public:
+        Asset() = default;
+
+        explicit Asset(MappedFile file);
+
+        Asset(const void* data, uint64_t size);
+
+        const void* getData() const;
+
+        // Both mappings and archive entries are page aligned, so the data is suitably aligned for any scalar type
+        template<typename T>
+        const T* getDataAs() const {
+            return (const T*) data;
+        }
+
+        uint64_t getSize() const;
+
+        bool isLoaded() const;
+
+        void release();
+    };
+
+}
@@ -0,0 +1,160 @@
+#include "AssetArchive.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#ifdef VD_LZ4
+    #include <lz4.h>
+#endif
+#ifdef VD_ZSTD
+    #include <zstd.h>
+#endif
+
+namespace Vulkandemo {
+
+    AssetArchive::AssetArchive(FileSystem* fileSystem) : fileSystem(fileSystem) {
+    }
+
+    uint32_t AssetArchive::getEntryCount() const {
+        return header != nullptr ? header->EntryCount : 0;
+    }
+
+    bool AssetArchive::initialize(const char* path) {
+        file = fileSystem->mapFile(path, MappedFile::AccessPattern::Random);
+        if (!file.isOpen()) {
+            VD_LOG_ERROR("Could not map asset archive [{}]", path);
+            return false;
+        }
+        const auto* bytes = file.getDataAs<uint8_t>();
+        header = (const AssetArchiveHeader*) bytes;
+        if (!validate()) {
+            VD_LOG_ERROR("Could not validate asset archive [{}]", path);
+            terminate();
+            return false;
+        }
+        entries = (const AssetArchiveEntry*) (bytes + header->EntriesOffset);
+        paths = (const char*) (bytes + header->PathsOffset);
+        VD_LOG_INFO("Mounted asset archive [{}] with [{}] entries", path, header->EntryCount);
+        return true;
+    }
+
+    void AssetArchive::terminate() {
+        file.close();
+        header = nullptr;
+        entries = nullptr;
+        paths = nullptr;
+    }
+
+    const AssetArchiveEntry* AssetArchive::findEntry(std::string_view path) const {
+        if (header == nullptr) {
+            return nullptr;
+        }
+        uint64_t pathHash = hashAssetPath(path.data(), path.length());
+        const AssetArchiveEntry* begin = entries;
+        const AssetArchiveEntry* end = entries + header->EntryCount;
+        const AssetArchiveEntry* entry = std::lower_bound(begin, end, pathHash, [](const AssetArchiveEntry& entry, uint64_t hash) {
+            return entry.PathHash < hash;
+        });
+        // Entries are sorted by hash, so colliding paths are adjacent
+        for (; entry != end && entry->PathHash == pathHash; entry++) {
+            if (getPath(*entry) == path) {
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
+    std::string_view AssetArchive::getPath(const AssetArchiveEntry& entry) const {
+        return {paths + entry.PathOffset, entry.PathLength};
+    }
+
+    bool AssetArchive::read(const AssetArchiveEntry& entry, Asset& asset) const {
+        if (entry.Compression != AssetCompression::None) {
+            return decompress(entry, asset);
+        }
+        file.advise(MappedFile::AccessPattern::WillNeed, entry.Offset, entry.Size);
+        asset = Asset(file.getDataAs<uint8_t>() + entry.Offset, entry.Size);
+        return true;
+    }
+
+    bool AssetArchive::validate() const {
+        uint64_t fileSize = file.getSize();
+        if (fileSize < sizeof(AssetArchiveHeader)) {
+            VD_LOG_ERROR("Asset archive is smaller than its header");
+            return false;
+        }
+        if (memcmp(header->Magic, ASSET_ARCHIVE_MAGIC, sizeof(ASSET_ARCHIVE_MAGIC)) != 0) {
+            VD_LOG_ERROR("Asset archive has an invalid magic number");
+            return false;
+        }
+        if (header->Version != ASSET_ARCHIVE_VERSION) {
+            VD_LOG_ERROR("Asset archive has version [{}] but version [{}] is required", header->Version, ASSET_ARCHIVE_VERSION);
+            return false;
+        }
+        // Bounds are checked as subtractions from the file size, so that offsets and sizes close to UINT64_MAX cannot wrap around
+        uint64_t entriesSize = (uint64_t) header->EntryCount * sizeof(AssetArchiveEntry);
+        bool entriesInBounds = header->EntriesOffset <= fileSize && entriesSize <= fileSize - header->EntriesOffset;
+        if (header->EntriesOffset % alignof(AssetArchiveEntry) != 0 || !entriesInBounds || header->PathsOffset > fileSize) {
+            VD_LOG_ERROR("Asset archive index is out of bounds");
+            return false;
+        }
+        const auto* archiveEntries = (const AssetArchiveEntry*) (file.getDataAs<uint8_t>() + header->EntriesOffset);
+        for (uint32_t i = 0; i < header->EntryCount; i++) {
+            const AssetArchiveEntry& entry = archiveEntries[i];
+            bool dataInBounds = entry.Offset <= fileSize && entry.StoredSize <= fileSize - entry.Offset;
+            uint64_t pathsSize = fileSize - header->PathsOffset;
+            bool pathInBounds = entry.PathOffset <= pathsSize && entry.PathLength <= pathsSize - entry.PathOffset;
+            bool aligned = header->Alignment == 0 || entry.Offset % header->Alignment == 0;
+            if (!dataInBounds || !pathInBounds || !aligned) {
+                VD_LOG_ERROR("Asset archive entry [{}] is out of bounds or misaligned", i);
+                return false;
+            }
+            // Uncompressed entries are read straight from the mapping, entry.Size bytes of it
+            if (entry.Compression == AssetCompression::None && entry.Size != entry.StoredSize) {
+                VD_LOG_ERROR("Asset archive entry [{}] is uncompressed but its size [{}] differs from its stored size [{}]", i, entry.Size, entry.StoredSize);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool AssetArchive::decompress(const AssetArchiveEntry& entry, Asset& asset) const {
+        // Unused when the build supports no compression
+        [[maybe_unused]] const char* source = file.getDataAs<char>() + entry.Offset;
+        MappedFile decompressed;
+        if (!decompressed.allocate(entry.Size)) {
+            return false;
+        }
+        [[maybe_unused]] auto* destination = (char*) decompressed.getData();
+        switch (entry.Compression) {
+#ifdef VD_LZ4
+            case AssetCompression::LZ4: {
+                int decompressedSize = LZ4_decompress_safe(source, destination, (int) entry.StoredSize, (int) entry.Size);
+                if (decompressedSize < 0 || (uint64_t) decompressedSize != entry.Size) {
+                    VD_LOG_ERROR("Could not decompress LZ4 asset [{}]", getPath(entry));
+                    return false;
+                }
+                break;
+            }
+#endif
+#ifdef VD_ZSTD
+            case AssetCompression::Zstd: {
+                size_t decompressedSize = ZSTD_decompress(destination, entry.Size, source, entry.StoredSize);
+                if (ZSTD_isError(decompressedSize) || decompressedSize != entry.Size) {
+                    VD_LOG_ERROR("Could not decompress zstd asset [{}]", getPath(entry));
+                    return false;
+                }
+                break;
+            }
+#endif
+            default:
+                VD_LOG_ERROR("Could not decompress asset [{}] because compression [{}] is not supported by this build", getPath(entry), (uint32_t) entry.Compression);
+                return false;
+        }
+        asset = Asset(std::move(decompressed));
+        return true;
+    }
+
+}
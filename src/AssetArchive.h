@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Asset.h"
+#include "AssetArchiveFormat.h"
+#include "FileSystem.h"
+#include "MappedFile.h"
+
+#include <string_view>
+
+namespace Vulkandemo {
+
+    class AssetArchive {
+    private:
+        FileSystem* fileSystem;
+        MappedFile file;
+        const AssetArchiveHeader* header = nullptr;
+        const AssetArchiveEntry* entries = nullptr;
+        const char* paths = nullptr;
+
+    public:
+        explicit AssetArchive(FileSystem* fileSystem);
+
+        uint32_t getEntryCount() const;
+
+        bool initialize(const char* path);
+
+        void terminate();
+
+        const AssetArchiveEntry* findEntry(std::string_view path) const;
+
+        std::string_view getPath(const AssetArchiveEntry& entry) const;
+
+        // Uncompressed entries are returned as views into the archive mapping, compressed entries are decompressed into a new mapping
+        bool read(const AssetArchiveEntry& entry, Asset& asset) const;
+
+    private:
+        bool validate() const;
+
+        bool decompress(const AssetArchiveEntry& entry, Asset& asset) const;
+    };
+
+}
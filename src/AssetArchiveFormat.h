@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Hash.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Vulkandemo {
+
+    // On-disk layout of packed asset archives (.vdpk), shared with the `vd pack` CLI command that writes them. All values are little-endian.
+    //
+    // [Header] [Entries, sorted by path hash] [Paths] [Padding] [Entry data, each entry aligned to Header.Alignment]
+
+    constexpr char ASSET_ARCHIVE_MAGIC[4] = {'V', 'D', 'P', 'K'};
+    constexpr uint32_t ASSET_ARCHIVE_VERSION = 1;
+    constexpr uint32_t ASSET_ARCHIVE_ALIGNMENT = 4096;
+
+    enum class AssetCompression : uint32_t {
+        None = 0,
+        LZ4 = 1,
+        Zstd = 2
+    };
+
+    struct AssetArchiveHeader {
+        char Magic[4];
+        uint32_t Version;
+        uint32_t EntryCount;
+        uint32_t Alignment;
+        uint64_t EntriesOffset;
+        uint64_t PathsOffset;
+    };
+
+    struct AssetArchiveEntry {
+        uint64_t PathHash;
+        uint64_t Offset;
+        uint64_t Size;
+        uint64_t StoredSize;
+        uint32_t PathOffset;
+        uint32_t PathLength;
+        AssetCompression Compression;
+        uint32_t Reserved;
+    };
+
+    static_assert(sizeof(AssetArchiveHeader) == 32, "Asset archive header layout changed");
+    static_assert(sizeof(AssetArchiveEntry) == 48, "Asset archive entry layout changed");
+
+    // Over the path with forward slashes as separators
+    inline uint64_t hashAssetPath(const char* path, size_t length) {
+        return hashBytes(path, length);
+    }
+
+}
@@ -0,0 +1,361 @@
+#include "AssetLoader.h"
+#include "Log.h"
+
+#include <algorithm>
+
+#ifdef VD_IO_URING
+    #include <liburing.h>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Vulkandemo {
+
+    double AssetLoader::Stats::getMegabytesPerSecond() const {
+        if (LoadSeconds <= 0.0) {
+            return 0.0;
+        }
+        return ((double) LoadedBytes / (1024.0 * 1024.0)) / LoadSeconds;
+    }
+
+    AssetLoader::Request::Request(std::string path, Priority priority, uint64_t sequenceNumber, std::function<void(const Asset&)> onLoaded)
+            : path(std::move(path)), priority(priority), sequenceNumber(sequenceNumber), onLoaded(std::move(onLoaded)) {
+    }
+
+    const std::string& AssetLoader::Request::getPath() const {
+        return path;
+    }
+
+    AssetLoader::Priority AssetLoader::Request::getPriority() const {
+        return priority;
+    }
+
+    AssetLoader::Request::State AssetLoader::Request::getState() const {
+        return state.load();
+    }
+
+    bool AssetLoader::Request::isDone() const {
+        State currentState = state.load();
+        return currentState == State::Loaded || currentState == State::Failed || currentState == State::Cancelled;
+    }
+
+    AssetLoader::Request::State AssetLoader::Request::wait() const {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this]() {
+            return isDone();
+        });
+        return state.load();
+    }
+
+    void AssetLoader::Request::cancel() {
+        cancelRequested = true;
+        State expectedState = State::Pending;
+        if (state.compare_exchange_strong(expectedState, State::Cancelled)) {
+            complete(State::Cancelled);
+        }
+    }
+
+    const Asset& AssetLoader::Request::getAsset() const {
+        return asset;
+    }
+
+    void AssetLoader::Request::complete(State result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        state = result;
+        condition.notify_all();
+    }
+
+    bool AssetLoader::HandleComparator::operator()(const Handle& a, const Handle& b) const {
+        // Highest priority first, then first come first served within the same priority
+        if (a->priority != b->priority) {
+            return a->priority < b->priority;
+        }
+        return a->sequenceNumber > b->sequenceNumber;
+    }
+
+    AssetLoader::AssetLoader(Config config, FileSystem* fileSystem) : config(config), fileSystem(fileSystem) {
+    }
+
+    AssetLoader::~AssetLoader() {
+        // Worker threads must be joined even if the app bailed out before calling terminate
+        if (!workers.empty()) {
+            terminate();
+        }
+    }
+
+    bool AssetLoader::initialize() {
+        running = true;
+#ifdef VD_IO_URING
+        ring = new io_uring{};
+        if (io_uring_queue_init(config.QueueDepth, ring, 0) == 0) {
+            workers.emplace_back(&AssetLoader::runIoUringWorker, this);
+            VD_LOG_INFO("Initialized asset loader with io_uring (queue depth [{}])", config.QueueDepth);
+            return true;
+        }
+        VD_LOG_WARN("Could not initialize io_uring so falling back to asset loader thread pool");
+        delete ring;
+        ring = nullptr;
+#endif
+        uint32_t workerCount = std::max(config.WorkerCount, 1u);
+        for (uint32_t i = 0; i < workerCount; i++) {
+            workers.emplace_back(&AssetLoader::runWorker, this);
+        }
+        VD_LOG_INFO("Initialized asset loader with [{}] I/O workers", workerCount);
+        return true;
+    }
+
+    void AssetLoader::terminate() {
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            running = false;
+            while (!pendingRequests.empty()) {
+                pendingRequests.top()->cancel();
+                pendingRequests.pop();
+            }
+        }
+        pendingCondition.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+#ifdef VD_IO_URING
+        if (ring != nullptr) {
+            io_uring_queue_exit(ring);
+            delete ring;
+            ring = nullptr;
+        }
+#endif
+        Stats finalStats = getStats();
+        VD_LOG_INFO("Loaded [{}] assets ([{}] bytes) at [{:.2f}] MB/s, [{}] failed, [{}] cancelled", finalStats.LoadedAssets, finalStats.LoadedBytes, finalStats.getMegabytesPerSecond(), finalStats.FailedAssets, finalStats.CancelledAssets);
+        VD_LOG_INFO("Terminated asset loader");
+    }
+
+    void AssetLoader::mount(const AssetArchive* archive) {
+        this->archive = archive;
+    }
+
+    AssetLoader::Handle AssetLoader::load(const std::string& path, Priority priority, std::function<void(const Asset&)> onLoaded) {
+        Handle request;
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            request = std::make_shared<Request>(path, priority, nextSequenceNumber++, std::move(onLoaded));
+            if (!running) {
+                VD_LOG_ERROR("Could not load asset [{}] because the asset loader is not running", path);
+                request->complete(Request::State::Failed);
+                return request;
+            }
+            pendingRequests.push(request);
+        }
+        pendingCondition.notify_one();
+        return request;
+    }
+
+    void AssetLoader::dispatchCompleted() {
+        std::vector<Handle> requests;
+        {
+            std::lock_guard<std::mutex> lock(completedMutex);
+            requests.swap(completedRequests);
+        }
+        for (const Handle& request : requests) {
+            request->onLoaded(request->asset);
+        }
+    }
+
+    AssetLoader::Stats AssetLoader::getStats() {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        Stats currentStats = stats;
+        if (activeLoads > 0) {
+            currentStats.LoadSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - activeSince).count();
+        }
+        return currentStats;
+    }
+
+    void AssetLoader::runWorker() {
+        while (Handle request = popRequest(true)) {
+            if (!beginLoad(request)) {
+                continue;
+            }
+            bool loaded = loadMapped(request);
+            endLoad(request, loaded);
+        }
+    }
+
+    AssetLoader::Handle AssetLoader::popRequest(bool wait) {
+        std::unique_lock<std::mutex> lock(pendingMutex);
+        if (wait) {
+            pendingCondition.wait(lock, [this]() {
+                return !running || !pendingRequests.empty();
+            });
+        }
+        if (!running || pendingRequests.empty()) {
+            return nullptr;
+        }
+        Handle request = pendingRequests.top();
+        pendingRequests.pop();
+        return request;
+    }
+
+    bool AssetLoader::beginLoad(const Handle& request) {
+        Request::State expectedState = Request::State::Pending;
+        if (!request->state.compare_exchange_strong(expectedState, Request::State::Loading)) {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            stats.CancelledAssets++;
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(statsMutex);
+        if (activeLoads++ == 0) {
+            activeSince = std::chrono::steady_clock::now();
+        }
+        return true;
+    }
+
+    void AssetLoader::endLoad(const Handle& request, bool loaded) {
+        bool cancelled = request->cancelRequested.load();
+        {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            if (--activeLoads == 0) {
+                stats.LoadSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - activeSince).count();
+            }
+            if (cancelled) {
+                stats.CancelledAssets++;
+            } else if (loaded) {
+                stats.LoadedAssets++;
+                stats.LoadedBytes += request->asset.getSize();
+            } else {
+                stats.FailedAssets++;
+            }
+        }
+        if (cancelled) {
+            request->asset.release();
+            request->complete(Request::State::Cancelled);
+            return;
+        }
+        if (!loaded) {
+            VD_LOG_ERROR("Could not load asset [{}]", request->path);
+            request->complete(Request::State::Failed);
+            return;
+        }
+        request->complete(Request::State::Loaded);
+        if (request->onLoaded) {
+            std::lock_guard<std::mutex> lock(completedMutex);
+            completedRequests.push_back(request);
+        }
+    }
+
+    bool AssetLoader::loadMapped(const Handle& request) {
+        bool foundInArchive = false;
+        bool loadedFromArchive = loadFromArchive(request, foundInArchive);
+        if (!foundInArchive) {
+            MappedFile file = fileSystem->mapFile(request->path.c_str(), MappedFile::AccessPattern::WillNeed);
+            if (!file.isOpen()) {
+                return false;
+            }
+            request->asset = Asset(std::move(file));
+        } else if (!loadedFromArchive) {
+            return false;
+        }
+        // Touch every page so the page faults are taken on this worker instead of on the thread that consumes the asset
+        constexpr uint64_t pageSize = 4096;
+        const auto* bytes = (const volatile uint8_t*) request->asset.getData();
+        uint8_t checksum = 0;
+        for (uint64_t offset = 0; offset < request->asset.getSize(); offset += pageSize) {
+            checksum ^= bytes[offset];
+        }
+        (void) checksum;
+        return true;
+    }
+
+    bool AssetLoader::loadFromArchive(const Handle& request, bool& found) const {
+        const AssetArchiveEntry* entry = archive != nullptr ? archive->findEntry(request->path) : nullptr;
+        found = entry != nullptr;
+        if (!found) {
+            return false;
+        }
+        return archive->read(*entry, request->asset);
+    }
+
+#ifdef VD_IO_URING
+    void AssetLoader::runIoUringWorker() {
+        struct InFlightRead {
+            Handle Request;
+            MappedFile File;
+            int FileDescriptor = -1;
+            uint64_t Offset = 0;
+        };
+        // Larger files are read in several chunks, one chunk in flight per file
+        static constexpr uint64_t maxReadSize = 64ull * 1024 * 1024;
+
+        auto submitRead = [this](InFlightRead* read) {
+            MappedFile& file = read->File;
+            auto length = (uint32_t) std::min(file.getSize() - read->Offset, maxReadSize);
+            io_uring_sqe* sqe = io_uring_get_sqe(ring);
+            io_uring_prep_read(sqe, read->FileDescriptor, (uint8_t*) file.getData() + read->Offset, length, read->Offset);
+            io_uring_sqe_set_data(sqe, read);
+        };
+
+        uint32_t inFlightCount = 0;
+        while (true) {
+            while (inFlightCount < config.QueueDepth) {
+                Handle request = popRequest(inFlightCount == 0);
+                if (request == nullptr) {
+                    break;
+                }
+                if (!beginLoad(request)) {
+                    continue;
+                }
+                // Archive entries are already mapped, so there is nothing to submit for them
+                bool foundInArchive = false;
+                bool loadedFromArchive = loadFromArchive(request, foundInArchive);
+                if (foundInArchive) {
+                    endLoad(request, loadedFromArchive);
+                    continue;
+                }
+                auto* read = new InFlightRead{request};
+                read->FileDescriptor = open(request->path.c_str(), O_RDONLY);
+                struct stat fileStatus{};
+                if (read->FileDescriptor == -1 || fstat(read->FileDescriptor, &fileStatus) == -1 || fileStatus.st_size == 0 || !read->File.allocate((uint64_t) fileStatus.st_size)) {
+                    if (read->FileDescriptor != -1) {
+                        close(read->FileDescriptor);
+                    }
+                    endLoad(request, false);
+                    delete read;
+                    continue;
+                }
+                submitRead(read);
+                inFlightCount++;
+            }
+            if (inFlightCount == 0) {
+                break;
+            }
+            io_uring_submit(ring);
+
+            io_uring_cqe* cqe = nullptr;
+            if (io_uring_wait_cqe(ring, &cqe) != 0) {
+                continue;
+            }
+            do {
+                auto* read = (InFlightRead*) io_uring_cqe_get_data(cqe);
+                int result = cqe->res;
+                io_uring_cqe_seen(ring, cqe);
+
+                bool failed = result <= 0;
+                if (!failed) {
+                    read->Offset += (uint64_t) result;
+                }
+                bool finished = failed || read->Offset >= read->File.getSize();
+                if (!finished && !read->Request->cancelRequested) {
+                    submitRead(read);
+                    continue;
+                }
+                close(read->FileDescriptor);
+                read->Request->asset = Asset(std::move(read->File));
+                endLoad(read->Request, !failed && finished);
+                delete read;
+                inFlightCount--;
+            } while (io_uring_peek_cqe(ring, &cqe) == 0);
+        }
+    }
+#endif
+
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "Asset.h"
+#include "AssetArchive.h"
+#include "FileSystem.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct io_uring;
+
+namespace Vulkandemo {
+
+    class AssetLoader {
+    public:
+        struct Config {
+            uint32_t WorkerCount = 2;
+            uint32_t QueueDepth = 32;
+        };
+
+        enum class Priority {
+            Low = 0,
+            Normal,
+            High,
+            Critical
+        };
+
+        struct Stats {
+            uint32_t LoadedAssets = 0;
+            uint32_t FailedAssets = 0;
+            uint32_t CancelledAssets = 0;
+            uint64_t LoadedBytes = 0;
+            double LoadSeconds = 0.0;
+
+            double getMegabytesPerSecond() const;
+        };
+
+        class Request {
+        public:
+            enum class State {
+                Pending = 0,
+                Loading,
+                Loaded,
+                Failed,
+                Cancelled
+            };
+
+        private:
+            friend class AssetLoader;
+
+            std::string path;
+            Priority priority;
+            uint64_t sequenceNumber;
+            std::function<void(const Asset&)> onLoaded;
+            std::atomic<State> state{State::Pending};
+            std::atomic<bool> cancelRequested{false};
+            Asset asset;
+            mutable std::mutex mutex;
+            mutable std::condition_variable condition;
+
+        public:
+            Request(std::string path, Priority priority, uint64_t sequenceNumber, std::function<void(const Asset&)> onLoaded);
+
+            const std::string& getPath() const;
+
+            Priority getPriority() const;
+
+            State getState() const;
+
+            bool isDone() const;
+
+            // Blocks until the request has been loaded, has failed or has been cancelled
+            State wait() const;
+
+            void cancel();
+
+            const Asset& getAsset() const;
+
+        private:
+            void complete(State result);
+        };
+
+        using Handle = std::shared_ptr<Request>;
+
+    private:
+        struct HandleComparator {
+            bool operator()(const Handle& a, const Handle& b) const;
+        };
+
+    private:
+        Config config;
+        FileSystem* fileSystem;
+        const AssetArchive* archive = nullptr;
+        std::vector<std::thread> workers;
+        std::priority_queue<Handle, std::vector<Handle>, HandleComparator> pendingRequests;
+        std::vector<Handle> completedRequests;
+        std::mutex pendingMutex;
+        std::condition_variable pendingCondition;
+        std::mutex completedMutex;
+        bool running = false;
+        uint64_t nextSequenceNumber = 0;
+        io_uring* ring = nullptr;
+
+        std::mutex statsMutex;
+        Stats stats;
+        uint32_t activeLoads = 0;
+        std::chrono::steady_clock::time_point activeSince;
+
+    public:
+        AssetLoader(Config config, FileSystem* fileSystem);
+
+        ~AssetLoader();
+
+        bool initialize();
+
+        void terminate();
+
+        // Paths found in a mounted archive are served from it instead of the file system. Mount before issuing any loads.
+        void mount(const AssetArchive* archive);
+
+        Handle load(const std::string& path, Priority priority = Priority::Normal, std::function<void(const Asset&)> onLoaded = nullptr);
+
+        // Invokes the callbacks of finished requests on the calling thread, e.g. once per frame from the main loop
+        void dispatchCompleted();
+
+        Stats getStats();
+
+    private:
+        void runWorker();
+
+#ifdef VD_IO_URING
+        void runIoUringWorker();
+#endif
+
+        Handle popRequest(bool wait);
+
+        bool beginLoad(const Handle& request);
+
+        void endLoad(const Handle& request, bool loaded);
+
+        bool loadMapped(const Handle& request);
+
+        bool loadFromArchive(const Handle& request, bool& found) const;
+    };
+
+}
@@ -0,0 +1,76 @@
+#include "CullingBenchmark.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace Vulkandemo {
+
+    CullingBenchmark::CullingBenchmark(Config config, JobSystem* jobSystem) : config(config), jobSystem(jobSystem) {
+    }
+
+    bool CullingBenchmark::isEnabled() const {
+        return config.Enabled;
+    }
+
+    void CullingBenchmark::run() const {
+        // Spheres fill a cube around the origin and the frustum covers the middle quarter of it, so about a quarter of them are visible
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> centerDistribution(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> radiusDistribution(0.001f, 0.01f);
+        std::vector<glm::vec4> sphereStructures;
+        sphereStructures.reserve(config.SphereCount);
+        BoundingSpheres sphereArrays;
+        for (uint32_t i = 0; i < config.SphereCount; i++) {
+            glm::vec3 center(centerDistribution(random), centerDistribution(random), centerDistribution(random));
+            float radius = radiusDistribution(random);
+            sphereStructures.emplace_back(center, radius);
+            sphereArrays.add(center, radius);
+        }
+        glm::mat4 viewProjection(1.0f);
+        viewProjection[0][0] = 2.0f;
+        viewProjection[1][1] = 2.0f;
+        viewProjection[2][2] = 0.5f;
+        viewProjection[3] = glm::vec4(0.0f, 0.0f, 0.5f, 1.0f);
+        Frustum frustum = Frustum::fromViewProjection(viewProjection);
+
+        FrustumCuller frustumCuller(config.Culler, jobSystem);
+        std::vector<uint32_t> visibleIndices(config.SphereCount);
+        VD_LOG_INFO("Benchmarking frustum culling of [{}] spheres for [{}] iterations ([{}], [{}] threads)", config.SphereCount, config.Iterations, FrustumCuller::getInstructionSetAsString(frustumCuller.getInstructionSet()), frustumCuller.getThreadCount());
+
+        struct Method {
+            const char* Name;
+            std::function<uint32_t()> Cull;
+            double Milliseconds = 0.0;
+            uint32_t VisibleCount = 0;
+        };
+        std::vector<Method> methods = {
+                {"Scalar AoS", [&]() { return FrustumCuller::cullScalar(frustum, sphereStructures.data(), config.SphereCount, visibleIndices.data()); }},
+                {"SIMD SoA", [&]() { return frustumCuller.cullRange(frustum, sphereArrays, 0, config.SphereCount, visibleIndices.data()); }},
+                {"Multithreaded SIMD SoA", [&]() { return frustumCuller.cull(frustum, sphereArrays, visibleIndices.data()); }}
+        };
+        for (Method& method : methods) {
+            // Not measured, brings the spheres into the caches and wakes the job workers
+            method.Cull();
+            std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < config.Iterations; i++) {
+                method.VisibleCount = method.Cull();
+            }
+            method.Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() / std::max(config.Iterations, 1u);
+        }
+
+        VD_LOG_INFO("Frustum culling benchmark results (averages over [{}] iterations)", config.Iterations);
+        for (const Method& method : methods) {
+            VD_LOG_INFO("{} --> [{:.3f}] ms, [{}] visible", method.Name, method.Milliseconds, method.VisibleCount);
+        }
+        for (size_t i = 1; i < methods.size(); i++) {
+            if (methods[i].Milliseconds > 0.0) {
+                VD_LOG_INFO("{} speedup over {} --> [{:.1f}]x", methods[i].Name, methods[0].Name, methods[0].Milliseconds / methods[i].Milliseconds);
+            }
+        }
+    }
+
+}
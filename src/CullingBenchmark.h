@@ -0,0 +1,32 @@
+#pragma once
+
+#include "FrustumCuller.h"
+
+#include <cstdint>
+
+namespace Vulkandemo {
+
+    // Culls the same random spheres one at a time from an array of structures, with SIMD from a structure of arrays and with SIMD split across threads,
+    // and logs the average time of each. Runs on the CPU only, without a window or Vulkan device.
+    class CullingBenchmark {
+    public:
+        struct Config {
+            bool Enabled = false;
+            uint32_t SphereCount = 1000000;
+            uint32_t Iterations = 100;
+            FrustumCuller::Config Culler;
+        };
+
+    private:
+        Config config;
+        JobSystem* jobSystem;
+
+    public:
+        CullingBenchmark(Config config, JobSystem* jobSystem);
+
+        bool isEnabled() const;
+
+        void run() const;
+    };
+
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Vulkandemo {
+
+    // Handle to an entity of an EntityStore. The generation of an index changes every time the index is reused, so handles to destroyed entities
+    // never refer to the entity that replaces them.
+    struct Entity {
+        static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+        uint32_t Index = INVALID_INDEX;
+        uint32_t Generation = 0;
+
+        bool operator==(const Entity& other) const {
+            return Index == other.Index && Generation == other.Generation;
+        }
+
+        bool operator!=(const Entity& other) const {
+            return !(*this == other);
+        }
+    };
+
+}
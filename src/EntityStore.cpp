@@ -0,0 +1,104 @@
+#include "EntityStore.h"
+
+#include <algorithm>
+
+namespace Vulkandemo {
+
+    EntityStore::EntityStore(Config config, JobSystem* jobSystem) : config(config), jobSystem(jobSystem) {
+    }
+
+    void EntityStore::destroy(Entity entity) {
+        if (!isAlive(entity)) {
+            return;
+        }
+        EntityRecord& record = records[entity.Index];
+        Entity movedEntity = record.Owner->remove(record.Chunk, record.Row);
+        if (movedEntity.Index != Entity::INVALID_INDEX) {
+            EntityRecord& movedRecord = records[movedEntity.Index];
+            movedRecord.Chunk = record.Chunk;
+            movedRecord.Row = record.Row;
+        }
+        record.Owner = nullptr;
+        record.Generation++;
+        freeIndices.push_back(entity.Index);
+        entityCount--;
+    }
+
+    bool EntityStore::isAlive(Entity entity) const {
+        return entity.Index < records.size() && records[entity.Index].Owner != nullptr && records[entity.Index].Generation == entity.Generation;
+    }
+
+    uint32_t EntityStore::getEntityCount() const {
+        return entityCount;
+    }
+
+    void EntityStore::clear() {
+        for (const std::unique_ptr<Archetype>& archetype : archetypes) {
+            archetype->clear();
+        }
+        // Generations survive, so handles from before the clear stay invalid
+        freeIndices.clear();
+        for (uint32_t i = 0; i < records.size(); i++) {
+            if (records[i].Owner != nullptr) {
+                records[i].Owner = nullptr;
+                records[i].Generation++;
+            }
+            freeIndices.push_back(i);
+        }
+        entityCount = 0;
+    }
+
+    Archetype* EntityStore::getArchetype(std::vector<ComponentType> componentTypes) {
+        std::sort(componentTypes.begin(), componentTypes.end(), [](const ComponentType& a, const ComponentType& b) {
+            return a.Id < b.Id;
+        });
+        ComponentMask mask = 0;
+        for (const ComponentType& componentType : componentTypes) {
+            VD_ASSERT((mask & ((ComponentMask) 1 << componentType.Id)) == 0);
+            mask |= (ComponentMask) 1 << componentType.Id;
+        }
+        for (const std::unique_ptr<Archetype>& archetype : archetypes) {
+            if (archetype->getMask() == mask) {
+                return archetype.get();
+            }
+        }
+        archetypes.push_back(std::make_unique<Archetype>(componentTypes));
+        return archetypes.back().get();
+    }
+
+    Entity EntityStore::allocate() {
+        entityCount++;
+        if (!freeIndices.empty()) {
+            uint32_t index = freeIndices.back();
+            freeIndices.pop_back();
+            return {index, records[index].Generation};
+        }
+        records.emplace_back();
+        return {(uint32_t) records.size() - 1, 0};
+    }
+
+    std::vector<EntityChunk> EntityStore::findChunks(ComponentMask mask) const {
+        std::vector<EntityChunk> chunks;
+        uint32_t firstIndex = 0;
+        for (const std::unique_ptr<Archetype>& archetype : archetypes) {
+            if ((archetype->getMask() & mask) != mask) {
+                continue;
+            }
+            for (uint32_t chunk = 0; chunk < archetype->getChunkCount(); chunk++) {
+                uint32_t count = archetype->getChunkEntityCount(chunk);
+                chunks.push_back({archetype.get(), chunk, count, firstIndex});
+                firstIndex += count;
+            }
+        }
+        return chunks;
+    }
+
+    void EntityStore::runParallel(const std::vector<EntityChunk>& chunks, const std::function<void(const EntityChunk&)>& function) const {
+        jobSystem->parallelFor(0, (uint32_t) chunks.size(), config.MinChunksPerJob, [&chunks, &function](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                function(chunks[i]);
+            }
+        });
+    }
+
+}
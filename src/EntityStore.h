@@ -0,0 +1,136 @@
+#pragma once
+
+#include "Entity.h"
+#include "Archetype.h"
+#include "Assert.h"
+#include "JobSystem.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Vulkandemo {
+
+    // Chunk of an archetype matched by a query. FirstIndex is the position of the chunk's first entity among all entities the query visits, so
+    // per-entity output can be written to flat arrays from any thread.
+    struct EntityChunk {
+        const Archetype* Owner;
+        uint32_t Chunk;
+        uint32_t Count;
+        uint32_t FirstIndex;
+
+        const Entity* getEntities() const {
+            return Owner->getEntities(Chunk);
+        }
+
+        template<typename T>
+        T* get() const {
+            return Owner->getComponents<T>(Chunk);
+        }
+    };
+
+}
+
+namespace Vulkandemo {
+
+    // Entity-component store with one Archetype per distinct set of component types. Queries visit the matching chunks in a stable order (archetype
+    // creation order, then chunk order), either on the calling thread or split across the job system.
+    class EntityStore {
+    public:
+        struct Config {
+            // Fewer chunks are not worth handing to another thread
+            uint32_t MinChunksPerJob = 16;
+        };
+
+    private:
+        struct EntityRecord {
+            Archetype* Owner = nullptr;
+            uint32_t Chunk = 0;
+            uint32_t Row = 0;
+            uint32_t Generation = 0;
+        };
+
+    private:
+        Config config;
+        JobSystem* jobSystem;
+        std::vector<std::unique_ptr<Archetype>> archetypes;
+        std::vector<EntityRecord> records;
+        std::vector<uint32_t> freeIndices;
+        uint32_t entityCount = 0;
+
+    public:
+        EntityStore(Config config, JobSystem* jobSystem);
+
+        template<typename... Components>
+        Entity create(const Components&... components) {
+            static_assert(sizeof...(Components) > 0, "Entities need at least one component");
+            Archetype* archetype = getArchetype({ComponentType::of<Components>()...});
+            Entity entity = allocate();
+            EntityRecord& record = records[entity.Index];
+            record.Owner = archetype;
+            archetype->add(entity, record.Chunk, record.Row);
+            ((archetype->getComponents<Components>(record.Chunk)[record.Row] = components), ...);
+            return entity;
+        }
+
+        // Moves the last entity of the archetype into the hole, so the query order of that entity changes
+        void destroy(Entity entity);
+
+        bool isAlive(Entity entity) const;
+
+        // nullptr when the entity is not alive or does not have the component. Valid until the next create or destroy.
+        template<typename T>
+        T* get(Entity entity) const {
+            if (!isAlive(entity)) {
+                return nullptr;
+            }
+            const EntityRecord& record = records[entity.Index];
+            T* components = record.Owner->getComponents<T>(record.Chunk);
+            return components != nullptr ? components + record.Row : nullptr;
+        }
+
+        uint32_t getEntityCount() const;
+
+        // Number of entities a query for the components visits
+        template<typename... Components>
+        uint32_t count() const {
+            uint32_t entityCount = 0;
+            for (const EntityChunk& chunk : findChunks(getMask<Components...>())) {
+                entityCount += chunk.Count;
+            }
+            return entityCount;
+        }
+
+        // Calls function(const EntityChunk&) for every chunk of the archetypes that have all of the components
+        template<typename... Components, typename Function>
+        void forEachChunk(Function&& function) const {
+            for (const EntityChunk& chunk : findChunks(getMask<Components...>())) {
+                function(chunk);
+            }
+        }
+
+        // Like forEachChunk, with the chunks split into jobs. Returns once every chunk has been visited.
+        template<typename... Components>
+        void parallelForEachChunk(const std::function<void(const EntityChunk&)>& function) const {
+            runParallel(findChunks(getMask<Components...>()), function);
+        }
+
+        void clear();
+
+    private:
+        template<typename... Components>
+        static ComponentMask getMask() {
+            return (((ComponentMask) 1 << ComponentType::getId<Components>()) | ... | 0);
+        }
+
+        Archetype* getArchetype(std::vector<ComponentType> componentTypes);
+
+        Entity allocate();
+
+        std::vector<EntityChunk> findChunks(ComponentMask mask) const;
+
+        void runParallel(const std::vector<EntityChunk>& chunks, const std::function<void(const EntityChunk&)>& function) const;
+    };
+
+}
@@ -4,6 +4,8 @@
 	#define VD_PLATFORM_WINDOWS
 #elif defined(__APPLE__) || defined(__MACH__)
     #define VD_PLATFORM_MACOS
+#elif defined(__linux__)
+    #define VD_PLATFORM_LINUX
 #else
 	#error "Unsupported platform"
 #endif
@@ -1,20 +1,36 @@
 #include "FileSystem.h"
 #include "Log.h"
+#include <filesystem>
 #include <fstream>
 
 namespace Vulkandemo {
 
+    bool FileSystem::exists(const char* path) const {
+        std::error_code errorCode;
+        return std::filesystem::exists(path, errorCode);
+    }
+
     std::vector<char> FileSystem::readBytes(const char* path) const {
         std::ifstream file{path, std::ios::ate | std::ios::binary};
         if (!file.is_open()) {
             VD_LOG_ERROR("Could not open file with path [{0}]", path);
             return {};
         }
-        uint32_t fileSize = (uint32_t) file.tellg();
-        std::vector<char> buffer(fileSize);
+        std::streamoff fileSize = file.tellg();
+        if (fileSize < 0) {
+            VD_LOG_ERROR("Could not get size of file with path [{0}]", path);
+            return {};
+        }
+        std::vector<char> buffer((size_t) fileSize);
         file.seekg(0);
         file.read(buffer.data(), fileSize);
         file.close();
         return buffer;
     }
+
+    MappedFile FileSystem::mapFile(const char* path, MappedFile::AccessPattern accessPattern) const {
+        MappedFile mappedFile;
+        mappedFile.open(path, accessPattern);
+        return mappedFile;
+    }
 }
@@ -1,11 +1,17 @@
 #pragma once
 
+#include "MappedFile.h"
+
 #include <vector>
 
 namespace Vulkandemo {
 
     class FileSystem {
     public:
+        bool exists(const char* path) const;
+
         std::vector<char> readBytes(const char* path) const;
+
+        MappedFile mapFile(const char* path, MappedFile::AccessPattern accessPattern = MappedFile::AccessPattern::Sequential) const;
     };
 }
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "SubmissionBenchmark.h"
+#include "TransformHierarchy.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+namespace Vulkandemo {
+
+    // Everything the render thread needs from the simulation: the state after the last step and the one before it to interpolate from. Written by
+    // the simulation thread only before it is published and read by the render thread only after it has been acquired, so neither side locks it.
+    struct FrameSnapshot {
+        // Steps simulated so far, including the one that produced this snapshot
+        uint64_t StepCount = 0;
+        uint64_t DroppedStepCount = 0;
+        double StepSeconds = 0.0;
+        // Real seconds since initialization at which the current state was due. The frame rendered at that time shows the previous state, a
+        // frame rendered one step later the current one.
+        double DueTime = 0.0;
+        // Real seconds the simulation thread spent on steps and snapshots so far
+        double SimulationSeconds = 0.0;
+        glm::mat4 PreviousViewProjection{1.0f};
+        glm::mat4 ViewProjection{1.0f};
+        uint32_t ColorMode = 0;
+        SubmissionMode Submission = SubmissionMode::Instanced;
+        TransformSnapshot PreviousTransforms;
+        TransformSnapshot Transforms;
+    };
+
+}
@@ -0,0 +1,44 @@
+#include "Frustum.h"
+
+namespace Vulkandemo {
+
+    Frustum Frustum::fromViewProjection(const glm::mat4& viewProjection) {
+        // glm matrices are column major, so row i is made of the i-th element of every column
+        auto row = [&viewProjection](int i) {
+            return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+        };
+        Frustum frustum{};
+        frustum.Planes[0] = row(3) + row(0);
+        frustum.Planes[1] = row(3) - row(0);
+        frustum.Planes[2] = row(3) + row(1);
+        frustum.Planes[3] = row(3) - row(1);
+        frustum.Planes[4] = row(2);
+        frustum.Planes[5] = row(3) - row(2);
+        // Normalized so the plane equation gives the signed distance, which is what the sphere radius is compared against
+        for (glm::vec4& plane : frustum.Planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return frustum;
+    }
+
+    bool Frustum::intersectsSphere(const glm::vec3& center, float radius) const {
+        for (const glm::vec4& plane : Planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint32_t BoundingSpheres::getCount() const {
+        return (uint32_t) Radius.size();
+    }
+
+    void BoundingSpheres::add(const glm::vec3& center, float radius) {
+        CenterX.push_back(center.x);
+        CenterY.push_back(center.y);
+        CenterZ.push_back(center.z);
+        Radius.push_back(radius);
+    }
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Vulkandemo {
+
+    // View volume as six inward facing planes (xyz normal, w distance), so a point p is inside when dot(plane.xyz, p) + plane.w >= 0 for every plane
+    struct Frustum {
+        static constexpr int PLANE_COUNT = 6;
+
+        std::array<glm::vec4, PLANE_COUNT> Planes;
+
+        // Extracts the planes of a Vulkan clip space volume (depth from 0 to 1) from the rows of the view-projection matrix
+        static Frustum fromViewProjection(const glm::mat4& viewProjection);
+
+        // Conservative, spheres near the corners of the frustum may pass while being outside
+        bool intersectsSphere(const glm::vec3& center, float radius) const;
+    };
+
+    // Bounding spheres in structure-of-arrays form, so SIMD code loads the same component of consecutive spheres with a single instruction
+    struct BoundingSpheres {
+        std::vector<float> CenterX;
+        std::vector<float> CenterY;
+        std::vector<float> CenterZ;
+        std::vector<float> Radius;
+
+        uint32_t getCount() const;
+
+        void add(const glm::vec3& center, float radius);
+    };
+
+}
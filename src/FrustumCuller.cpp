@@ -0,0 +1,203 @@
+#include "FrustumCuller.h"
+#include "Environment.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define VD_CULLING_X86
+    #include <immintrin.h>
+    #if defined(VD_COMPILER_MSVC)
+        #include <intrin.h>
+        // MSVC compiles intrinsics of any instruction set without target flags
+        #define VD_TARGET_AVX2
+    #else
+        #define VD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #endif
+#endif
+
+namespace Vulkandemo {
+
+    FrustumCuller::FrustumCuller(Config config, JobSystem* jobSystem) : config(config), jobSystem(jobSystem), instructionSet(findInstructionSet()) {
+    }
+
+    uint32_t FrustumCuller::getThreadCount() const {
+        return jobSystem->getThreadCount();
+    }
+
+    FrustumCuller::InstructionSet FrustumCuller::getInstructionSet() const {
+        return instructionSet;
+    }
+
+    uint32_t FrustumCuller::cull(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t* visibleIndices) const {
+        uint32_t count = spheres.getCount();
+        uint32_t rangeCount = std::clamp(count / std::max(config.MinSpheresPerJob, 1u), 1u, jobSystem->getThreadCount());
+        if (rangeCount == 1) {
+            return cullRange(frustum, spheres, 0, count, visibleIndices);
+        }
+
+        // Every range writes its indices where its spheres start, so the jobs never share an output location. Ranges are multiples of 8 spheres
+        // to keep the SIMD loops free of tails except in the last one.
+        uint32_t rangeSize = ((count + rangeCount - 1) / rangeCount + 7) & ~7u;
+        std::vector<uint32_t> rangeVisibleCounts((count + rangeSize - 1) / rangeSize);
+        JobSystem::Counter counter;
+        for (uint32_t range = 1; range < rangeVisibleCounts.size(); range++) {
+            jobSystem->schedule([this, &frustum, &spheres, &rangeVisibleCounts, range, rangeSize, count, visibleIndices]() {
+                uint32_t begin = range * rangeSize;
+                rangeVisibleCounts[range] = cullRange(frustum, spheres, begin, std::min(begin + rangeSize, count), visibleIndices + begin);
+            }, &counter);
+        }
+        uint32_t visibleCount = cullRange(frustum, spheres, 0, std::min(rangeSize, count), visibleIndices);
+        jobSystem->wait(counter);
+        for (uint32_t range = 1; range < rangeVisibleCounts.size(); range++) {
+            std::memmove(visibleIndices + visibleCount, visibleIndices + range * rangeSize, rangeVisibleCounts[range] * sizeof(uint32_t));
+            visibleCount += rangeVisibleCounts[range];
+        }
+        return visibleCount;
+    }
+
+    uint32_t FrustumCuller::cullRange(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visibleIndices) const {
+        switch (instructionSet) {
+            case InstructionSet::AVX2:
+                return cullRangeAvx2(frustum, spheres, begin, end, visibleIndices);
+            case InstructionSet::SSE:
+                return cullRangeSse(frustum, spheres, begin, end, visibleIndices);
+            default:
+                return cullRangeScalar(frustum, spheres, begin, end, visibleIndices);
+        }
+    }
+
+    uint32_t FrustumCuller::cullScalar(const Frustum& frustum, const glm::vec4* spheres, uint32_t count, uint32_t* visibleIndices) {
+        uint32_t visibleCount = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            if (frustum.intersectsSphere(glm::vec3(spheres[i]), spheres[i].w)) {
+                visibleIndices[visibleCount++] = i;
+            }
+        }
+        return visibleCount;
+    }
+
+    const char* FrustumCuller::getInstructionSetAsString(InstructionSet instructionSet) {
+        switch (instructionSet) {
+            case InstructionSet::Scalar:
+                return "Scalar";
+            case InstructionSet::SSE:
+                return "SSE";
+            case InstructionSet::AVX2:
+                return "AVX2";
+            default:
+                return "";
+        }
+    }
+
+    uint32_t FrustumCuller::cullRangeScalar(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visibleIndices) {
+        uint32_t visibleCount = 0;
+        for (uint32_t i = begin; i < end; i++) {
+            // Written unconditionally and kept only when visible, which avoids a hard to predict branch per sphere
+            visibleIndices[visibleCount] = i;
+            visibleCount += frustum.intersectsSphere({spheres.CenterX[i], spheres.CenterY[i], spheres.CenterZ[i]}, spheres.Radius[i]) ? 1 : 0;
+        }
+        return visibleCount;
+    }
+
+#ifdef VD_CULLING_X86
+
+    uint32_t FrustumCuller::cullRangeSse(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visibleIndices) {
+        __m128 planeX[Frustum::PLANE_COUNT];
+        __m128 planeY[Frustum::PLANE_COUNT];
+        __m128 planeZ[Frustum::PLANE_COUNT];
+        __m128 planeW[Frustum::PLANE_COUNT];
+        for (int i = 0; i < Frustum::PLANE_COUNT; i++) {
+            planeX[i] = _mm_set1_ps(frustum.Planes[i].x);
+            planeY[i] = _mm_set1_ps(frustum.Planes[i].y);
+            planeZ[i] = _mm_set1_ps(frustum.Planes[i].z);
+            planeW[i] = _mm_set1_ps(frustum.Planes[i].w);
+        }
+        uint32_t visibleCount = 0;
+        uint32_t index = begin;
+        for (; index + 4 <= end; index += 4) {
+            __m128 x = _mm_loadu_ps(&spheres.CenterX[index]);
+            __m128 y = _mm_loadu_ps(&spheres.CenterY[index]);
+            __m128 z = _mm_loadu_ps(&spheres.CenterZ[index]);
+            __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&spheres.Radius[index]));
+            __m128 inside = _mm_cmpeq_ps(x, x);
+            for (int i = 0; i < Frustum::PLANE_COUNT; i++) {
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, planeX[i]), _mm_mul_ps(y, planeY[i])), _mm_add_ps(_mm_mul_ps(z, planeZ[i]), planeW[i]));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+            }
+            auto mask = (uint32_t) _mm_movemask_ps(inside);
+            for (uint32_t lane = 0; lane < 4; lane++) {
+                visibleIndices[visibleCount] = index + lane;
+                visibleCount += (mask >> lane) & 1;
+            }
+        }
+        return visibleCount + cullRangeScalar(frustum, spheres, index, end, visibleIndices + visibleCount);
+    }
+
+    VD_TARGET_AVX2 uint32_t FrustumCuller::cullRangeAvx2(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visibleIndices) {
+        __m256 planeX[Frustum::PLANE_COUNT];
+        __m256 planeY[Frustum::PLANE_COUNT];
+        __m256 planeZ[Frustum::PLANE_COUNT];
+        __m256 planeW[Frustum::PLANE_COUNT];
+        for (int i = 0; i < Frustum::PLANE_COUNT; i++) {
+            planeX[i] = _mm256_set1_ps(frustum.Planes[i].x);
+            planeY[i] = _mm256_set1_ps(frustum.Planes[i].y);
+            planeZ[i] = _mm256_set1_ps(frustum.Planes[i].z);
+            planeW[i] = _mm256_set1_ps(frustum.Planes[i].w);
+        }
+        uint32_t visibleCount = 0;
+        uint32_t index = begin;
+        for (; index + 8 <= end; index += 8) {
+            __m256 x = _mm256_loadu_ps(&spheres.CenterX[index]);
+            __m256 y = _mm256_loadu_ps(&spheres.CenterY[index]);
+            __m256 z = _mm256_loadu_ps(&spheres.CenterZ[index]);
+            __m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&spheres.Radius[index]));
+            __m256 inside = _mm256_cmp_ps(x, x, _CMP_EQ_OQ);
+            for (int i = 0; i < Frustum::PLANE_COUNT; i++) {
+                __m256 distance = _mm256_fmadd_ps(x, planeX[i], _mm256_fmadd_ps(y, planeY[i], _mm256_fmadd_ps(z, planeZ[i], planeW[i])));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+            }
+            auto mask = (uint32_t) _mm256_movemask_ps(inside);
+            for (uint32_t lane = 0; lane < 8; lane++) {
+                visibleIndices[visibleCount] = index + lane;
+                visibleCount += (mask >> lane) & 1;
+            }
+        }
+        return visibleCount + cullRangeSse(frustum, spheres, index, end, visibleIndices + visibleCount);
+    }
+
+    FrustumCuller::InstructionSet FrustumCuller::findInstructionSet() {
+#if defined(VD_COMPILER_MSVC)
+        // AVX2 and FMA need support by the processor (CPUID) and saving of the YMM registers by the OS (XGETBV)
+        int info[4];
+        __cpuid(info, 1);
+        bool fma = (info[2] & (1 << 12)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool ymmSaved = osxsave && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        bool avx2 = (info[1] & (1 << 5)) != 0;
+        return avx2 && fma && ymmSaved ? InstructionSet::AVX2 : InstructionSet::SSE;
+#else
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ? InstructionSet::AVX2 : InstructionSet::SSE;
+#endif
+    }
+
+#else
+
+    // SSE2 is part of x86-64, other architectures use the scalar loop
+    uint32_t FrustumCuller::cullRangeSse(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visibleIndices) {
+        return cullRangeScalar(frustum, spheres, begin, end, visibleIndices);
+    }
+
+    uint32_t FrustumCuller::cullRangeAvx2(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visibleIndices) {
+        return cullRangeScalar(frustum, spheres, begin, end, visibleIndices);
+    }
+
+    FrustumCuller::InstructionSet FrustumCuller::findInstructionSet() {
+        return InstructionSet::Scalar;
+    }
+
+#endif
+
+}
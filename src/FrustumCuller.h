@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Frustum.h"
+#include "JobSystem.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+namespace Vulkandemo {
+
+    // Frustum culling on the CPU, for devices that cannot cull in a compute shader. Spheres are tested 8 at a time with AVX2 when the processor
+    // supports it and 4 at a time with SSE otherwise, and large sets are split into jobs. The result is a compact list of the indices of the visible
+    // spheres in ascending order.
+    class FrustumCuller {
+    public:
+        struct Config {
+            // Smaller ranges are not worth handing to another thread
+            uint32_t MinSpheresPerJob = 16384;
+        };
+
+        enum class InstructionSet {
+            Scalar = 0,
+            SSE,
+            AVX2
+        };
+
+    private:
+        Config config;
+        JobSystem* jobSystem;
+        InstructionSet instructionSet;
+
+    public:
+        FrustumCuller(Config config, JobSystem* jobSystem);
+
+        uint32_t getThreadCount() const;
+
+        InstructionSet getInstructionSet() const;
+
+        // Splits the spheres into jobs. visibleIndices must have room for every sphere, returns the number of visible ones.
+        uint32_t cull(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t* visibleIndices) const;
+
+        // Tests the spheres [begin, end) on the calling thread. visibleIndices must have room for end - begin indices, returns the number of visible ones.
+        uint32_t cullRange(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visibleIndices) const;
+
+        // One sphere (xyz center, w radius) at a time, the baseline the SIMD paths are measured against
+        static uint32_t cullScalar(const Frustum& frustum, const glm::vec4* spheres, uint32_t count, uint32_t* visibleIndices);
+
+        static const char* getInstructionSetAsString(InstructionSet instructionSet);
+
+    private:
+        static uint32_t cullRangeScalar(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visibleIndices);
+
+        static uint32_t cullRangeSse(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visibleIndices);
+
+        static uint32_t cullRangeAvx2(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visibleIndices);
+
+        static InstructionSet findInstructionSet();
+    };
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace Vulkandemo {
+
+    // 64-bit FNV-1a, stable across runs so hashes can also be used as keys of data persisted to disk
+    constexpr uint64_t HASH_SEED = 14695981039346656037ull;
+
+    inline uint64_t hashBytes(const void* data, size_t size, uint64_t hash = HASH_SEED) {
+        const auto* bytes = (const uint8_t*) data;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // Only for values without padding bytes, e.g. integers and enums
+    template<typename T>
+    uint64_t hashValue(const T& value, uint64_t hash = HASH_SEED) {
+        static_assert(std::has_unique_object_representations_v<T>, "Value must not contain padding bytes");
+        return hashBytes(&value, sizeof(T), hash);
+    }
+
+}
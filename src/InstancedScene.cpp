@@ -0,0 +1,227 @@
+#include "InstancedScene.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Vulkandemo {
+
+    InstancedScene::InstancedScene(Config config, JobSystem* jobSystem) : config(config), entities(config.Entities, jobSystem), transforms(config.Transforms, jobSystem) {
+    }
+
+    bool InstancedScene::initialize() {
+        if (config.InstanceCount == 0) {
+            VD_LOG_ERROR("Could not create instanced scene without instances");
+            return false;
+        }
+
+        // Clockwise in framebuffer coordinates (y pointing down), see GraphicsPipelineDescription::FrontFace
+        addMesh({
+                {{0.0f, -0.5f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f, 1.0f}},
+                {{0.5f, 0.5f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f, 1.0f}},
+                {{-0.5f, 0.5f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f, 1.0f}}
+        }, {0, 1, 2});
+        addMesh({
+                {{-0.5f, -0.5f, 0.0f, 1.0f}, {1.0f, 1.0f, 0.0f, 1.0f}},
+                {{0.5f, -0.5f, 0.0f, 1.0f}, {0.0f, 1.0f, 1.0f, 1.0f}},
+                {{0.5f, 0.5f, 0.0f, 1.0f}, {1.0f, 0.0f, 1.0f, 1.0f}},
+                {{-0.5f, 0.5f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}}
+        }, {0, 1, 2, 2, 3, 0});
+        std::vector<Vertex> hexagonVertices = {{{0.0f, 0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}}};
+        std::vector<uint32_t> hexagonIndices;
+        for (uint32_t i = 0; i < 6; i++) {
+            float angle = (float) i * 6.2832f / 6.0f;
+            hexagonVertices.push_back({{0.5f * std::cos(angle), 0.5f * std::sin(angle), 0.0f, 1.0f}, {0.5f + 0.5f * std::cos(angle), 0.5f + 0.5f * std::sin(angle), 0.5f, 1.0f}});
+            hexagonIndices.insert(hexagonIndices.end(), {0, i + 1, (i + 1) % 6 + 1});
+        }
+        addMesh(hexagonVertices, hexagonIndices);
+
+        // Instances are sorted by mesh, so every mesh is drawn by one instanced draw
+        uint32_t meshCount = std::clamp(config.MeshCount, 1u, (uint32_t) meshes.size());
+        for (uint32_t meshIndex = 0; meshIndex < meshCount; meshIndex++) {
+            uint32_t firstInstance = (uint32_t) ((uint64_t) config.InstanceCount * meshIndex / meshCount);
+            uint32_t endInstance = (uint32_t) ((uint64_t) config.InstanceCount * (meshIndex + 1) / meshCount);
+            if (endInstance > firstInstance) {
+                batches.push_back({meshIndex, firstInstance, endInstance - firstInstance});
+            }
+        }
+
+        auto columnCount = (uint32_t) std::ceil(std::sqrt((double) config.InstanceCount));
+        uint32_t rowCount = (config.InstanceCount + columnCount - 1) / columnCount;
+        float cellWidth = 2.0f / (float) columnCount;
+        float cellHeight = 2.0f / (float) rowCount;
+
+        rootTransform = transforms.add({});
+        for (const InstanceBatch& batch : batches) {
+            for (uint32_t i = batch.FirstInstance; i < batch.FirstInstance + batch.InstanceCount; i++) {
+                uint32_t column = i % columnCount;
+                uint32_t row = i / columnCount;
+                Transform transform;
+                transform.Position = glm::vec2(-1.0f + cellWidth * ((float) column + 0.5f), -1.0f + cellHeight * ((float) row + 0.5f));
+                transform.Scale = config.InstanceCount == 1 ? 1.0f : std::min(cellWidth, cellHeight) * 0.9f;
+                transform.Rotation = config.InstanceCount == 1 ? 0.0f : (float) i * 0.1f;
+                // Golden ratio steps spread the animated instances evenly over the grid
+                float animatedRank = (float) i * 0.618034f - std::floor((float) i * 0.618034f);
+                Spin spin{transform.Rotation, animatedRank < config.AnimatedFraction ? config.RotationSpeed : 0.0f};
+                // Tint varies across the grid so individual instances can be told apart
+                float hue = (float) i / (float) config.InstanceCount;
+                Tint tint{config.InstanceCount == 1 ? glm::vec4(1.0f) : glm::vec4(0.5f + 0.5f * std::cos(6.2832f * hue), 0.5f + 0.5f * std::cos(6.2832f * (hue + 0.33f)), 0.5f + 0.5f * std::cos(6.2832f * (hue + 0.67f)), 1.0f)};
+                entities.create(TransformNode{transforms.add(transform, rootTransform)}, spin, tint, Renderable{batch.MeshIndex});
+            }
+        }
+        transforms.update();
+
+        cullingObjects.reserve(config.InstanceCount);
+        entities.forEachChunk<TransformNode, Renderable>([this](const EntityChunk& chunk) {
+            const TransformNode* transformNodes = chunk.get<TransformNode>();
+            const Renderable* renderables = chunk.get<Renderable>();
+            for (uint32_t i = 0; i < chunk.Count; i++) {
+                const Mesh& mesh = meshes[renderables[i].MeshIndex];
+                const glm::mat4& world = transforms.getWorldMatrix(transformNodes[i].Node);
+                float scale = std::sqrt(world[0].x * world[0].x + world[0].y * world[0].y + world[0].z * world[0].z);
+                cullingObjects.push_back({mesh.IndexCount, mesh.FirstIndex, mesh.VertexOffset, mesh.BoundingRadius});
+                boundingSpheres.add(glm::vec3(world[3]), mesh.BoundingRadius * scale);
+            }
+        });
+        VD_LOG_INFO("Created instanced scene with [{}] instances of [{}] meshes in [{}] x [{}] grid", config.InstanceCount, batches.size(), columnCount, rowCount);
+        return true;
+    }
+
+    void InstancedScene::terminate() {
+        vertices.clear();
+        indices.clear();
+        meshes.clear();
+        batches.clear();
+        entities.clear();
+        transforms.clear();
+        rootTransform = TransformHierarchy::NO_PARENT;
+        cullingObjects.clear();
+        boundingSpheres = {};
+    }
+
+    uint32_t InstancedScene::getInstanceCount() const {
+        return entities.getEntityCount();
+    }
+
+    const std::vector<Vertex>& InstancedScene::getVertices() const {
+        return vertices;
+    }
+
+    const std::vector<uint32_t>& InstancedScene::getIndices() const {
+        return indices;
+    }
+
+    const std::vector<Mesh>& InstancedScene::getMeshes() const {
+        return meshes;
+    }
+
+    const std::vector<InstanceBatch>& InstancedScene::getBatches() const {
+        return batches;
+    }
+
+    const EntityStore& InstancedScene::getEntities() const {
+        return entities;
+    }
+
+    uint32_t InstancedScene::getTransformCount() const {
+        return transforms.getNodeCount();
+    }
+
+    void InstancedScene::writeInstances(InstanceData* output) const {
+        entities.forEachChunk<TransformNode, Tint>([output](const EntityChunk& chunk) {
+            const TransformNode* transformNodes = chunk.get<TransformNode>();
+            const Tint* tints = chunk.get<Tint>();
+            InstanceData* chunkOutput = output + chunk.FirstIndex;
+            for (uint32_t i = 0; i < chunk.Count; i++) {
+                chunkOutput[i] = {transformNodes[i].Node, {}, tints[i].Color};
+            }
+        });
+    }
+
+    void InstancedScene::update(float time) {
+        entities.parallelForEachChunk<TransformNode, Spin>([this, time](const EntityChunk& chunk) {
+            const TransformNode* transformNodes = chunk.get<TransformNode>();
+            const Spin* spins = chunk.get<Spin>();
+            for (uint32_t i = 0; i < chunk.Count; i++) {
+                if (spins[i].Speed == 0.0f) {
+                    continue;
+                }
+                Transform transform = transforms.getLocalTransform(transformNodes[i].Node);
+                transform.Rotation = spins[i].Rotation + time * spins[i].Speed;
+                transforms.setLocalTransform(transformNodes[i].Node, transform);
+            }
+        });
+        transforms.update();
+    }
+
+    void InstancedScene::writeTransformSnapshot(TransformSnapshot& snapshot) const {
+        transforms.writeSnapshot(snapshot);
+    }
+
+    uint32_t InstancedScene::writeTransforms(const TransformSnapshot& previous, const TransformSnapshot& current, float alpha, glm::mat4* output, uint64_t sinceVersion) const {
+        return transforms.writeWorldMatrices(previous, current, alpha, output, sinceVersion);
+    }
+
+    glm::mat4 InstancedScene::getViewProjection(float time) const {
+        float zoom = std::max(config.CameraZoom, 1.0f);
+        // Keeps the view inside the grid
+        float panRadius = 1.0f - 1.0f / zoom;
+        glm::vec2 center(panRadius * std::cos(time * 0.2f), panRadius * std::sin(time * 0.2f));
+        glm::mat4 viewProjection(1.0f);
+        viewProjection[0][0] = zoom;
+        viewProjection[1][1] = zoom;
+        viewProjection[2][2] = 0.5f;
+        viewProjection[3] = glm::vec4(-center.x * zoom, -center.y * zoom, 0.5f, 1.0f);
+        return viewProjection;
+    }
+
+    const std::vector<CullingObject>& InstancedScene::getCullingObjects() const {
+        return cullingObjects;
+    }
+
+    const BoundingSpheres& InstancedScene::getBoundingSpheres() const {
+        return boundingSpheres;
+    }
+
+    uint32_t InstancedScene::writeDrawCommands(VkDrawIndexedIndirectCommand* commands) const {
+        uint32_t commandCount = 0;
+        entities.forEachChunk<Renderable>([this, commands, &commandCount](const EntityChunk& chunk) {
+            const Renderable* renderables = chunk.get<Renderable>();
+            for (uint32_t i = 0; i < chunk.Count; i++) {
+                const Mesh& mesh = meshes[renderables[i].MeshIndex];
+                VkDrawIndexedIndirectCommand& command = commands[commandCount++];
+                command.indexCount = mesh.IndexCount;
+                command.instanceCount = 1;
+                command.firstIndex = mesh.FirstIndex;
+                command.vertexOffset = mesh.VertexOffset;
+                command.firstInstance = chunk.FirstIndex + i;
+            }
+        });
+        return commandCount;
+    }
+
+    uint32_t InstancedScene::writeDrawCommands(const uint32_t* instanceIndices, uint32_t instanceCount, VkDrawIndexedIndirectCommand* commands) const {
+        for (uint32_t i = 0; i < instanceCount; i++) {
+            uint32_t instanceIndex = instanceIndices[i];
+            const CullingObject& object = cullingObjects[instanceIndex];
+            VkDrawIndexedIndirectCommand& command = commands[i];
+            command.indexCount = object.IndexCount;
+            command.instanceCount = 1;
+            command.firstIndex = object.FirstIndex;
+            command.vertexOffset = object.VertexOffset;
+            command.firstInstance = instanceIndex;
+        }
+        return instanceCount;
+    }
+
+    void InstancedScene::addMesh(const std::vector<Vertex>& meshVertices, const std::vector<uint32_t>& meshIndices) {
+        float boundingRadius = 0.0f;
+        for (const Vertex& vertex : meshVertices) {
+            boundingRadius = std::max(boundingRadius, std::sqrt(vertex.Position.x * vertex.Position.x + vertex.Position.y * vertex.Position.y));
+        }
+        meshes.push_back({(uint32_t) indices.size(), (uint32_t) meshIndices.size(), (int32_t) vertices.size(), boundingRadius});
+        vertices.insert(vertices.end(), meshVertices.begin(), meshVertices.end());
+        indices.insert(indices.end(), meshIndices.begin(), meshIndices.end());
+    }
+
+}
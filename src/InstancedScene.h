@@ -0,0 +1,162 @@
+#pragma once
+
+#include "Frustum.h"
+#include "EntityStore.h"
+#include "TransformHierarchy.h"
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace Vulkandemo {
+
+    // Matches the std430 layout of the Vertex struct in simple_shader.vert, which reads vertices from a storage buffer instead of vertex input
+    struct Vertex {
+        glm::vec4 Position;
+        glm::vec4 Color;
+    };
+
+    // Matches the std430 layout of the Instance struct in simple_shader.vert and cull.comp, the world matrix comes from the transform buffer
+    struct InstanceData {
+        uint32_t TransformIndex;
+        uint32_t Padding[3];
+        glm::vec4 Color;
+    };
+
+    // Components of the scene's entities
+    struct TransformNode {
+        uint32_t Node;
+    };
+
+    // Rotation of an instance around its own origin
+    struct Spin {
+        float Rotation;
+        // Radians per second, 0 for instances that stay still
+        float Speed;
+    };
+
+    struct Tint {
+        glm::vec4 Color;
+    };
+
+    struct Renderable {
+        uint32_t MeshIndex;
+    };
+
+    // Range of the scene's shared index and vertex arrays
+    struct Mesh {
+        uint32_t FirstIndex;
+        uint32_t IndexCount;
+        int32_t VertexOffset;
+        // Around the mesh origin, at scale 1
+        float BoundingRadius;
+    };
+
+    // Matches the std430 layout of the Object struct in cull.comp, the part of an instance that does not change from frame to frame
+    struct CullingObject {
+        uint32_t IndexCount;
+        uint32_t FirstIndex;
+        int32_t VertexOffset;
+        float BoundingRadius;
+    };
+
+    // Consecutive instances of the same mesh
+    struct InstanceBatch {
+        uint32_t MeshIndex;
+        uint32_t FirstInstance;
+        uint32_t InstanceCount;
+    };
+
+}
+
+namespace Vulkandemo {
+
+    // Copies of a few meshes laid out in a grid covering the viewport. A single instance covers the whole grid, so the default scene looks like one
+    // plain draw. Every instance is a child of the scene root in a transform hierarchy, and only the world matrices of rotating instances are
+    // recomputed and uploaded each frame.
+    class InstancedScene {
+    public:
+        struct Config {
+            uint32_t InstanceCount = 1;
+            // Number of different meshes (at most 3) the instances are split into
+            uint32_t MeshCount = 1;
+            // Radians per second
+            float RotationSpeed = 0.0f;
+            // Above 1 the camera shows part of the grid and circles over it, so objects move in and out of view
+            float CameraZoom = 1.0f;
+            // Share of the instances that rotate, the transforms of the others are not touched after the first frame
+            float AnimatedFraction = 1.0f;
+            EntityStore::Config Entities;
+            TransformHierarchy::Config Transforms;
+        };
+
+    private:
+        Config config;
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<Mesh> meshes;
+        std::vector<InstanceBatch> batches;
+        // Created in mesh order and never destroyed, so the query order of an entity is its instance index
+        EntityStore entities;
+        TransformHierarchy transforms;
+        uint32_t rootTransform = TransformHierarchy::NO_PARENT;
+        std::vector<CullingObject> cullingObjects;
+        BoundingSpheres boundingSpheres;
+
+    public:
+        InstancedScene(Config config, JobSystem* jobSystem);
+
+        bool initialize();
+
+        void terminate();
+
+        uint32_t getInstanceCount() const;
+
+        const std::vector<Vertex>& getVertices() const;
+
+        const std::vector<uint32_t>& getIndices() const;
+
+        const std::vector<Mesh>& getMeshes() const;
+
+        const std::vector<InstanceBatch>& getBatches() const;
+
+        const EntityStore& getEntities() const;
+
+        // One transform per instance plus the scene root
+        uint32_t getTransformCount() const;
+
+        // Writes the instances in instance order, they do not change after initialization
+        void writeInstances(InstanceData* output) const;
+
+        // Animates the instances to the given time in seconds and updates the world matrices of those that moved
+        void update(float time);
+
+        // Brings the snapshot up to date with the world matrices of the last update
+        void writeTransformSnapshot(TransformSnapshot& snapshot) const;
+
+        // Writes the world matrices that changed after the given transform version to output[transformIndex], blended from the previous to the
+        // current snapshot by alpha, and returns the number written. Safe to call while another thread updates the scene.
+        uint32_t writeTransforms(const TransformSnapshot& previous, const TransformSnapshot& current, float alpha, glm::mat4* output, uint64_t sinceVersion) const;
+
+        // Orthographic camera over the grid at the given time in seconds, the grid at z = 0 lands in the middle of the depth range
+        glm::mat4 getViewProjection(float time) const;
+
+        // One object per instance, in instance order
+        const std::vector<CullingObject>& getCullingObjects() const;
+
+        // One sphere per instance, in instance order. Instances only rotate around their own origin, so the spheres do not change.
+        const BoundingSpheres& getBoundingSpheres() const;
+
+        // Writes the draw list, one command per instance with the instance index as firstInstance, and returns the number of commands
+        uint32_t writeDrawCommands(VkDrawIndexedIndirectCommand* commands) const;
+
+        // Writes the draw commands of the given instances only, e.g. the visible ones, and returns the number of commands
+        uint32_t writeDrawCommands(const uint32_t* instanceIndices, uint32_t instanceCount, VkDrawIndexedIndirectCommand* commands) const;
+
+    private:
+        void addMesh(const std::vector<Vertex>& meshVertices, const std::vector<uint32_t>& meshIndices);
+    };
+
+}
@@ -0,0 +1,381 @@
+#include "JobSystem.h"
+#include "Assert.h"
+#include "Environment.h"
+#include "Log.h"
+
+#include <algorithm>
+
+#if defined(VD_PLATFORM_LINUX)
+    #include <pthread.h>
+    #include <sched.h>
+#elif defined(VD_PLATFORM_WINDOWS)
+    #include <windows.h>
+#endif
+
+namespace Vulkandemo {
+
+    thread_local JobSystem::Worker* JobSystem::currentWorker = nullptr;
+    thread_local const JobSystem* JobSystem::currentJobSystem = nullptr;
+
+    bool JobSystem::Counter::isDone() const {
+        return count.load(std::memory_order_acquire) == 0;
+    }
+
+    JobSystem::Worker::Worker(uint32_t index, uint32_t dequeCapacity) : Index(index), Deque(dequeCapacity) {
+    }
+
+    JobSystem::JobSystem(Config config) : config(config) {
+    }
+
+    JobSystem::~JobSystem() {
+        // Worker threads must be joined even if the app bailed out before calling terminate
+        if (running) {
+            terminate();
+        }
+    }
+
+    bool JobSystem::initialize() {
+        uint32_t workerCount = config.WorkerCount;
+        if (workerCount == 0) {
+            workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        }
+        workerThreadCount = workerCount;
+        statisticsStartTime = std::chrono::steady_clock::now();
+        running = true;
+        for (uint32_t i = 0; i < workerCount + config.MaxRegisteredThreadCount; i++) {
+            workers.push_back(std::make_unique<Worker>(i, config.DequeCapacity));
+        }
+        // Workers steal from each other as soon as they start, so every worker exists before the first one runs
+        for (uint32_t i = 0; i < workerCount; i++) {
+            Worker* worker = workers[i].get();
+            worker->Thread = std::thread(&JobSystem::runWorker, this, worker);
+            // Core 0 is left to the main thread
+            uint32_t core = (i + 1) % std::max(std::thread::hardware_concurrency(), 1u);
+            if (config.PinWorkers && !pinThread(worker->Thread, core)) {
+                VD_LOG_WARN("Could not pin job worker [{}] to core [{}]", i, core);
+            }
+        }
+        VD_LOG_INFO("Initialized job system with [{}] workers{}", workerCount, config.PinWorkers ? " pinned to cores" : "");
+        return true;
+    }
+
+    void JobSystem::terminate() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            running = false;
+        }
+        sleepCondition.notify_all();
+        for (uint32_t i = 0; i < workerThreadCount; i++) {
+            workers[i]->Thread.join();
+        }
+        // Jobs nobody got to still run, so that their counters reach zero
+        Worker* worker = getCurrentWorker();
+        while (Job* job = findJob(worker)) {
+            execute(worker, job);
+        }
+        while (Job* job = findBackgroundJob(worker)) {
+            execute(worker, job);
+        }
+        logStatistics();
+        if (currentJobSystem == this) {
+            currentWorker = nullptr;
+            currentJobSystem = nullptr;
+        }
+        workers.clear();
+        workerThreadCount = 0;
+        VD_LOG_INFO("Terminated job system");
+    }
+
+    bool JobSystem::registerThread() {
+        VD_ASSERT(getCurrentWorker() == nullptr);
+        for (uint32_t i = workerThreadCount; i < workers.size(); i++) {
+            Worker* worker = workers[i].get();
+            if (!worker->Registered.exchange(true, std::memory_order_acq_rel)) {
+                currentWorker = worker;
+                currentJobSystem = this;
+                return true;
+            }
+        }
+        VD_LOG_WARN("Could not register thread with job system, all [{}] slots are taken", config.MaxRegisteredThreadCount);
+        return false;
+    }
+
+    void JobSystem::unregisterThread() {
+        Worker* worker = getCurrentWorker();
+        if (worker == nullptr) {
+            return;
+        }
+        // Thieves may still take some of them, but nothing is left behind for the next thread using the slot
+        while (Job* job = worker->Deque.pop()) {
+            queuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+            execute(worker, job);
+        }
+        currentWorker = nullptr;
+        currentJobSystem = nullptr;
+        worker->Registered.store(false, std::memory_order_release);
+    }
+
+    uint32_t JobSystem::getThreadCount() const {
+        return running ? workerThreadCount + 1 : 1;
+    }
+
+    void JobSystem::schedule(std::function<void()> function, Counter* counter) {
+        if (counter != nullptr) {
+            counter->count.fetch_add(1, std::memory_order_relaxed);
+        }
+        enqueue(new Job{std::move(function), counter});
+    }
+
+    void JobSystem::schedule(std::function<void()> function, Counter* counter, Counter& dependency) {
+        if (counter != nullptr) {
+            counter->count.fetch_add(1, std::memory_order_relaxed);
+        }
+        auto* job = new Job{std::move(function), counter};
+        {
+            // The thread that brings the dependency to zero takes its waiting jobs under the same lock, so the job is either seen here as ready or
+            // picked up there
+            std::lock_guard<std::mutex> lock(dependency.mutex);
+            if (dependency.count.load(std::memory_order_acquire) > 0) {
+                dependency.waitingJobs.push_back(job);
+                return;
+            }
+        }
+        enqueue(job);
+    }
+
+    void JobSystem::scheduleBackground(std::function<void()> function, Counter* counter) {
+        if (counter != nullptr) {
+            counter->count.fetch_add(1, std::memory_order_relaxed);
+        }
+        auto* job = new Job{std::move(function), counter};
+        if (!running) {
+            execute(nullptr, job);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(sharedMutex);
+            backgroundJobs.push_back(job);
+        }
+        notify();
+    }
+
+    void JobSystem::wait(const Counter& counter) {
+        Worker* worker = getCurrentWorker();
+        while (!counter.isDone()) {
+            if (Job* job = findJob(worker)) {
+                execute(worker, job);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        std::lock_guard<std::mutex> lock(counter.mutex);
+    }
+
+    void JobSystem::parallelFor(uint32_t begin, uint32_t end, uint32_t minRangeSize, const std::function<void(uint32_t, uint32_t)>& function) {
+        if (begin >= end) {
+            return;
+        }
+        // A few ranges per thread, so threads that finish early steal from the ones that got slower ranges
+        uint32_t count = end - begin;
+        uint32_t rangeCount = std::clamp(count / std::max(minRangeSize, 1u), 1u, getThreadCount() * 4);
+        if (rangeCount == 1 || !running) {
+            function(begin, end);
+            return;
+        }
+        uint32_t rangeSize = (count + rangeCount - 1) / rangeCount;
+        Counter counter;
+        for (uint32_t rangeBegin = begin + rangeSize; rangeBegin < end; rangeBegin += rangeSize) {
+            uint32_t rangeEnd = std::min(rangeBegin + rangeSize, end);
+            schedule([&function, rangeBegin, rangeEnd]() {
+                function(rangeBegin, rangeEnd);
+            }, &counter);
+        }
+        function(begin, begin + rangeSize);
+        wait(counter);
+    }
+
+    std::vector<JobSystem::WorkerStatistics> JobSystem::getStatistics() const {
+        double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - statisticsStartTime).count();
+        std::vector<WorkerStatistics> statistics;
+        for (const std::unique_ptr<Worker>& worker : workers) {
+            WorkerStatistics workerStatistics;
+            workerStatistics.JobCount = worker->JobCount.load(std::memory_order_relaxed);
+            workerStatistics.StolenJobCount = worker->StolenJobCount.load(std::memory_order_relaxed);
+            workerStatistics.BusySeconds = (double) worker->BusyNanoseconds.load(std::memory_order_relaxed) / 1e9;
+            workerStatistics.Utilization = elapsedSeconds > 0.0 ? workerStatistics.BusySeconds / elapsedSeconds : 0.0;
+            statistics.push_back(workerStatistics);
+        }
+        return statistics;
+    }
+
+    void JobSystem::resetStatistics() {
+        for (const std::unique_ptr<Worker>& worker : workers) {
+            worker->JobCount = 0;
+            worker->StolenJobCount = 0;
+            worker->BusyNanoseconds = 0;
+        }
+        statisticsStartTime = std::chrono::steady_clock::now();
+    }
+
+    void JobSystem::logStatistics() const {
+        std::vector<WorkerStatistics> statistics = getStatistics();
+        for (uint32_t i = 0; i < statistics.size(); i++) {
+            const WorkerStatistics& workerStatistics = statistics[i];
+            if (i >= workerThreadCount && workerStatistics.JobCount == 0) {
+                continue;
+            }
+            VD_LOG_INFO("Job {} [{}] ran [{}] jobs ([{}] stolen) in [{:.2f}] ms, [{:.1f}]% utilization", i < workerThreadCount ? "worker" : "thread", i, workerStatistics.JobCount, workerStatistics.StolenJobCount, workerStatistics.BusySeconds * 1000.0, workerStatistics.Utilization * 100.0);
+        }
+    }
+
+    void JobSystem::runWorker(Worker* worker) {
+        currentWorker = worker;
+        currentJobSystem = this;
+        uint32_t failedAttempts = 0;
+        while (running.load(std::memory_order_acquire)) {
+            Job* job = findJob(worker);
+            if (job == nullptr) {
+                job = findBackgroundJob(worker);
+            }
+            if (job != nullptr) {
+                execute(worker, job);
+                failedAttempts = 0;
+                continue;
+            }
+            if (++failedAttempts < config.SpinCount) {
+                std::this_thread::yield();
+                continue;
+            }
+            // Schedulers only notify when somebody sleeps, the timeout covers a job queued between the check and the wait
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepingWorkerCount++;
+            sleepCondition.wait_for(lock, std::chrono::milliseconds(1), [this]() {
+                return !running || queuedJobCount.load(std::memory_order_acquire) > 0;
+            });
+            sleepingWorkerCount--;
+            failedAttempts = 0;
+        }
+    }
+
+    void JobSystem::enqueue(Job* job) {
+        if (!running) {
+            // Not initialized (or terminated), run it right away
+            execute(nullptr, job);
+            return;
+        }
+        Worker* worker = getCurrentWorker();
+        if (worker != nullptr) {
+            if (!worker->Deque.push(job)) {
+                execute(worker, job);
+                return;
+            }
+        } else {
+            std::lock_guard<std::mutex> lock(sharedMutex);
+            sharedJobs.push_back(job);
+        }
+        notify();
+    }
+
+    void JobSystem::notify() {
+        queuedJobCount.fetch_add(1, std::memory_order_release);
+        if (sleepingWorkerCount.load(std::memory_order_acquire) > 0) {
+            sleepCondition.notify_one();
+        }
+    }
+
+    JobSystem::Job* JobSystem::findJob(Worker* worker) {
+        Job* job = worker != nullptr ? worker->Deque.pop() : nullptr;
+        bool stolen = job == nullptr;
+        if (job == nullptr) {
+            std::lock_guard<std::mutex> lock(sharedMutex);
+            if (!sharedJobs.empty()) {
+                job = sharedJobs.front();
+                sharedJobs.pop_front();
+            }
+        }
+        // Victims are tried starting after the thief, so thieves spread over the workers instead of all hitting worker 0
+        auto workerCount = (uint32_t) workers.size();
+        uint32_t firstVictim = worker != nullptr ? worker->Index + 1 : 0;
+        for (uint32_t i = 0; job == nullptr && i < workerCount; i++) {
+            Worker* victim = workers[(firstVictim + i) % workerCount].get();
+            if (victim != worker) {
+                job = victim->Deque.steal();
+            }
+        }
+        if (job == nullptr) {
+            return nullptr;
+        }
+        queuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+        if (stolen && worker != nullptr) {
+            worker->StolenJobCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    JobSystem::Job* JobSystem::findBackgroundJob(Worker* worker) {
+        Job* job;
+        {
+            std::lock_guard<std::mutex> lock(sharedMutex);
+            if (backgroundJobs.empty()) {
+                return nullptr;
+            }
+            job = backgroundJobs.front();
+            backgroundJobs.pop_front();
+        }
+        queuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+        if (worker != nullptr) {
+            worker->StolenJobCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    void JobSystem::execute(Worker* worker, Job* job) {
+        auto startTime = std::chrono::steady_clock::now();
+        job->Function();
+        if (worker != nullptr) {
+            auto busyNanoseconds = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+            worker->BusyNanoseconds.fetch_add(busyNanoseconds, std::memory_order_relaxed);
+            worker->JobCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        Counter* counter = job->JobCounter;
+        delete job;
+        finish(counter);
+    }
+
+    void JobSystem::finish(Counter* counter) {
+        if (counter == nullptr) {
+            return;
+        }
+        // Decremented under the lock, so a thread that saw the counter reach zero and then took the lock knows the counter is no longer touched
+        // here and may destroy it
+        std::vector<Job*> readyJobs;
+        {
+            std::lock_guard<std::mutex> lock(counter->mutex);
+            if (counter->count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                readyJobs.swap(counter->waitingJobs);
+            }
+        }
+        for (Job* readyJob : readyJobs) {
+            enqueue(readyJob);
+        }
+    }
+
+    JobSystem::Worker* JobSystem::getCurrentWorker() const {
+        return currentJobSystem == this ? currentWorker : nullptr;
+    }
+
+    bool JobSystem::pinThread(std::thread& thread, uint32_t core) {
+#if defined(VD_PLATFORM_LINUX)
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(core, &cpuSet);
+        return pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuSet) == 0;
+#elif defined(VD_PLATFORM_WINDOWS)
+        return SetThreadAffinityMask((HANDLE) thread.native_handle(), (DWORD_PTR) 1 << core) != 0;
+#else
+        // macOS only supports affinity hints between threads, not pinning to cores
+        return false;
+#endif
+    }
+
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "WorkStealingDeque.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Vulkandemo {
+
+    // Runs small jobs on a pool of workers, each with its own work-stealing deque. Jobs scheduled by a worker go to its own deque, workers that run
+    // out of jobs steal from the others. Threads that schedule a lot (e.g. the simulation and render threads) register to get a deque as well, they
+    // only run jobs while they wait for a counter, so waiting never blocks a core. Other threads may schedule and wait too, their jobs go through a
+    // shared queue.
+    // Long or blocking jobs are scheduled in the background instead, only workers run those, so a thread waiting for a counter never picks one up.
+    class JobSystem {
+    public:
+        struct Config {
+            // 0 uses one worker per hardware thread, minus one for the main thread
+            uint32_t WorkerCount = 0;
+            // Pins worker i to core i + 1 (Linux and Windows only), registered threads are not pinned
+            bool PinWorkers = false;
+            // Threads that may be registered at the same time
+            uint32_t MaxRegisteredThreadCount = 4;
+            // Per worker, jobs that do not fit run right away on the scheduling thread. Must be a power of two.
+            uint32_t DequeCapacity = 4096;
+            // Failed attempts to find a job before an idle worker goes to sleep
+            uint32_t SpinCount = 256;
+        };
+
+        struct WorkerStatistics {
+            uint64_t JobCount = 0;
+            // Jobs taken from other workers' deques or the shared queue
+            uint64_t StolenJobCount = 0;
+            double BusySeconds = 0.0;
+            // Share of the time since the statistics were reset spent running jobs
+            double Utilization = 0.0;
+        };
+
+    private:
+        struct Job;
+
+    public:
+        // Number of unfinished jobs scheduled with it. Must outlive the jobs, and jobs may wait for it to reach zero before they start.
+        class Counter {
+        private:
+            friend class JobSystem;
+
+            std::atomic<uint32_t> count{0};
+            mutable std::mutex mutex;
+            std::vector<Job*> waitingJobs;
+
+        public:
+            bool isDone() const;
+        };
+
+    private:
+        struct Job {
+            std::function<void()> Function;
+            Counter* JobCounter;
+        };
+
+        struct Worker {
+            uint32_t Index;
+            WorkStealingDeque<Job> Deque;
+            // Not joinable for registered thread slots
+            std::thread Thread;
+            std::atomic<bool> Registered{false};
+            std::atomic<uint64_t> JobCount{0};
+            std::atomic<uint64_t> StolenJobCount{0};
+            std::atomic<uint64_t> BusyNanoseconds{0};
+
+            Worker(uint32_t index, uint32_t dequeCapacity);
+        };
+
+    private:
+        static thread_local Worker* currentWorker;
+        static thread_local const JobSystem* currentJobSystem;
+
+        Config config;
+        // Worker threads followed by the slots of registered threads, fixed while running since other threads steal from all of them
+        std::vector<std::unique_ptr<Worker>> workers;
+        uint32_t workerThreadCount = 0;
+        std::mutex sharedMutex;
+        std::deque<Job*> sharedJobs;
+        std::deque<Job*> backgroundJobs;
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+        std::atomic<uint32_t> sleepingWorkerCount{0};
+        std::atomic<uint32_t> queuedJobCount{0};
+        std::atomic<bool> running{false};
+        std::chrono::steady_clock::time_point statisticsStartTime;
+
+    public:
+        explicit JobSystem(Config config);
+
+        ~JobSystem();
+
+        bool initialize();
+
+        void terminate();
+
+        // Gives the calling thread its own deque until it unregisters, returns false if every slot is taken. Must not be called by a worker.
+        bool registerThread();
+
+        // Runs the jobs left in the calling thread's deque, must be called before a registered thread exits
+        void unregisterThread();
+
+        // Workers plus the thread waiting for them, or 1 before initialization, in which case jobs run on the scheduling thread
+        uint32_t getThreadCount() const;
+
+        // The counter, if any, is incremented now and decremented once the job has returned
+        void schedule(std::function<void()> function, Counter* counter = nullptr);
+
+        // Like schedule, but the job is not started before the dependency has reached zero
+        void schedule(std::function<void()> function, Counter* counter, Counter& dependency);
+
+        // Like schedule, but for jobs that run long or block (e.g. pipeline compilation). Only workers run them, after every other queued job.
+        void scheduleBackground(std::function<void()> function, Counter* counter = nullptr);
+
+        // Runs other jobs, except background jobs, on the calling thread until the counter reaches zero
+        void wait(const Counter& counter);
+
+        // Splits [begin, end) into ranges of at least minRangeSize and calls function(rangeBegin, rangeEnd) for each of them across the threads,
+        // returns once every range is done. The calling thread runs the first range itself.
+        void parallelFor(uint32_t begin, uint32_t end, uint32_t minRangeSize, const std::function<void(uint32_t, uint32_t)>& function);
+
+        // Per worker thread, followed by the registered thread slots
+        std::vector<WorkerStatistics> getStatistics() const;
+
+        void resetStatistics();
+
+        void logStatistics() const;
+
+    private:
+        void runWorker(Worker* worker);
+
+        void enqueue(Job* job);
+
+        void notify();
+
+        Job* findJob(Worker* worker);
+
+        Job* findBackgroundJob(Worker* worker);
+
+        void execute(Worker* worker, Job* job);
+
+        void finish(Counter* counter);
+
+        Worker* getCurrentWorker() const;
+
+        static bool pinThread(std::thread& thread, uint32_t core);
+    };
+
+}
@@ -0,0 +1,231 @@
+#include "MappedFile.h"
+#include "Log.h"
+
+#include <algorithm>
+
+#ifdef VD_PLATFORM_WINDOWS
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Vulkandemo {
+
+#ifndef VD_PLATFORM_WINDOWS
+    static int getAdvice(MappedFile::AccessPattern accessPattern) {
+        switch (accessPattern) {
+            case MappedFile::AccessPattern::Sequential:
+                return MADV_SEQUENTIAL;
+            case MappedFile::AccessPattern::Random:
+                return MADV_RANDOM;
+            case MappedFile::AccessPattern::WillNeed:
+                return MADV_WILLNEED;
+            default:
+                return MADV_NORMAL;
+        }
+    }
+#endif
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept {
+        moveFrom(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    const void* MappedFile::getData() const {
+        return data;
+    }
+
+    void* MappedFile::getData() {
+        return data;
+    }
+
+    uint64_t MappedFile::getSize() const {
+        return size;
+    }
+
+    bool MappedFile::isOpen() const {
+        return data != nullptr;
+    }
+
+#ifdef VD_PLATFORM_WINDOWS
+    bool MappedFile::open(const char* path, AccessPattern accessPattern) {
+        close();
+        DWORD flags = FILE_ATTRIBUTE_NORMAL;
+        if (accessPattern == AccessPattern::Sequential) {
+            flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+        } else if (accessPattern == AccessPattern::Random) {
+            flags |= FILE_FLAG_RANDOM_ACCESS;
+        }
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            VD_LOG_ERROR("Could not open file with path [{0}]", path);
+            return false;
+        }
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            VD_LOG_ERROR("Could not get size of file with path [{0}]", path);
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            VD_LOG_ERROR("Could not create file mapping for path [{0}]", path);
+            CloseHandle(file);
+            return false;
+        }
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr) {
+            VD_LOG_ERROR("Could not map view of file with path [{0}]", path);
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        data = view;
+        size = (uint64_t) fileSize.QuadPart;
+        fileHandle = file;
+        mappingHandle = mapping;
+        if (accessPattern == AccessPattern::WillNeed) {
+            advise(accessPattern, 0, size);
+        }
+        return true;
+    }
+
+    bool MappedFile::allocate(uint64_t size) {
+        close();
+        void* address = VirtualAlloc(nullptr, (SIZE_T) size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+        if (address == nullptr) {
+            VD_LOG_ERROR("Could not allocate [{}] bytes of mapped memory", size);
+            return false;
+        }
+        this->data = address;
+        this->size = size;
+        return true;
+    }
+
+    void MappedFile::close() {
+        // Anonymous allocations have no file mapping behind them
+        if (data != nullptr && mappingHandle == nullptr) {
+            VirtualFree(data, 0, MEM_RELEASE);
+        } else if (data != nullptr) {
+            UnmapViewOfFile(data);
+        }
+        if (mappingHandle != nullptr) {
+            CloseHandle((HANDLE) mappingHandle);
+        }
+        if (fileHandle != nullptr) {
+            CloseHandle((HANDLE) fileHandle);
+        }
+        data = nullptr;
+        size = 0;
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+    }
+
+    void MappedFile::advise(AccessPattern accessPattern, uint64_t offset, uint64_t length) const {
+        if (data == nullptr || offset >= size || accessPattern != AccessPattern::WillNeed) {
+            return;
+        }
+        WIN32_MEMORY_RANGE_ENTRY range{};
+        range.VirtualAddress = (char*) data + offset;
+        range.NumberOfBytes = (SIZE_T) std::min(length, size - offset);
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+
+    void MappedFile::moveFrom(MappedFile& other) {
+        data = other.data;
+        size = other.size;
+        fileHandle = other.fileHandle;
+        mappingHandle = other.mappingHandle;
+        other.data = nullptr;
+        other.size = 0;
+        other.fileHandle = nullptr;
+        other.mappingHandle = nullptr;
+    }
+#else
+    bool MappedFile::open(const char* path, AccessPattern accessPattern) {
+        close();
+        int fileDescriptor = ::open(path, O_RDONLY);
+        if (fileDescriptor == -1) {
+            VD_LOG_ERROR("Could not open file with path [{0}]", path);
+            return false;
+        }
+        struct stat fileStatus{};
+        if (fstat(fileDescriptor, &fileStatus) == -1 || fileStatus.st_size == 0) {
+            VD_LOG_ERROR("Could not get size of file with path [{0}]", path);
+            ::close(fileDescriptor);
+            return false;
+        }
+        uint64_t fileSize = (uint64_t) fileStatus.st_size;
+        void* address = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+        // The mapping keeps its own reference to the file, so the descriptor is no longer needed
+        ::close(fileDescriptor);
+
+        if (address == MAP_FAILED) {
+            VD_LOG_ERROR("Could not map file with path [{0}]", path);
+            return false;
+        }
+        data = address;
+        size = fileSize;
+        advise(accessPattern, 0, size);
+        return true;
+    }
+
+    bool MappedFile::allocate(uint64_t size) {
+        close();
+        void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (address == MAP_FAILED) {
+            VD_LOG_ERROR("Could not allocate [{}] bytes of mapped memory", size);
+            return false;
+        }
+        this->data = address;
+        this->size = size;
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (data != nullptr) {
+            munmap(data, size);
+        }
+        data = nullptr;
+        size = 0;
+    }
+
+    void MappedFile::advise(AccessPattern accessPattern, uint64_t offset, uint64_t length) const {
+        if (data == nullptr || offset >= size) {
+            return;
+        }
+        // madvise requires a page aligned start address
+        static const uint64_t pageSize = (uint64_t) sysconf(_SC_PAGESIZE);
+        uint64_t alignedOffset = offset - (offset % pageSize);
+        uint64_t alignedLength = std::min(length, size - offset) + (offset - alignedOffset);
+        if (madvise((char*) data + alignedOffset, alignedLength, getAdvice(accessPattern)) != 0) {
+            VD_LOG_WARN("Could not apply memory advice to mapped file");
+        }
+    }
+
+    void MappedFile::moveFrom(MappedFile& other) {
+        data = other.data;
+        size = other.size;
+        other.data = nullptr;
+        other.size = 0;
+    }
+#endif
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Environment.h"
+
+#include <cstdint>
+
+namespace Vulkandemo {
+
+    class MappedFile {
+    public:
+        enum class AccessPattern {
+            Normal = 0,
+            Sequential,
+            Random,
+            WillNeed
+        };
+
+    private:
+        void* data = nullptr;
+        uint64_t size = 0;
+#ifdef VD_PLATFORM_WINDOWS
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#endif
+
+    public:
+        MappedFile() = default;
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        const void* getData() const;
+
+        void* getData();
+
+        // Mapped views start on a page boundary, so the data is suitably aligned for any scalar type (e.g. SPIR-V words)
+        template<typename T>
+        const T* getDataAs() const {
+            return (const T*) data;
+        }
+
+        uint64_t getSize() const;
+
+        bool isOpen() const;
+
+        bool open(const char* path, AccessPattern accessPattern = AccessPattern::Normal);
+
+        // Maps anonymous, page aligned memory that file contents can be read into (e.g. by asynchronous I/O)
+        bool allocate(uint64_t size);
+
+        void close();
+
+        void advise(AccessPattern accessPattern, uint64_t offset, uint64_t length) const;
+
+    private:
+        void moveFrom(MappedFile& other);
+    };
+
+}
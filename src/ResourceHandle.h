@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Vulkandemo {
+
+    // 32-bit handle to a resource of a ResourcePool, the low bits hold the slot index and the high bits its generation. The generation of a slot
+    // changes every time it is reused, so handles to destroyed resources never refer to the resource that replaces them.
+    template<typename T>
+    struct ResourceHandle {
+        static constexpr uint32_t INDEX_BITS = 20;
+        static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+        static constexpr uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+        static constexpr uint32_t INVALID_VALUE = UINT32_MAX;
+
+        uint32_t Value = INVALID_VALUE;
+
+        static ResourceHandle create(uint32_t index, uint32_t generation) {
+            return {((generation & GENERATION_MASK) << INDEX_BITS) | index};
+        }
+
+        uint32_t getIndex() const {
+            return Value & INDEX_MASK;
+        }
+
+        uint32_t getGeneration() const {
+            return Value >> INDEX_BITS;
+        }
+
+        bool isValid() const {
+            return Value != INVALID_VALUE;
+        }
+
+        bool operator==(const ResourceHandle& other) const {
+            return Value == other.Value;
+        }
+
+        bool operator!=(const ResourceHandle& other) const {
+            return Value != other.Value;
+        }
+    };
+
+}
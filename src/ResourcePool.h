@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Assert.h"
+#include "ResourceHandle.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Vulkandemo {
+
+    // Stores resources by value in one dense array addressed by generational handles. Handles go through a slot that knows where its resource
+    // currently is, so lookups are O(1), removing swaps the last resource into the gap to keep the array dense, and stale handles are detected
+    // by their generation. Pointers into the pool are only valid until the next add or remove.
+    template<typename T>
+    class ResourcePool {
+    public:
+        using Handle = ResourceHandle<T>;
+
+    private:
+        struct Slot {
+            uint32_t DenseIndex = 0;
+            uint32_t Generation = 0;
+            bool Used = false;
+        };
+
+    private:
+        // Indexed by dense index
+        std::vector<T> resources;
+        std::vector<uint32_t> slotIndices;
+        // Indexed by handle index
+        std::vector<Slot> slots;
+        std::vector<uint32_t> freeSlotIndices;
+
+    public:
+        Handle add(T resource) {
+            uint32_t slotIndex;
+            if (!freeSlotIndices.empty()) {
+                slotIndex = freeSlotIndices.back();
+                freeSlotIndices.pop_back();
+            } else {
+                slotIndex = (uint32_t) slots.size();
+                VD_ASSERT(slotIndex <= Handle::INDEX_MASK);
+                slots.emplace_back();
+            }
+            Slot& slot = slots[slotIndex];
+            slot.DenseIndex = (uint32_t) resources.size();
+            slot.Used = true;
+            resources.push_back(std::move(resource));
+            slotIndices.push_back(slotIndex);
+            return Handle::create(slotIndex, slot.Generation);
+        }
+
+        // Returns nullptr if the handle is invalid or its resource has been removed
+        T* get(Handle handle) {
+            const Slot* slot = findSlot(handle);
+            return slot != nullptr ? &resources[slot->DenseIndex] : nullptr;
+        }
+
+        const T* get(Handle handle) const {
+            const Slot* slot = findSlot(handle);
+            return slot != nullptr ? &resources[slot->DenseIndex] : nullptr;
+        }
+
+        bool contains(Handle handle) const {
+            return findSlot(handle) != nullptr;
+        }
+
+        // Returns false if the handle is invalid or its resource has been removed already
+        bool remove(Handle handle) {
+            const Slot* slot = findSlot(handle);
+            if (slot == nullptr) {
+                return false;
+            }
+            uint32_t denseIndex = slot->DenseIndex;
+            uint32_t lastDenseIndex = (uint32_t) resources.size() - 1;
+            if (denseIndex != lastDenseIndex) {
+                resources[denseIndex] = std::move(resources[lastDenseIndex]);
+                slotIndices[denseIndex] = slotIndices[lastDenseIndex];
+                slots[slotIndices[denseIndex]].DenseIndex = denseIndex;
+            }
+            resources.pop_back();
+            slotIndices.pop_back();
+
+            freeSlot(handle.getIndex());
+            return true;
+        }
+
+        uint32_t getCount() const {
+            return (uint32_t) resources.size();
+        }
+
+        // Resources in dense order, which changes when resources are removed
+        typename std::vector<T>::iterator begin() {
+            return resources.begin();
+        }
+
+        typename std::vector<T>::iterator end() {
+            return resources.end();
+        }
+
+        typename std::vector<T>::const_iterator begin() const {
+            return resources.begin();
+        }
+
+        typename std::vector<T>::const_iterator end() const {
+            return resources.end();
+        }
+
+        void clear() {
+            for (uint32_t slotIndex : slotIndices) {
+                freeSlot(slotIndex);
+            }
+            resources.clear();
+            slotIndices.clear();
+        }
+
+    private:
+        const Slot* findSlot(Handle handle) const {
+            uint32_t slotIndex = handle.getIndex();
+            if (!handle.isValid() || slotIndex >= slots.size()) {
+                return nullptr;
+            }
+            const Slot& slot = slots[slotIndex];
+            return slot.Used && slot.Generation == handle.getGeneration() ? &slot : nullptr;
+        }
+
+        void freeSlot(uint32_t slotIndex) {
+            Slot& slot = slots[slotIndex];
+            slot.Used = false;
+            slot.Generation = (slot.Generation + 1) & Handle::GENERATION_MASK;
+            // The all ones value is reserved for invalid handles
+            if (slotIndex == Handle::INDEX_MASK && slot.Generation == Handle::GENERATION_MASK) {
+                slot.Generation = 0;
+            }
+            freeSlotIndices.push_back(slotIndex);
+        }
+    };
+
+}
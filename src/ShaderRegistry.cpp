@@ -0,0 +1,30 @@
+#include "ShaderRegistry.h"
+
+namespace Vulkandemo {
+
+#ifdef VD_EMBED_SHADERS
+    // Defined in the generated EmbeddedShaders.cpp
+    extern const EmbeddedShader EMBEDDED_SHADERS[];
+    extern const uint32_t EMBEDDED_SHADER_COUNT;
+#endif
+
+    const EmbeddedShader* ShaderRegistry::find(std::string_view name) {
+#ifdef VD_EMBED_SHADERS
+        for (uint32_t i = 0; i < EMBEDDED_SHADER_COUNT; i++) {
+            if (name == EMBEDDED_SHADERS[i].Name) {
+                return &EMBEDDED_SHADERS[i];
+            }
+        }
+#endif
+        return nullptr;
+    }
+
+    uint32_t ShaderRegistry::getShaderCount() {
+#ifdef VD_EMBED_SHADERS
+        return EMBEDDED_SHADER_COUNT;
+#else
+        return 0;
+#endif
+    }
+
+}
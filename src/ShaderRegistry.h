@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Vulkandemo {
+
+    struct EmbeddedShader {
+        const char* Name;
+        const uint32_t* Code;
+        size_t Size;
+    };
+
+    // SPIR-V compiled into the executable when building with VD_EMBED_SHADERS=ON (see cmake/embed_shaders.cmake)
+    class ShaderRegistry {
+    public:
+        // Shaders are registered by their asset path, e.g. "shaders/simple_shader.vert.spv"
+        static const EmbeddedShader* find(std::string_view name);
+
+        static uint32_t getShaderCount();
+    };
+
+}
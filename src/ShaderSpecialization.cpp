@@ -0,0 +1,74 @@
+#include "ShaderSpecialization.h"
+#include "Hash.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Vulkandemo {
+
+    ShaderSpecialization& ShaderSpecialization::set(uint32_t constantId, uint32_t value) {
+        auto iterator = std::lower_bound(values.begin(), values.end(), constantId, [](const std::pair<uint32_t, uint32_t>& entry, uint32_t id) {
+            return entry.first < id;
+        });
+        if (iterator != values.end() && iterator->first == constantId) {
+            iterator->second = value;
+        } else {
+            values.insert(iterator, {constantId, value});
+        }
+        return *this;
+    }
+
+    ShaderSpecialization& ShaderSpecialization::set(uint32_t constantId, int32_t value) {
+        return set(constantId, (uint32_t) value);
+    }
+
+    ShaderSpecialization& ShaderSpecialization::set(uint32_t constantId, float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return set(constantId, bits);
+    }
+
+    ShaderSpecialization& ShaderSpecialization::set(uint32_t constantId, bool value) {
+        return set(constantId, (uint32_t) (value ? VK_TRUE : VK_FALSE));
+    }
+
+    bool ShaderSpecialization::isEmpty() const {
+        return values.empty();
+    }
+
+    uint64_t ShaderSpecialization::getHash() const {
+        uint64_t hash = HASH_SEED;
+        for (const auto& [constantId, value] : values) {
+            hash = hashValue(constantId, hash);
+            hash = hashValue(value, hash);
+        }
+        return hash;
+    }
+
+    bool ShaderSpecialization::operator==(const ShaderSpecialization& other) const {
+        return values == other.values;
+    }
+
+    void ShaderSpecialization::getMapEntries(const VulkanShaderReflection& reflection, std::vector<VkSpecializationMapEntry>& mapEntries, std::vector<uint32_t>& data) const {
+        for (const ShaderSpecializationConstant& constant : reflection.getSpecializationConstants()) {
+            auto iterator = std::lower_bound(values.begin(), values.end(), constant.ConstantId, [](const std::pair<uint32_t, uint32_t>& entry, uint32_t id) {
+                return entry.first < id;
+            });
+            if (iterator == values.end() || iterator->first != constant.ConstantId) {
+                continue;
+            }
+            if (constant.Size != sizeof(uint32_t)) {
+                VD_LOG_WARN("Could not specialize [{}]-byte constant [{}] (ID [{}]), only 32-bit constants are supported", constant.Size, constant.Name, constant.ConstantId);
+                continue;
+            }
+            VkSpecializationMapEntry mapEntry{};
+            mapEntry.constantID = constant.ConstantId;
+            mapEntry.offset = (uint32_t) (data.size() * sizeof(uint32_t));
+            mapEntry.size = sizeof(uint32_t);
+            mapEntries.push_back(mapEntry);
+            data.push_back(iterator->second);
+        }
+    }
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "VulkanShaderReflection.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Vulkandemo {
+
+    // Values for the specialization constants of a shader permutation, e.g. a lighting model or texture count baked in at pipeline creation
+    class ShaderSpecialization {
+    private:
+        // Sorted by constant ID so equal specializations compare and hash equal regardless of the order the values were set in
+        std::vector<std::pair<uint32_t, uint32_t>> values;
+
+    public:
+        ShaderSpecialization& set(uint32_t constantId, uint32_t value);
+
+        ShaderSpecialization& set(uint32_t constantId, int32_t value);
+
+        ShaderSpecialization& set(uint32_t constantId, float value);
+
+        ShaderSpecialization& set(uint32_t constantId, bool value);
+
+        bool isEmpty() const;
+
+        uint64_t getHash() const;
+
+        bool operator==(const ShaderSpecialization& other) const;
+
+        // Map entries for the constants declared by the shader; constants it does not declare are left out
+        void getMapEntries(const VulkanShaderReflection& reflection, std::vector<VkSpecializationMapEntry>& mapEntries, std::vector<uint32_t>& data) const;
+    };
+
+}
@@ -0,0 +1,203 @@
+#include "ShaderWatcher.h"
+#include "Log.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#ifdef VD_PLATFORM_LINUX
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+#ifdef VD_PLATFORM_WINDOWS
+    #define popen _popen
+    #define pclose _pclose
+#endif
+
+namespace Vulkandemo {
+
+    // Editors often save a file in several steps, so changes arriving within this window are compiled together
+    constexpr std::chrono::milliseconds CHANGE_SETTLE_DURATION(50);
+    constexpr std::chrono::milliseconds POLL_INTERVAL(250);
+
+    ShaderWatcher::ShaderWatcher(Config config, FileSystem* fileSystem) : config(std::move(config)), fileSystem(fileSystem) {
+    }
+
+    ShaderWatcher::~ShaderWatcher() {
+        if (worker.joinable()) {
+            terminate();
+        }
+    }
+
+    bool ShaderWatcher::initialize() {
+        std::error_code errorCode;
+        if (config.SourceDirectory.empty() || !std::filesystem::is_directory(config.SourceDirectory, errorCode)) {
+            VD_LOG_ERROR("Could not find shader source directory [{}]", config.SourceDirectory);
+            return false;
+        }
+        std::filesystem::create_directories(config.OutputDirectory, errorCode);
+
+        running = true;
+#ifdef VD_PLATFORM_LINUX
+        inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyDescriptor != -1 && inotify_add_watch(inotifyDescriptor, config.SourceDirectory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) != -1) {
+            worker = std::thread(&ShaderWatcher::runInotify, this);
+            VD_LOG_INFO("Watching shader sources in [{}] with inotify", config.SourceDirectory);
+            return true;
+        }
+        VD_LOG_WARN("Could not watch shader sources with inotify so falling back to polling");
+        if (inotifyDescriptor != -1) {
+            close(inotifyDescriptor);
+            inotifyDescriptor = -1;
+        }
+#endif
+        findChangedSources();
+        worker = std::thread(&ShaderWatcher::runPolling, this);
+        VD_LOG_INFO("Watching shader sources in [{}] by polling", config.SourceDirectory);
+        return true;
+    }
+
+    void ShaderWatcher::terminate() {
+        running = false;
+        if (worker.joinable()) {
+            worker.join();
+        }
+#ifdef VD_PLATFORM_LINUX
+        if (inotifyDescriptor != -1) {
+            close(inotifyDescriptor);
+            inotifyDescriptor = -1;
+        }
+#endif
+        VD_LOG_INFO("Terminated shader watcher");
+    }
+
+    void ShaderWatcher::setOnCompiled(const std::function<void(const std::string&, const std::vector<uint32_t>&)>& onCompiled) {
+        this->onCompiled = onCompiled;
+    }
+
+    void ShaderWatcher::runInotify() {
+#ifdef VD_PLATFORM_LINUX
+        alignas(inotify_event) char buffer[4096];
+        pollfd pollDescriptor{inotifyDescriptor, POLLIN, 0};
+        while (running) {
+            if (poll(&pollDescriptor, 1, (int) POLL_INTERVAL.count()) <= 0) {
+                continue;
+            }
+            std::this_thread::sleep_for(CHANGE_SETTLE_DURATION);
+
+            std::set<std::string> changedFileNames;
+            ssize_t length;
+            while ((length = read(inotifyDescriptor, buffer, sizeof(buffer))) > 0) {
+                for (char* pointer = buffer; pointer < buffer + length;) {
+                    auto* event = (inotify_event*) pointer;
+                    if (event->len > 0) {
+                        changedFileNames.insert(event->name);
+                    }
+                    pointer += sizeof(inotify_event) + event->len;
+                }
+            }
+            compileChangedSources(changedFileNames);
+        }
+#endif
+    }
+
+    void ShaderWatcher::runPolling() {
+        while (running) {
+            std::this_thread::sleep_for(POLL_INTERVAL);
+            compileChangedSources(findChangedSources());
+        }
+    }
+
+    std::set<std::string> ShaderWatcher::findChangedSources() {
+        std::set<std::string> changedFileNames;
+        std::error_code errorCode;
+        for (const auto& entry : std::filesystem::directory_iterator(config.SourceDirectory, errorCode)) {
+            if (!isShaderSource(entry.path()) && !isShaderInclude(entry.path())) {
+                continue;
+            }
+            std::filesystem::file_time_type lastWriteTime = entry.last_write_time(errorCode);
+            std::string fileName = entry.path().filename().string();
+            auto iterator = lastWriteTimes.find(fileName);
+            if (iterator != lastWriteTimes.end() && iterator->second != lastWriteTime) {
+                changedFileNames.insert(fileName);
+            }
+            lastWriteTimes[fileName] = lastWriteTime;
+        }
+        return changedFileNames;
+    }
+
+    void ShaderWatcher::compileChangedSources(const std::set<std::string>& changedFileNames) {
+        std::set<std::string> sourceFileNames;
+        for (const std::string& fileName : changedFileNames) {
+            // Any shader could include a changed include file, so recompile all of them
+            if (isShaderInclude(fileName)) {
+                std::error_code errorCode;
+                for (const auto& entry : std::filesystem::directory_iterator(config.SourceDirectory, errorCode)) {
+                    if (isShaderSource(entry.path())) {
+                        sourceFileNames.insert(entry.path().filename().string());
+                    }
+                }
+            } else if (isShaderSource(fileName)) {
+                sourceFileNames.insert(fileName);
+            }
+        }
+        for (const std::string& sourceFileName : sourceFileNames) {
+            std::vector<uint32_t> code;
+            if (!compile(sourceFileName, code)) {
+                continue;
+            }
+            if (onCompiled) {
+                onCompiled(config.OutputDirectory + "/" + sourceFileName + ".spv", code);
+            }
+        }
+    }
+
+    bool ShaderWatcher::compile(const std::string& sourceFileName, std::vector<uint32_t>& code) const {
+        std::string sourcePath = config.SourceDirectory + "/" + sourceFileName;
+        std::string outputPath = config.OutputDirectory + "/" + sourceFileName + ".spv";
+        std::string command = "\"" + config.CompilerPath + "\" -o \"" + outputPath + "\" \"" + sourcePath + "\" 2>&1";
+#ifdef VD_PLATFORM_WINDOWS
+        // cmd.exe strips the outer quotes of the whole command line
+        command = "\"" + command + "\"";
+#endif
+        auto startTime = std::chrono::steady_clock::now();
+        FILE* process = popen(command.c_str(), "r");
+        if (process == nullptr) {
+            VD_LOG_ERROR("Could not run shader compiler [{}]", config.CompilerPath);
+            return false;
+        }
+        std::string output;
+        char buffer[512];
+        while (fgets(buffer, sizeof(buffer), process) != nullptr) {
+            output += buffer;
+        }
+        if (pclose(process) != 0) {
+            VD_LOG_ERROR("Could not compile shader [{}]:\n{}", sourceFileName, output);
+            return false;
+        }
+        // Copied into words, since the bytes are not guaranteed to be aligned for SPIR-V
+        std::vector<char> bytes = fileSystem->readBytes(outputPath.c_str());
+        if (bytes.empty() || bytes.size() % sizeof(uint32_t) != 0) {
+            VD_LOG_ERROR("Could not use compiled shader [{}] of [{}] bytes", outputPath, bytes.size());
+            return false;
+        }
+        code.resize(bytes.size() / sizeof(uint32_t));
+        memcpy(code.data(), bytes.data(), bytes.size());
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        VD_LOG_INFO("Recompiled shader [{}] in [{:.1f}] ms", sourceFileName, milliseconds);
+        return true;
+    }
+
+    bool ShaderWatcher::isShaderSource(const std::filesystem::path& path) {
+        std::filesystem::path extension = path.extension();
+        return extension == ".vert" || extension == ".frag" || extension == ".comp";
+    }
+
+    bool ShaderWatcher::isShaderInclude(const std::filesystem::path& path) {
+        return path.extension() == ".glsl";
+    }
+
+}
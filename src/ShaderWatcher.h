@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Environment.h"
+#include "FileSystem.h"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Vulkandemo {
+
+    // Recompiles shader sources on a background thread when they change on disk (inotify on Linux, polling elsewhere)
+    class ShaderWatcher {
+    public:
+        struct Config {
+            bool Enabled = false;
+            std::string SourceDirectory;
+            std::string OutputDirectory = "shaders";
+            std::string CompilerPath = "glslc";
+        };
+
+    private:
+        Config config;
+        FileSystem* fileSystem;
+        std::function<void(const std::string&, const std::vector<uint32_t>&)> onCompiled;
+        std::thread worker;
+        std::atomic<bool> running{false};
+        int inotifyDescriptor = -1;
+        std::map<std::string, std::filesystem::file_time_type> lastWriteTimes;
+
+    public:
+        ShaderWatcher(Config config, FileSystem* fileSystem);
+
+        ~ShaderWatcher();
+
+        bool initialize();
+
+        void terminate();
+
+        // Invoked on the watcher thread with the output path (e.g. "shaders/simple_shader.frag.spv") and SPIR-V words of every recompiled shader
+        void setOnCompiled(const std::function<void(const std::string&, const std::vector<uint32_t>&)>& onCompiled);
+
+    private:
+        void runInotify();
+
+        void runPolling();
+
+        std::set<std::string> findChangedSources();
+
+        void compileChangedSources(const std::set<std::string>& changedFileNames);
+
+        bool compile(const std::string& sourceFileName, std::vector<uint32_t>& code) const;
+
+        static bool isShaderSource(const std::filesystem::path& path);
+
+        static bool isShaderInclude(const std::filesystem::path& path);
+    };
+
+}
@@ -0,0 +1,55 @@
+#include "SimulationClock.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Vulkandemo {
+
+    SimulationClock::SimulationClock(Config config) : config(config) {
+    }
+
+    uint32_t SimulationClock::advance(double elapsedSeconds) {
+        accumulatedSeconds += std::max(elapsedSeconds, 0.0);
+        auto dueStepCount = (uint64_t) std::floor(accumulatedSeconds / config.StepSeconds);
+        if (dueStepCount > config.MaxStepsPerAdvance) {
+            uint64_t droppedCount = dueStepCount - config.MaxStepsPerAdvance;
+            accumulatedSeconds -= (double) droppedCount * config.StepSeconds;
+            droppedStepCount += droppedCount;
+            dueStepCount = config.MaxStepsPerAdvance;
+        }
+        return (uint32_t) dueStepCount;
+    }
+
+    double SimulationClock::step() {
+        accumulatedSeconds = std::max(accumulatedSeconds - config.StepSeconds, 0.0);
+        stepCount++;
+        // Multiplied instead of summed, so rounding errors do not add up over a long run
+        time = (double) stepCount * config.StepSeconds;
+        return time;
+    }
+
+    double SimulationClock::getStepSeconds() const {
+        return config.StepSeconds;
+    }
+
+    double SimulationClock::getTime() const {
+        return time;
+    }
+
+    double SimulationClock::getAccumulatedSeconds() const {
+        return accumulatedSeconds;
+    }
+
+    double SimulationClock::getSecondsUntilNextStep() const {
+        return std::max(config.StepSeconds - accumulatedSeconds, 0.0);
+    }
+
+    uint64_t SimulationClock::getStepCount() const {
+        return stepCount;
+    }
+
+    uint64_t SimulationClock::getDroppedStepCount() const {
+        return droppedStepCount;
+    }
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Vulkandemo {
+
+    // Fixed timestep clock. Elapsed real time is collected in an accumulator and spent in steps of a fixed length, so the simulation does the same
+    // work per simulated second at any frame rate. When the simulation falls behind, at most MaxStepsPerAdvance steps are made up at once and the
+    // rest of the backlog is dropped, so a slow step cannot make every following advance slower.
+    class SimulationClock {
+    public:
+        struct Config {
+            double StepSeconds = 1.0 / 60.0;
+            uint32_t MaxStepsPerAdvance = 4;
+        };
+
+    private:
+        Config config;
+        double accumulatedSeconds = 0.0;
+        double time = 0.0;
+        uint64_t stepCount = 0;
+        uint64_t droppedStepCount = 0;
+
+    public:
+        explicit SimulationClock(Config config);
+
+        // Adds elapsed real time and returns the number of steps that are due, each of them has to be made with step()
+        uint32_t advance(double elapsedSeconds);
+
+        // Spends one step of the accumulator and returns the simulated time after it
+        double step();
+
+        double getStepSeconds() const;
+
+        // Simulated seconds, as of the last step
+        double getTime() const;
+
+        // Real time collected that is not enough for another step yet
+        double getAccumulatedSeconds() const;
+
+        // Until the next step is due
+        double getSecondsUntilNextStep() const;
+
+        uint64_t getStepCount() const;
+
+        // Steps skipped because the simulation could not keep up
+        uint64_t getDroppedStepCount() const;
+    };
+
+}
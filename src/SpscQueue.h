@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Vulkandemo {
+
+    // Fixed capacity lock-free queue for exactly one producer thread and one consumer thread
+    template<typename T, size_t CAPACITY>
+    class SpscQueue {
+    private:
+        static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "Capacity must be a power of two");
+
+        std::array<T, CAPACITY> items{};
+        // Written by the producer only
+        alignas(64) std::atomic<size_t> tail{0};
+        // Written by the consumer only
+        alignas(64) std::atomic<size_t> head{0};
+
+    public:
+        // Producer only. Returns false when the queue is full.
+        bool push(const T& item) {
+            size_t currentTail = tail.load(std::memory_order_relaxed);
+            if (currentTail - head.load(std::memory_order_acquire) == CAPACITY) {
+                return false;
+            }
+            items[currentTail & (CAPACITY - 1)] = item;
+            tail.store(currentTail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only. Returns false when the queue is empty.
+        bool pop(T& item) {
+            size_t currentHead = head.load(std::memory_order_relaxed);
+            if (currentHead == tail.load(std::memory_order_acquire)) {
+                return false;
+            }
+            item = items[currentHead & (CAPACITY - 1)];
+            head.store(currentHead + 1, std::memory_order_release);
+            return true;
+        }
+    };
+
+}
@@ -0,0 +1,90 @@
+#include "SubmissionBenchmark.h"
+#include "Log.h"
+
+#include <algorithm>
+
+namespace Vulkandemo {
+
+    SubmissionBenchmark::SubmissionBenchmark(Config config) : config(config) {
+    }
+
+    bool SubmissionBenchmark::isEnabled() const {
+        return config.Enabled;
+    }
+
+    bool SubmissionBenchmark::isFinished() const {
+        return finished;
+    }
+
+    SubmissionMode SubmissionBenchmark::getMode() const {
+        return MODES[modeIndex];
+    }
+
+    void SubmissionBenchmark::addFrame(double recordMilliseconds, uint32_t drawCallCount, uint32_t testedObjectCount, uint32_t drawnObjectCount) {
+        if (!config.Enabled || finished) {
+            return;
+        }
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        double frameMilliseconds = std::chrono::duration<double, std::milli>(now - lastFrameTime).count();
+        bool firstFrameOfMode = modeFrame == 0;
+        lastFrameTime = now;
+        objectCount = testedObjectCount;
+
+        // The frame time of the first frame of a mode has no previous frame to be measured against
+        if (!firstFrameOfMode && modeFrame > config.WarmupFrames) {
+            Result& result = results[modeIndex];
+            result.RecordMilliseconds += recordMilliseconds;
+            result.FrameMilliseconds += frameMilliseconds;
+            result.DrawnObjectCount += drawnObjectCount;
+            result.FrameCount++;
+        }
+        if (modeFrame == config.WarmupFrames) {
+            VD_LOG_INFO("Benchmarking [{}] submission with [{}] draw calls for [{}] frames", getModeAsString(getMode()), drawCallCount, config.MeasuredFrames);
+        }
+        modeFrame++;
+        if (modeFrame <= config.WarmupFrames + config.MeasuredFrames) {
+            return;
+        }
+        modeFrame = 0;
+        modeIndex++;
+        if (modeIndex == MODES.size()) {
+            modeIndex = 0;
+            finished = true;
+            logResults();
+        }
+    }
+
+    void SubmissionBenchmark::logResults() const {
+        VD_LOG_INFO("Submission benchmark results (averages over [{}] frames)", config.MeasuredFrames);
+        for (uint32_t i = 0; i < MODES.size(); i++) {
+            const Result& result = results[i];
+            uint32_t frameCount = std::max(result.FrameCount, 1u);
+            VD_LOG_INFO("{} --> record [{:.3f}] ms, frame [{:.3f}] ms, drawn [{}] of [{}] objects", getModeAsString(MODES[i]), result.RecordMilliseconds / frameCount, result.FrameMilliseconds / frameCount, result.DrawnObjectCount / frameCount, objectCount);
+        }
+        const Result& baseline = results[0];
+        for (uint32_t i = 1; i < MODES.size(); i++) {
+            const Result& result = results[i];
+            if (result.RecordMilliseconds > 0.0 && result.FrameMilliseconds > 0.0) {
+                VD_LOG_INFO("{} speedup over {} --> record [{:.1f}]x, frame [{:.1f}]x", getModeAsString(MODES[i]), getModeAsString(MODES[0]), baseline.RecordMilliseconds / result.RecordMilliseconds, baseline.FrameMilliseconds / result.FrameMilliseconds);
+            }
+        }
+    }
+
+    const char* SubmissionBenchmark::getModeAsString(SubmissionMode mode) {
+        switch (mode) {
+            case SubmissionMode::Instanced:
+                return "Instanced";
+            case SubmissionMode::PerDraw:
+                return "Per-draw";
+            case SubmissionMode::Indirect:
+                return "Indirect";
+            case SubmissionMode::CpuCulled:
+                return "CPU culled";
+            case SubmissionMode::GpuCulled:
+                return "GPU culled";
+            default:
+                return "";
+        }
+    }
+
+}
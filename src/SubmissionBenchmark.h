@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace Vulkandemo {
+
+    enum class SubmissionMode {
+        // One draw per mesh with an instance count covering all of its instances
+        Instanced = 0,
+        // One draw (and push constant update) per instance, the way a renderer without instancing submits a scene
+        PerDraw,
+        // One draw command per instance written to a buffer, submitted with a single multi-draw indirect call
+        Indirect,
+        // Like Indirect, but only the instances that pass frustum culling on the CPU get a draw command
+        CpuCulled,
+        // Draw commands of the instances in view written by a compute shader, submitted with a single multi-draw indirect count call
+        GpuCulled
+    };
+
+}
+
+namespace Vulkandemo {
+
+    // Renders the scene with each submission mode in turn and logs the average CPU recording time and frame time of each.
+    // Run on a software implementation such as lavapipe to see the CPU cost of the submission model in the frame time as well.
+    class SubmissionBenchmark {
+    public:
+        struct Config {
+            bool Enabled = false;
+            // Not measured, lets pipeline compilation and caches settle after switching modes
+            uint32_t WarmupFrames = 100;
+            uint32_t MeasuredFrames = 500;
+        };
+
+    private:
+        struct Result {
+            double RecordMilliseconds = 0.0;
+            double FrameMilliseconds = 0.0;
+            uint64_t DrawnObjectCount = 0;
+            uint32_t FrameCount = 0;
+        };
+
+        // The first mode is the baseline the others are compared against
+        static constexpr std::array<SubmissionMode, 5> MODES = {
+                SubmissionMode::PerDraw,
+                SubmissionMode::Instanced,
+                SubmissionMode::Indirect,
+                SubmissionMode::CpuCulled,
+                SubmissionMode::GpuCulled
+        };
+
+    private:
+        Config config;
+        std::array<Result, MODES.size()> results{};
+        uint32_t modeIndex = 0;
+        uint32_t modeFrame = 0;
+        uint32_t objectCount = 0;
+        std::chrono::steady_clock::time_point lastFrameTime;
+        bool finished = false;
+
+    public:
+        explicit SubmissionBenchmark(Config config);
+
+        bool isEnabled() const;
+
+        bool isFinished() const;
+
+        SubmissionMode getMode() const;
+
+        // Called once per presented frame with the time spent recording its command buffer, the number of draw calls recorded and the number of
+        // objects of the scene that were tested for visibility and drawn
+        void addFrame(double recordMilliseconds, uint32_t drawCallCount, uint32_t testedObjectCount, uint32_t drawnObjectCount);
+
+        static const char* getModeAsString(SubmissionMode mode);
+
+    private:
+        void logResults() const;
+    };
+
+}
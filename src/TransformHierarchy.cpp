@@ -0,0 +1,221 @@
+#include "TransformHierarchy.h"
+#include "Assert.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Vulkandemo {
+
+    TransformHierarchy::TransformHierarchy(Config config, JobSystem* jobSystem) : config(config), jobSystem(jobSystem) {
+    }
+
+    uint32_t TransformHierarchy::add(const Transform& localTransform, uint32_t parent) {
+        VD_ASSERT(parent == NO_PARENT || parent < nodeDepths.size());
+        auto node = (uint32_t) nodeDepths.size();
+        uint32_t depth = parent == NO_PARENT ? 0 : nodeDepths[parent] + 1;
+        auto position = (uint32_t) nodes.size();
+        nodeDepths.push_back(depth);
+        nodePositions.push_back(position);
+
+        // Appended out of depth order until the next update sorts the arrays
+        nodes.push_back(node);
+        parentPositions.push_back(parent == NO_PARENT ? NO_PARENT : nodePositions[parent]);
+        localTransforms.push_back(localTransform);
+        worldMatrices.emplace_back(1.0f);
+        dirtyFlags.push_back(1);
+        worldVersions.push_back(0);
+        sorted = false;
+        firstDirtyDepth = 0;
+        return node;
+    }
+
+    void TransformHierarchy::setLocalTransform(uint32_t node, const Transform& localTransform) {
+        uint32_t position = nodePositions[node];
+        localTransforms[position] = localTransform;
+        dirtyFlags[position] = 1;
+        uint32_t depth = nodeDepths[node];
+        uint32_t dirtyDepth = firstDirtyDepth.load(std::memory_order_relaxed);
+        while (depth < dirtyDepth && !firstDirtyDepth.compare_exchange_weak(dirtyDepth, depth, std::memory_order_relaxed)) {
+        }
+    }
+
+    const Transform& TransformHierarchy::getLocalTransform(uint32_t node) const {
+        return localTransforms[nodePositions[node]];
+    }
+
+    const glm::mat4& TransformHierarchy::getWorldMatrix(uint32_t node) const {
+        return worldMatrices[nodePositions[node]];
+    }
+
+    uint32_t TransformHierarchy::getNodeCount() const {
+        return (uint32_t) nodes.size();
+    }
+
+    uint32_t TransformHierarchy::getDepthCount() const {
+        return levelOffsets.empty() ? 0 : (uint32_t) levelOffsets.size() - 1;
+    }
+
+    uint64_t TransformHierarchy::getVersion() const {
+        return version;
+    }
+
+    uint32_t TransformHierarchy::update() {
+        if (!sorted) {
+            sort();
+        }
+        uint32_t dirtyDepth = firstDirtyDepth.exchange(UINT32_MAX);
+        if (dirtyDepth >= getDepthCount()) {
+            return 0;
+        }
+
+        // Levels above the first dirty one cannot change. Below it a node is recomputed when it is dirty itself or its parent was recomputed by this
+        // update, which the parent's version tells since the parent's level is complete before the node's level starts.
+        uint64_t updateVersion = version + 1;
+        uint32_t updatedCount = 0;
+        for (uint32_t depth = dirtyDepth; depth < getDepthCount(); depth++) {
+            updatedCount += runParallel(levelOffsets[depth], levelOffsets[depth + 1], [this, updateVersion](uint32_t begin, uint32_t end) {
+                uint32_t rangeUpdatedCount = 0;
+                for (uint32_t position = begin; position < end; position++) {
+                    uint32_t parentPosition = parentPositions[position];
+                    bool parentUpdated = parentPosition != NO_PARENT && worldVersions[parentPosition] == updateVersion;
+                    if (!dirtyFlags[position] && !parentUpdated) {
+                        continue;
+                    }
+                    glm::mat4 localMatrix = getMatrix(localTransforms[position]);
+                    worldMatrices[position] = parentPosition == NO_PARENT ? localMatrix : worldMatrices[parentPosition] * localMatrix;
+                    worldVersions[position] = updateVersion;
+                    dirtyFlags[position] = 0;
+                    rangeUpdatedCount++;
+                }
+                return rangeUpdatedCount;
+            });
+        }
+        if (updatedCount > 0) {
+            version = updateVersion;
+        }
+        return updatedCount;
+    }
+
+    uint32_t TransformHierarchy::writeSnapshot(TransformSnapshot& snapshot) const {
+        uint64_t sinceVersion = snapshot.Version;
+        if (snapshot.WorldMatrices.size() != nodes.size()) {
+            snapshot.WorldMatrices.resize(nodes.size());
+            snapshot.WorldVersions.assign(nodes.size(), 0);
+            sinceVersion = 0;
+        }
+        snapshot.Version = version;
+        if (sinceVersion >= version) {
+            return 0;
+        }
+        return runParallel(0, getNodeCount(), [this, &snapshot, sinceVersion](uint32_t begin, uint32_t end) {
+            uint32_t copiedCount = 0;
+            for (uint32_t position = begin; position < end; position++) {
+                if (worldVersions[position] > sinceVersion) {
+                    uint32_t node = nodes[position];
+                    snapshot.WorldMatrices[node] = worldMatrices[position];
+                    snapshot.WorldVersions[node] = worldVersions[position];
+                    copiedCount++;
+                }
+            }
+            return copiedCount;
+        });
+    }
+
+    uint32_t TransformHierarchy::writeWorldMatrices(const TransformSnapshot& previous, const TransformSnapshot& current, float alpha, glm::mat4* output, uint64_t sinceVersion) const {
+        if (sinceVersion >= current.Version) {
+            return 0;
+        }
+        // A previous snapshot of a different size has nothing to blend from
+        uint64_t previousVersion = previous.WorldMatrices.size() == current.WorldMatrices.size() ? previous.Version : current.Version;
+        return runParallel(0, (uint32_t) current.WorldMatrices.size(), [&previous, &current, alpha, output, sinceVersion, previousVersion](uint32_t begin, uint32_t end) {
+            uint32_t writtenCount = 0;
+            for (uint32_t node = begin; node < end; node++) {
+                uint64_t worldVersion = current.WorldVersions[node];
+                if (worldVersion <= sinceVersion) {
+                    continue;
+                }
+                // Blending the matrices element by element slightly shrinks rotating nodes, which is invisible for the small change of one step
+                output[node] = worldVersion > previousVersion ? previous.WorldMatrices[node] + (current.WorldMatrices[node] - previous.WorldMatrices[node]) * alpha : current.WorldMatrices[node];
+                writtenCount++;
+            }
+            return writtenCount;
+        });
+    }
+
+    void TransformHierarchy::clear() {
+        nodeDepths.clear();
+        nodePositions.clear();
+        nodes.clear();
+        parentPositions.clear();
+        localTransforms.clear();
+        worldMatrices.clear();
+        dirtyFlags.clear();
+        worldVersions.clear();
+        levelOffsets.clear();
+        firstDirtyDepth = UINT32_MAX;
+        sorted = true;
+    }
+
+    void TransformHierarchy::sort() {
+        // Counting sort by depth, stable so nodes of a level stay in the order they were added
+        uint32_t depthCount = 0;
+        for (uint32_t depth : nodeDepths) {
+            depthCount = std::max(depthCount, depth + 1);
+        }
+        levelOffsets.assign(depthCount + 1, 0);
+        for (uint32_t depth : nodeDepths) {
+            levelOffsets[depth + 1]++;
+        }
+        for (uint32_t depth = 0; depth < depthCount; depth++) {
+            levelOffsets[depth + 1] += levelOffsets[depth];
+        }
+
+        std::vector<uint32_t> nextPositions(levelOffsets.begin(), levelOffsets.end() - 1);
+        std::vector<uint32_t> sortedNodes(nodes.size());
+        std::vector<uint32_t> sortedParentPositions(nodes.size());
+        std::vector<Transform> sortedLocalTransforms(nodes.size());
+        std::vector<glm::mat4> sortedWorldMatrices(nodes.size());
+        std::vector<uint8_t> sortedDirtyFlags(nodes.size());
+        std::vector<uint64_t> sortedWorldVersions(nodes.size());
+        for (uint32_t node = 0; node < nodeDepths.size(); node++) {
+            uint32_t oldPosition = nodePositions[node];
+            uint32_t position = nextPositions[nodeDepths[node]]++;
+            // Parents precede their children in node order, so the parent has already moved
+            uint32_t parentPosition = parentPositions[oldPosition];
+            sortedNodes[position] = node;
+            sortedParentPositions[position] = parentPosition == NO_PARENT ? NO_PARENT : nodePositions[nodes[parentPosition]];
+            sortedLocalTransforms[position] = localTransforms[oldPosition];
+            sortedWorldMatrices[position] = worldMatrices[oldPosition];
+            sortedDirtyFlags[position] = dirtyFlags[oldPosition];
+            sortedWorldVersions[position] = worldVersions[oldPosition];
+            nodePositions[node] = position;
+        }
+        nodes = std::move(sortedNodes);
+        parentPositions = std::move(sortedParentPositions);
+        localTransforms = std::move(sortedLocalTransforms);
+        worldMatrices = std::move(sortedWorldMatrices);
+        dirtyFlags = std::move(sortedDirtyFlags);
+        worldVersions = std::move(sortedWorldVersions);
+        sorted = true;
+    }
+
+    glm::mat4 TransformHierarchy::getMatrix(const Transform& transform) {
+        float c = std::cos(transform.Rotation) * transform.Scale;
+        float s = std::sin(transform.Rotation) * transform.Scale;
+        glm::mat4 matrix(1.0f);
+        matrix[0] = glm::vec4(c, s, 0.0f, 0.0f);
+        matrix[1] = glm::vec4(-s, c, 0.0f, 0.0f);
+        matrix[2] = glm::vec4(0.0f, 0.0f, transform.Scale, 0.0f);
+        matrix[3] = glm::vec4(transform.Position.x, transform.Position.y, 0.0f, 1.0f);
+        return matrix;
+    }
+
+    uint32_t TransformHierarchy::runParallel(uint32_t begin, uint32_t end, const std::function<uint32_t(uint32_t, uint32_t)>& function) const {
+        std::atomic<uint32_t> result{0};
+        jobSystem->parallelFor(begin, end, config.MinNodesPerJob, [&function, &result](uint32_t rangeBegin, uint32_t rangeEnd) {
+            result.fetch_add(function(rangeBegin, rangeEnd), std::memory_order_relaxed);
+        });
+        return result.load();
+    }
+
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "JobSystem.h"
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Vulkandemo {
+
+    // Placement of a node relative to its parent in the xy plane
+    struct Transform {
+        glm::vec2 Position{0.0f};
+        float Scale = 1.0f;
+        // Radians around the z axis
+        float Rotation = 0.0f;
+    };
+
+    // Copy of the world matrices of a hierarchy that other threads can read while the hierarchy is updated. Indexed by node.
+    struct TransformSnapshot {
+        // Version of the hierarchy the snapshot was taken at
+        uint64_t Version = 0;
+        std::vector<glm::mat4> WorldMatrices;
+        std::vector<uint64_t> WorldVersions;
+    };
+
+}
+
+namespace Vulkandemo {
+
+    // Parent-child hierarchy of transforms stored in flat arrays sorted by depth, so every parent is updated before its children and every level
+    // can be split into jobs. Only nodes whose local transform changed and their descendants recompute their world matrix, and every world
+    // matrix remembers the update that last changed it, so copies of the matrices (e.g. in GPU buffers) are brought up to date incrementally.
+    class TransformHierarchy {
+    public:
+        struct Config {
+            // Smaller ranges of a level are not worth handing to another thread
+            uint32_t MinNodesPerJob = 16384;
+        };
+
+        static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+    private:
+        Config config;
+        JobSystem* jobSystem;
+        // Indexed by node
+        std::vector<uint32_t> nodeDepths;
+        std::vector<uint32_t> nodePositions;
+        // Indexed by position, sorted by depth and then by node
+        std::vector<uint32_t> nodes;
+        std::vector<uint32_t> parentPositions;
+        std::vector<Transform> localTransforms;
+        std::vector<glm::mat4> worldMatrices;
+        std::vector<uint8_t> dirtyFlags;
+        std::vector<uint64_t> worldVersions;
+        // Positions [levelOffsets[depth], levelOffsets[depth + 1]) hold the nodes of a depth
+        std::vector<uint32_t> levelOffsets;
+        std::atomic<uint32_t> firstDirtyDepth{UINT32_MAX};
+        uint64_t version = 0;
+        bool sorted = true;
+
+    public:
+        TransformHierarchy(Config config, JobSystem* jobSystem);
+
+        // The parent has to exist already. Returns the node, nodes are numbered from 0 in the order they are added.
+        uint32_t add(const Transform& localTransform, uint32_t parent = NO_PARENT);
+
+        // Safe to call from several threads as long as they set different nodes
+        void setLocalTransform(uint32_t node, const Transform& localTransform);
+
+        const Transform& getLocalTransform(uint32_t node) const;
+
+        // As of the last update
+        const glm::mat4& getWorldMatrix(uint32_t node) const;
+
+        uint32_t getNodeCount() const;
+
+        uint32_t getDepthCount() const;
+
+        // Number of updates that changed at least one world matrix
+        uint64_t getVersion() const;
+
+        // Recomputes the world matrices of the changed nodes and their descendants one level at a time, returns the number of recomputed matrices
+        uint32_t update();
+
+        // Brings the snapshot up to the current version by copying only the world matrices that changed since it was taken, returns the number of
+        // copied matrices
+        uint32_t writeSnapshot(TransformSnapshot& snapshot) const;
+
+        // Writes the world matrices that changed after the given version to output[node], returns the number of written matrices. Matrices that
+        // changed between the two snapshots are blended from previous to current by alpha, so output written with a previous version at or below
+        // that of the previous snapshot is complete. Only reads the snapshots, so it can run while another thread updates the hierarchy.
+        uint32_t writeWorldMatrices(const TransformSnapshot& previous, const TransformSnapshot& current, float alpha, glm::mat4* output, uint64_t sinceVersion) const;
+
+        void clear();
+
+    private:
+        void sort();
+
+        static glm::mat4 getMatrix(const Transform& transform);
+
+        // Splits [begin, end) into jobs and returns the sum of what the ranges return
+        uint32_t runParallel(uint32_t begin, uint32_t end, const std::function<uint32_t(uint32_t, uint32_t)>& function) const;
+    };
+
+}
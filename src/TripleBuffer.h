@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Vulkandemo {
+
+    // Hands values from one producer thread to one consumer thread without locks and without either of them ever waiting for the other. The
+    // producer fills the back slot and publishes it, the consumer takes the most recently published slot, and values the consumer did not get to
+    // in time are overwritten. Slots are reused, so a slot holds whatever was written to it the last time it was the back slot.
+    template<typename T>
+    class TripleBuffer {
+    private:
+        static constexpr uint32_t INDEX_MASK = 3;
+        // Set in middle while it holds a published value the consumer has not taken yet
+        static constexpr uint32_t PUBLISHED_BIT = 4;
+
+        std::array<T, 3> slots{};
+        // Owned by the producer
+        uint32_t back = 0;
+        std::atomic<uint32_t> middle{1};
+        // Owned by the consumer
+        uint32_t front = 2;
+
+    public:
+        // For initialization, before either thread runs
+        std::array<T, 3>& getSlots() {
+            return slots;
+        }
+
+        // Producer only
+        T& getBack() {
+            return slots[back];
+        }
+
+        // Producer only. Makes the back slot the most recently published one and continues with another slot.
+        void publish() {
+            back = middle.exchange(back | PUBLISHED_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+
+        // Consumer only. Makes the most recently published slot the front slot, returns false (keeping the front slot) if nothing was published
+        // since the last call.
+        bool acquire() {
+            if ((middle.load(std::memory_order_relaxed) & PUBLISHED_BIT) == 0) {
+                return false;
+            }
+            front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+            return true;
+        }
+
+        // Consumer only
+        const T& getFront() const {
+            return slots[front];
+        }
+    };
+
+}
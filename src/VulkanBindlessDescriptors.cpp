@@ -0,0 +1,206 @@
+#include "VulkanBindlessDescriptors.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <array>
+
+namespace Vulkandemo {
+
+    const VkAllocationCallbacks* VulkanBindlessDescriptors::ALLOCATOR = VK_NULL_HANDLE;
+
+    VulkanBindlessDescriptors::VulkanBindlessDescriptors(Config config, VulkanPhysicalDevice* vulkanPhysicalDevice, VulkanDevice* vulkanDevice)
+            : config(config), vulkanPhysicalDevice(vulkanPhysicalDevice), vulkanDevice(vulkanDevice) {
+    }
+
+    bool VulkanBindlessDescriptors::initialize() {
+        const VkPhysicalDeviceDescriptorIndexingProperties& properties = vulkanPhysicalDevice->getDescriptorIndexingProperties();
+        sampledImageSlots.Capacity = std::min({config.MaxSampledImages, properties.maxDescriptorSetUpdateAfterBindSampledImages, properties.maxPerStageDescriptorUpdateAfterBindSampledImages});
+        storageBufferSlots.Capacity = std::min({config.MaxStorageBuffers, properties.maxDescriptorSetUpdateAfterBindStorageBuffers, properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers});
+        samplerSlots.Capacity = std::min({config.MaxSamplers, properties.maxDescriptorSetUpdateAfterBindSamplers, properties.maxPerStageDescriptorUpdateAfterBindSamplers});
+
+        // Samplers do not count as resources
+        uint64_t resourceCount = (uint64_t) sampledImageSlots.Capacity + storageBufferSlots.Capacity;
+        uint64_t maxResourceCount = properties.maxPerStageUpdateAfterBindResources > config.ReservedPerStageResources ? properties.maxPerStageUpdateAfterBindResources - config.ReservedPerStageResources : 0;
+        if (resourceCount > maxResourceCount) {
+            sampledImageSlots.Capacity = (uint32_t) (sampledImageSlots.Capacity * maxResourceCount / resourceCount);
+            storageBufferSlots.Capacity = (uint32_t) (storageBufferSlots.Capacity * maxResourceCount / resourceCount);
+            VD_LOG_WARN("Could not fit [{}] bindless resources into the per-stage limit of [{}] resources, scaled down to [{}] sampled images and [{}] storage buffers", resourceCount, properties.maxPerStageUpdateAfterBindResources, sampledImageSlots.Capacity, storageBufferSlots.Capacity);
+        }
+
+        sampledImageSlots.Used.assign(sampledImageSlots.Capacity, false);
+        storageBufferSlots.Used.assign(storageBufferSlots.Capacity, false);
+        samplerSlots.Used.assign(samplerSlots.Capacity, false);
+
+        std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+        bindings[0] = {SAMPLED_IMAGE_BINDING, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, sampledImageSlots.Capacity, VK_SHADER_STAGE_ALL, nullptr};
+        bindings[1] = {STORAGE_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, storageBufferSlots.Capacity, VK_SHADER_STAGE_ALL, nullptr};
+        bindings[2] = {SAMPLER_BINDING, VK_DESCRIPTOR_TYPE_SAMPLER, samplerSlots.Capacity, VK_SHADER_STAGE_ALL, nullptr};
+
+        // Partially bound: unused elements may hold no (or stale) descriptors as long as shaders do not access them.
+        // Update after bind: elements may be written while the set is bound by command buffers that are recorded or pending.
+        constexpr VkDescriptorBindingFlags bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+        std::array<VkDescriptorBindingFlags, 3> allBindingFlags = {bindingFlags, bindingFlags, bindingFlags};
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+        bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        bindingFlagsInfo.bindingCount = allBindingFlags.size();
+        bindingFlagsInfo.pBindingFlags = allBindingFlags.data();
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.pNext = &bindingFlagsInfo;
+        layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        layoutInfo.bindingCount = bindings.size();
+        layoutInfo.pBindings = bindings.data();
+        if (vkCreateDescriptorSetLayout(vulkanDevice->getDevice(), &layoutInfo, ALLOCATOR, &descriptorSetLayout) != VK_SUCCESS) {
+            VD_LOG_ERROR("Could not create bindless Vulkan descriptor set layout");
+            return false;
+        }
+
+        std::array<VkDescriptorPoolSize, 3> poolSizes{};
+        poolSizes[0] = {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, sampledImageSlots.Capacity};
+        poolSizes[1] = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, storageBufferSlots.Capacity};
+        poolSizes[2] = {VK_DESCRIPTOR_TYPE_SAMPLER, samplerSlots.Capacity};
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        poolInfo.maxSets = 1;
+        poolInfo.poolSizeCount = poolSizes.size();
+        poolInfo.pPoolSizes = poolSizes.data();
+        if (vkCreateDescriptorPool(vulkanDevice->getDevice(), &poolInfo, ALLOCATOR, &descriptorPool) != VK_SUCCESS) {
+            VD_LOG_ERROR("Could not create bindless Vulkan descriptor pool");
+            return false;
+        }
+
+        VkDescriptorSetAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.descriptorPool = descriptorPool;
+        allocateInfo.descriptorSetCount = 1;
+        allocateInfo.pSetLayouts = &descriptorSetLayout;
+        if (vkAllocateDescriptorSets(vulkanDevice->getDevice(), &allocateInfo, &descriptorSet) != VK_SUCCESS) {
+            VD_LOG_ERROR("Could not allocate bindless Vulkan descriptor set");
+            return false;
+        }
+        VD_LOG_INFO("Created bindless Vulkan descriptor set with [{}] sampled images, [{}] storage buffers and [{}] samplers", sampledImageSlots.Capacity, storageBufferSlots.Capacity, samplerSlots.Capacity);
+        return true;
+    }
+
+    void VulkanBindlessDescriptors::terminate() {
+        vkDestroyDescriptorPool(vulkanDevice->getDevice(), descriptorPool, ALLOCATOR);
+        vkDestroyDescriptorSetLayout(vulkanDevice->getDevice(), descriptorSetLayout, ALLOCATOR);
+        descriptorSet = VK_NULL_HANDLE;
+        VD_LOG_INFO("Destroyed bindless Vulkan descriptor set");
+    }
+
+    VkDescriptorSetLayout VulkanBindlessDescriptors::getDescriptorSetLayout() const {
+        return descriptorSetLayout;
+    }
+
+    void VulkanBindlessDescriptors::bind(const VulkanCommandBuffer& vulkanCommandBuffer, VkPipelineLayout pipelineLayout, VkPipelineBindPoint bindPoint) const {
+        constexpr uint32_t descriptorSetCount = 1;
+        constexpr uint32_t dynamicOffsetCount = 0;
+        vkCmdBindDescriptorSets(vulkanCommandBuffer.getCommandBuffer(), bindPoint, pipelineLayout, BINDLESS_SET, descriptorSetCount, &descriptorSet, dynamicOffsetCount, nullptr);
+    }
+
+    uint32_t VulkanBindlessDescriptors::registerSampledImage(VkImageView imageView, VkImageLayout imageLayout) {
+        std::lock_guard<std::mutex> lock(mutex);
+        uint32_t index = acquireIndex(sampledImageSlots);
+        if (index == INVALID_INDEX) {
+            VD_LOG_ERROR("Could not register sampled image, all [{}] bindless slots are in use", sampledImageSlots.Capacity);
+            return INVALID_INDEX;
+        }
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.imageView = imageView;
+        imageInfo.imageLayout = imageLayout;
+        write(SAMPLED_IMAGE_BINDING, index, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &imageInfo, nullptr);
+        return index;
+    }
+
+    uint32_t VulkanBindlessDescriptors::registerStorageBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+        std::lock_guard<std::mutex> lock(mutex);
+        uint32_t index = acquireIndex(storageBufferSlots);
+        if (index == INVALID_INDEX) {
+            VD_LOG_ERROR("Could not register storage buffer, all [{}] bindless slots are in use", storageBufferSlots.Capacity);
+            return INVALID_INDEX;
+        }
+        VkDescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = buffer;
+        bufferInfo.offset = offset;
+        bufferInfo.range = range;
+        write(STORAGE_BUFFER_BINDING, index, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, &bufferInfo);
+        return index;
+    }
+
+    uint32_t VulkanBindlessDescriptors::registerSampler(VkSampler sampler) {
+        std::lock_guard<std::mutex> lock(mutex);
+        uint32_t index = acquireIndex(samplerSlots);
+        if (index == INVALID_INDEX) {
+            VD_LOG_ERROR("Could not register sampler, all [{}] bindless slots are in use", samplerSlots.Capacity);
+            return INVALID_INDEX;
+        }
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.sampler = sampler;
+        write(SAMPLER_BINDING, index, VK_DESCRIPTOR_TYPE_SAMPLER, &imageInfo, nullptr);
+        return index;
+    }
+
+    void VulkanBindlessDescriptors::releaseSampledImage(uint32_t index) {
+        releaseIndex(sampledImageSlots, index);
+    }
+
+    void VulkanBindlessDescriptors::releaseStorageBuffer(uint32_t index) {
+        releaseIndex(storageBufferSlots, index);
+    }
+
+    void VulkanBindlessDescriptors::releaseSampler(uint32_t index) {
+        releaseIndex(samplerSlots, index);
+    }
+
+    uint32_t VulkanBindlessDescriptors::acquireIndex(Slots& slots) {
+        uint32_t index;
+        if (!slots.FreeIndices.empty()) {
+            index = slots.FreeIndices.back();
+            slots.FreeIndices.pop_back();
+        } else if (slots.NextIndex < slots.Capacity) {
+            index = slots.NextIndex++;
+        } else {
+            return INVALID_INDEX;
+        }
+        slots.Used[index] = true;
+        return index;
+    }
+
+    void VulkanBindlessDescriptors::releaseIndex(Slots& slots, uint32_t index) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (index >= slots.NextIndex || !slots.Used[index]) {
+                VD_LOG_WARN("Could not release bindless index [{}] that is not registered", index);
+                return;
+            }
+            slots.Used[index] = false;
+        }
+        // Update after bind with UPDATE_UNUSED_WHILE_PENDING only allows writing descriptors that no pending command buffer uses
+        vulkanDevice->getDeletionQueue()->destroyLater([this, &slots, index]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            slots.FreeIndices.push_back(index);
+        });
+    }
+
+    void VulkanBindlessDescriptors::write(uint32_t binding, uint32_t index, VkDescriptorType descriptorType, const VkDescriptorImageInfo* imageInfo, const VkDescriptorBufferInfo* bufferInfo) const {
+        VkWriteDescriptorSet descriptorWrite{};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = descriptorSet;
+        descriptorWrite.dstBinding = binding;
+        descriptorWrite.dstArrayElement = index;
+        descriptorWrite.descriptorType = descriptorType;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pImageInfo = imageInfo;
+        descriptorWrite.pBufferInfo = bufferInfo;
+
+        constexpr uint32_t descriptorWriteCount = 1;
+        constexpr uint32_t descriptorCopyCount = 0;
+        vkUpdateDescriptorSets(vulkanDevice->getDevice(), descriptorWriteCount, &descriptorWrite, descriptorCopyCount, nullptr);
+    }
+
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "VulkanPhysicalDevice.h"
+#include "VulkanDevice.h"
+#include "VulkanCommandBuffer.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Vulkandemo {
+
+    // One update-after-bind descriptor set holding large partially bound arrays of every sampled image, storage buffer and sampler.
+    // It is bound once per frame and shaders select resources by the array indices returned from the register functions,
+    // which draws pass as push constants instead of binding descriptor sets per draw.
+    //
+    // GLSL declarations matching the layout (set = BINDLESS_SET):
+    //   layout(set = 0, binding = 0) uniform texture2D textures[];
+    //   layout(set = 0, binding = 1) buffer Buffer { ... } buffers[];
+    //   layout(set = 0, binding = 2) uniform sampler samplers[];
+    class VulkanBindlessDescriptors {
+    public:
+        static constexpr uint32_t BINDLESS_SET = 0;
+        static constexpr uint32_t SAMPLED_IMAGE_BINDING = 0;
+        static constexpr uint32_t STORAGE_BUFFER_BINDING = 1;
+        static constexpr uint32_t SAMPLER_BINDING = 2;
+        static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+        // Clamped to the update-after-bind limits of the device. Every array is visible to all stages, so sampled images and storage buffers are
+        // scaled down together until they fit the per-stage resource limit next to ReservedPerStageResources.
+        struct Config {
+            uint32_t MaxSampledImages = 16384;
+            uint32_t MaxStorageBuffers = 16384;
+            uint32_t MaxSamplers = 64;
+            // Per-stage resources left to the other descriptor sets of pipelines using the bindless set
+            uint32_t ReservedPerStageResources = 32;
+        };
+
+    private:
+        static const VkAllocationCallbacks* ALLOCATOR;
+
+    private:
+        struct Slots {
+            uint32_t Capacity = 0;
+            uint32_t NextIndex = 0;
+            std::vector<uint32_t> FreeIndices;
+            // Per index, false once released, so releasing twice is caught instead of handing the index out twice
+            std::vector<bool> Used;
+        };
+
+    private:
+        Config config;
+        VulkanPhysicalDevice* vulkanPhysicalDevice;
+        VulkanDevice* vulkanDevice;
+        std::mutex mutex;
+        VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+        VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        Slots sampledImageSlots;
+        Slots storageBufferSlots;
+        Slots samplerSlots;
+
+    public:
+        VulkanBindlessDescriptors(Config config, VulkanPhysicalDevice* vulkanPhysicalDevice, VulkanDevice* vulkanDevice);
+
+        bool initialize();
+
+        void terminate();
+
+        VkDescriptorSetLayout getDescriptorSetLayout() const;
+
+        // Binds the set once for every draw recorded afterwards with a pipeline layout that is compatible up to BINDLESS_SET
+        void bind(const VulkanCommandBuffer& vulkanCommandBuffer, VkPipelineLayout pipelineLayout, VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS) const;
+
+        // Return the array index of the resource, or INVALID_INDEX when the array is full.
+        // Writing is allowed while the set is bound by frames in flight, as long as those frames do not access the same index.
+        uint32_t registerSampledImage(VkImageView imageView, VkImageLayout imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+        uint32_t registerStorageBuffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+
+        uint32_t registerSampler(VkSampler sampler);
+
+        // The index is handed out again once the submissions made so far have completed, so frames in flight may still access it
+        void releaseSampledImage(uint32_t index);
+
+        void releaseStorageBuffer(uint32_t index);
+
+        void releaseSampler(uint32_t index);
+
+    private:
+        static uint32_t acquireIndex(Slots& slots);
+
+        // Must be called with the mutex unlocked
+        void releaseIndex(Slots& slots, uint32_t index);
+
+        void write(uint32_t binding, uint32_t index, VkDescriptorType descriptorType, const VkDescriptorImageInfo* imageInfo, const VkDescriptorBufferInfo* bufferInfo) const;
+    };
+
+}
@@ -0,0 +1,120 @@
+#include "VulkanBuffer.h"
+#include "Log.h"
+
+#include <cstring>
+
+namespace Vulkandemo {
+
+    const VkAllocationCallbacks* VulkanBuffer::ALLOCATOR = VK_NULL_HANDLE;
+
+    VulkanBuffer::VulkanBuffer(VulkanPhysicalDevice* vulkanPhysicalDevice, VulkanDevice* vulkanDevice) : vulkanPhysicalDevice(vulkanPhysicalDevice), vulkanDevice(vulkanDevice) {
+    }
+
+    bool VulkanBuffer::initialize(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags memoryProperties) {
+        this->size = size;
+
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (vkCreateBuffer(vulkanDevice->getDevice(), &bufferInfo, ALLOCATOR, &buffer) != VK_SUCCESS) {
+            VD_LOG_ERROR("Could not create Vulkan buffer of [{}] bytes", size);
+            return false;
+        }
+
+        VkMemoryRequirements memoryRequirements;
+        vkGetBufferMemoryRequirements(vulkanDevice->getDevice(), buffer, &memoryRequirements);
+
+        uint32_t memoryTypeIndex;
+        if (!findMemoryType(memoryRequirements.memoryTypeBits, memoryProperties, memoryTypeIndex, memoryPropertyFlags)) {
+            VD_LOG_ERROR("Could not find Vulkan memory type for buffer of [{}] bytes", size);
+            return false;
+        }
+
+        VkMemoryAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = memoryRequirements.size;
+        allocateInfo.memoryTypeIndex = memoryTypeIndex;
+        if (vkAllocateMemory(vulkanDevice->getDevice(), &allocateInfo, ALLOCATOR, &memory) != VK_SUCCESS) {
+            VD_LOG_ERROR("Could not allocate [{}] bytes of Vulkan memory", memoryRequirements.size);
+            return false;
+        }
+
+        constexpr VkDeviceSize memoryOffset = 0;
+        if (vkBindBufferMemory(vulkanDevice->getDevice(), buffer, memory, memoryOffset) != VK_SUCCESS) {
+            VD_LOG_ERROR("Could not bind Vulkan buffer memory");
+            return false;
+        }
+
+        if (memoryProperties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+            constexpr VkMemoryMapFlags mapFlags = 0;
+            if (vkMapMemory(vulkanDevice->getDevice(), memory, memoryOffset, VK_WHOLE_SIZE, mapFlags, &mappedData) != VK_SUCCESS) {
+                VD_LOG_ERROR("Could not map Vulkan buffer memory");
+                return false;
+            }
+        }
+        VD_LOG_DEBUG("Created Vulkan buffer of [{}] bytes", size);
+        return true;
+    }
+
+    void VulkanBuffer::terminate() {
+        // Freeing the memory unmaps it as well
+        vulkanDevice->getDeletionQueue()->destroyLater([device = vulkanDevice->getDevice(), buffer = buffer, memory = memory, size = size]() {
+            vkDestroyBuffer(device, buffer, ALLOCATOR);
+            vkFreeMemory(device, memory, ALLOCATOR);
+            VD_LOG_DEBUG("Destroyed Vulkan buffer of [{}] bytes", size);
+        });
+        mappedData = nullptr;
+        buffer = VK_NULL_HANDLE;
+        memory = VK_NULL_HANDLE;
+    }
+
+    VkBuffer VulkanBuffer::getBuffer() const {
+        return buffer;
+    }
+
+    VkDeviceSize VulkanBuffer::getSize() const {
+        return size;
+    }
+
+    void* VulkanBuffer::getMappedData() const {
+        return mappedData;
+    }
+
+    bool VulkanBuffer::write(const void* data, VkDeviceSize dataSize, VkDeviceSize offset) const {
+        if (mappedData == nullptr || offset + dataSize > size) {
+            VD_LOG_ERROR("Could not write [{}] bytes at offset [{}] to Vulkan buffer of [{}] bytes", dataSize, offset, size);
+            return false;
+        }
+        memcpy((char*) mappedData + offset, data, dataSize);
+        if (memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
+            return true;
+        }
+
+        // Flushing the whole allocation avoids aligning the range to nonCoherentAtomSize
+        VkMappedMemoryRange memoryRange{};
+        memoryRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        memoryRange.memory = memory;
+        memoryRange.offset = 0;
+        memoryRange.size = VK_WHOLE_SIZE;
+        constexpr uint32_t memoryRangeCount = 1;
+        return vkFlushMappedMemoryRanges(vulkanDevice->getDevice(), memoryRangeCount, &memoryRange) == VK_SUCCESS;
+    }
+
+    bool VulkanBuffer::findMemoryType(uint32_t memoryTypeBits, VkMemoryPropertyFlags memoryProperties, uint32_t& memoryTypeIndex, VkMemoryPropertyFlags& memoryTypeProperties) const {
+        VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(vulkanPhysicalDevice->getPhysicalDevice(), &physicalDeviceMemoryProperties);
+        for (uint32_t i = 0; i < physicalDeviceMemoryProperties.memoryTypeCount; i++) {
+            bool allowed = memoryTypeBits & (1u << i);
+            bool hasProperties = (physicalDeviceMemoryProperties.memoryTypes[i].propertyFlags & memoryProperties) == memoryProperties;
+            if (allowed && hasProperties) {
+                memoryTypeIndex = i;
+                memoryTypeProperties = physicalDeviceMemoryProperties.memoryTypes[i].propertyFlags;
+                return true;
+            }
+        }
+        return false;
+    }
+
+}
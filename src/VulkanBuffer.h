@@ -0,0 +1,46 @@
+#pragma once
+
+#include "VulkanPhysicalDevice.h"
+#include "VulkanDevice.h"
+
+#include <vulkan/vulkan.h>
+
+namespace Vulkandemo {
+
+    // A buffer with its own device memory allocation. Host visible memory stays mapped for the lifetime of the buffer.
+    class VulkanBuffer {
+    private:
+        static const VkAllocationCallbacks* ALLOCATOR;
+
+    private:
+        VulkanPhysicalDevice* vulkanPhysicalDevice;
+        VulkanDevice* vulkanDevice;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize size = 0;
+        VkMemoryPropertyFlags memoryPropertyFlags = 0;
+        void* mappedData = nullptr;
+
+    public:
+        VulkanBuffer(VulkanPhysicalDevice* vulkanPhysicalDevice, VulkanDevice* vulkanDevice);
+
+        bool initialize(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags memoryProperties);
+
+        // Goes through the deletion queue, so submissions made so far may still use the buffer
+        void terminate();
+
+        VkBuffer getBuffer() const;
+
+        VkDeviceSize getSize() const;
+
+        // nullptr unless the memory is host visible
+        void* getMappedData() const;
+
+        // Copies into mapped memory, flushing it when it is not host coherent
+        bool write(const void* data, VkDeviceSize dataSize, VkDeviceSize offset = 0) const;
+
+    private:
+        bool findMemoryType(uint32_t memoryTypeBits, VkMemoryPropertyFlags memoryProperties, uint32_t& memoryTypeIndex, VkMemoryPropertyFlags& memoryTypeProperties) const;
+    };
+
+}
@@ -0,0 +1,84 @@
+#include "VulkanComputePipeline.h"
+#include "Log.h"
+
+#include <vector>
+
+namespace Vulkandemo {
+
+    const VkAllocationCallbacks* VulkanComputePipeline::ALLOCATOR = VK_NULL_HANDLE;
+
+    VulkanComputePipeline::VulkanComputePipeline(VulkanDevice* vulkanDevice, VulkanLayoutCache* vulkanLayoutCache)
+        : vulkanDevice(vulkanDevice), vulkanLayoutCache(vulkanLayoutCache) {
+    }
+
+    bool VulkanComputePipeline::initialize(const ComputePipelineDescription& description, VkPipelineCache pipelineCache) {
+        if (description.Shader == nullptr || description.Shader->getReflection().getStage() != VK_SHADER_STAGE_COMPUTE_BIT) {
+            VD_LOG_ERROR("Could not use description without compute shader for Vulkan compute pipeline");
+            return false;
+        }
+        const VulkanShader& shader = *description.Shader;
+
+        std::vector<VkSpecializationMapEntry> mapEntries;
+        std::vector<uint32_t> specializationData;
+        description.Specialization.getMapEntries(shader.getReflection(), mapEntries, specializationData);
+        VkSpecializationInfo specializationInfo{};
+        specializationInfo.mapEntryCount = (uint32_t) mapEntries.size();
+        specializationInfo.pMapEntries = mapEntries.data();
+        specializationInfo.dataSize = specializationData.size() * sizeof(uint32_t);
+        specializationInfo.pData = specializationData.data();
+
+        VkPipelineShaderStageCreateInfo shaderStageInfo{};
+        shaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        shaderStageInfo.module = shader.getShaderModule();
+        shaderStageInfo.pName = shader.getReflection().getEntryPoint().c_str();
+        shaderStageInfo.pSpecializationInfo = mapEntries.empty() ? nullptr : &specializationInfo;
+
+        pipelineLayout = vulkanLayoutCache->getPipelineLayout({&shader}, description.SetLayouts, description.PushConstants, pushConstantRange);
+        if (pipelineLayout == VK_NULL_HANDLE) {
+            VD_LOG_ERROR("Could not create Vulkan compute pipeline layout");
+            return false;
+        }
+
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage = shaderStageInfo;
+        pipelineInfo.layout = pipelineLayout;
+        pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineInfo.basePipelineIndex = -1;
+
+        constexpr int createInfoCount = 1;
+
+        if (vkCreateComputePipelines(vulkanDevice->getDevice(), pipelineCache, createInfoCount, &pipelineInfo, ALLOCATOR, &pipeline) != VK_SUCCESS) {
+            VD_LOG_ERROR("Could not create Vulkan compute pipeline");
+            return false;
+        }
+        VD_LOG_INFO("Created Vulkan compute pipeline");
+        return true;
+    }
+
+    void VulkanComputePipeline::terminate() {
+        vulkanDevice->getDeletionQueue()->destroyLater([device = vulkanDevice->getDevice(), pipeline = pipeline]() {
+            vkDestroyPipeline(device, pipeline, ALLOCATOR);
+            VD_LOG_INFO("Destroyed Vulkan compute pipeline");
+        });
+        pipeline = VK_NULL_HANDLE;
+    }
+
+    void VulkanComputePipeline::bind(const VulkanCommandBuffer& vulkanCommandBuffer) const {
+        vkCmdBindPipeline(vulkanCommandBuffer.getCommandBuffer(), VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    }
+
+    VkPipelineLayout VulkanComputePipeline::getPipelineLayout() const {
+        return pipelineLayout;
+    }
+
+    void VulkanComputePipeline::pushConstants(const VulkanCommandBuffer& vulkanCommandBuffer, const void* data, uint32_t size, uint32_t offset) const {
+        recordPushConstants(vulkanCommandBuffer, pipelineLayout, pushConstantRange, data, size, offset);
+    }
+
+    void VulkanComputePipeline::dispatch(const VulkanCommandBuffer& vulkanCommandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) const {
+        vkCmdDispatch(vulkanCommandBuffer.getCommandBuffer(), groupCountX, groupCountY, groupCountZ);
+    }
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "VulkanShader.h"
+#include "ShaderSpecialization.h"
+#include "VulkanLayoutCache.h"
+#include "VulkanDevice.h"
+#include "VulkanCommandBuffer.h"
+#include "VulkanPushConstants.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <map>
+
+namespace Vulkandemo {
+
+    // Everything that goes into a compute pipeline, see GraphicsPipelineDescription for the push constant block and set layouts
+    struct ComputePipelineDescription {
+        const VulkanShader* Shader = nullptr;
+        ShaderSpecialization Specialization;
+        VkPushConstantRange PushConstants{};
+        std::map<uint32_t, VkDescriptorSetLayout> SetLayouts;
+
+        template<typename T>
+        void declarePushConstants(uint32_t offset = 0) {
+            PushConstants = getPushConstantRange<T>(VK_SHADER_STAGE_COMPUTE_BIT, offset);
+        }
+    };
+
+}
+
+namespace Vulkandemo {
+
+    class VulkanComputePipeline {
+    private:
+        static const VkAllocationCallbacks* ALLOCATOR;
+
+    private:
+        VulkanDevice* vulkanDevice;
+        VulkanLayoutCache* vulkanLayoutCache;
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkPushConstantRange pushConstantRange{};
+
+    public:
+        VulkanComputePipeline(VulkanDevice* vulkanDevice, VulkanLayoutCache* vulkanLayoutCache);
+
+        bool initialize(const ComputePipelineDescription& description, VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+
+        void terminate();
+
+        void bind(const VulkanCommandBuffer& vulkanCommandBuffer) const;
+
+        // Owned by the layout cache
+        VkPipelineLayout getPipelineLayout() const;
+
+        void pushConstants(const VulkanCommandBuffer& vulkanCommandBuffer, const void* data, uint32_t size, uint32_t offset = 0) const;
+
+        template<typename T>
+        void pushConstants(const VulkanCommandBuffer& vulkanCommandBuffer, const T& constants, uint32_t offset = 0) const {
+            pushConstants(vulkanCommandBuffer, &constants, getPushConstantSize<T>(), offset);
+        }
+
+        void dispatch(const VulkanCommandBuffer& vulkanCommandBuffer, uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) const;
+    };
+
+}
@@ -0,0 +1,120 @@
+#include "VulkanCullingPass.h"
+#include "Log.h"
+
+namespace Vulkandemo {
+
+    // Matches the push constant block of cull.comp
+    struct CullingConstants {
+        glm::vec4 FrustumPlanes[Frustum::PLANE_COUNT];
+        uint32_t ObjectCount;
+        uint32_t ObjectBufferIndex;
+        uint32_t InstanceBufferIndex;
+        uint32_t DrawCommandBufferIndex;
+        uint32_t TransformBufferIndex;
+    };
+
+    VulkanCullingPass::VulkanCullingPass(
+            Config config,
+            VulkanPhysicalDevice* vulkanPhysicalDevice,
+            VulkanDevice* vulkanDevice,
+            VulkanLayoutCache* vulkanLayoutCache,
+            VulkanBindlessDescriptors* vulkanBindlessDescriptors
+    )
+            : config(config),
+              vulkanPhysicalDevice(vulkanPhysicalDevice),
+              vulkanDevice(vulkanDevice),
+              vulkanBindlessDescriptors(vulkanBindlessDescriptors),
+              pipeline(vulkanDevice, vulkanLayoutCache),
+              objectBuffer(vulkanPhysicalDevice, vulkanDevice),
+              testedObjectCounts(config.FrameCount, 0) {
+    }
+
+    bool VulkanCullingPass::initialize(const VulkanShader* computeShader, const std::vector<CullingObject>& objects, const VulkanIndirectDrawBuffer& drawList) {
+        objectCount = (uint32_t) objects.size();
+        if (!drawList.isDrawCountSupported()) {
+            VD_LOG_WARN("Could not draw the culled draw list with a count, GPU culling is disabled");
+            return true;
+        }
+        uint32_t maxGroupCount = vulkanPhysicalDevice->getProperties().limits.maxComputeWorkGroupCount[0];
+        if ((objectCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE > maxGroupCount) {
+            VD_LOG_WARN("Could not cull [{}] objects in one dispatch of at most [{}] workgroups, GPU culling is disabled", objectCount, maxGroupCount);
+            return true;
+        }
+
+        ComputePipelineDescription description;
+        description.Shader = computeShader;
+        description.declarePushConstants<CullingConstants>();
+        description.SetLayouts[VulkanBindlessDescriptors::BINDLESS_SET] = vulkanBindlessDescriptors->getDescriptorSetLayout();
+        if (!pipeline.initialize(description)) {
+            VD_LOG_ERROR("Could not create Vulkan culling pipeline");
+            return false;
+        }
+
+        VkDeviceSize objectsSize = objects.size() * sizeof(CullingObject);
+        VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        if (!objectBuffer.initialize(objectsSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, memoryProperties) || !objectBuffer.write(objects.data(), objectsSize)) {
+            VD_LOG_ERROR("Could not create Vulkan culling object buffer");
+            return false;
+        }
+        objectBufferIndex = vulkanBindlessDescriptors->registerStorageBuffer(objectBuffer.getBuffer());
+        if (objectBufferIndex == VulkanBindlessDescriptors::INVALID_INDEX) {
+            VD_LOG_ERROR("Could not register Vulkan culling object buffer");
+            return false;
+        }
+        supported = true;
+        VD_LOG_INFO("Created Vulkan culling pass for [{}] objects", objectCount);
+        return true;
+    }
+
+    void VulkanCullingPass::terminate() {
+        if (!supported) {
+            return;
+        }
+        vulkanBindlessDescriptors->releaseStorageBuffer(objectBufferIndex);
+        objectBuffer.terminate();
+        pipeline.terminate();
+        supported = false;
+        VD_LOG_INFO("Destroyed Vulkan culling pass");
+    }
+
+    bool VulkanCullingPass::isSupported() const {
+        return supported;
+    }
+
+    void VulkanCullingPass::beginFrame(uint32_t frameIndex, const VulkanIndirectDrawBuffer& drawList) {
+        currentFrame = frameIndex;
+        uint32_t& testedObjectCount = testedObjectCounts[currentFrame];
+        if (testedObjectCount > 0) {
+            statistics.TestedObjectCount = testedObjectCount;
+            statistics.DrawnObjectCount = drawList.getDrawCount();
+        }
+        testedObjectCount = 0;
+    }
+
+    const VulkanCullingPass::Statistics& VulkanCullingPass::getStatistics() const {
+        return statistics;
+    }
+
+    void VulkanCullingPass::record(const VulkanCommandBuffer& vulkanCommandBuffer, const Frustum& frustum, uint32_t instanceBufferIndex, uint32_t transformBufferIndex, const VulkanIndirectDrawBuffer& drawList) {
+        // Host writes are visible to the commands of later submissions, so the counter can be reset from the CPU
+        drawList.setDrawCount(0);
+
+        CullingConstants constants{};
+        for (int i = 0; i < Frustum::PLANE_COUNT; i++) {
+            constants.FrustumPlanes[i] = frustum.Planes[i];
+        }
+        constants.ObjectCount = objectCount;
+        constants.ObjectBufferIndex = objectBufferIndex;
+        constants.InstanceBufferIndex = instanceBufferIndex;
+        constants.DrawCommandBufferIndex = drawList.getBindlessIndex();
+        constants.TransformBufferIndex = transformBufferIndex;
+
+        pipeline.bind(vulkanCommandBuffer);
+        vulkanBindlessDescriptors->bind(vulkanCommandBuffer, pipeline.getPipelineLayout(), VK_PIPELINE_BIND_POINT_COMPUTE);
+        pipeline.pushConstants(vulkanCommandBuffer, constants);
+        pipeline.dispatch(vulkanCommandBuffer, (objectCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE);
+
+        testedObjectCounts[currentFrame] = objectCount;
+    }
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Frustum.h"
+#include "InstancedScene.h"
+#include "VulkanPhysicalDevice.h"
+#include "VulkanDevice.h"
+#include "VulkanShader.h"
+#include "VulkanLayoutCache.h"
+#include "VulkanBuffer.h"
+#include "VulkanBindlessDescriptors.h"
+#include "VulkanComputePipeline.h"
+#include "VulkanIndirectDrawBuffer.h"
+#include "VulkanCommandBuffer.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace Vulkandemo {
+
+    // Compute pass recorded before the render pass that tests the bounding sphere of every object against the view frustum and appends a draw command
+    // for each visible one to the frame's indirect draw buffer through an atomic counter. The draw count never leaves the GPU, the scene is drawn with
+    // VulkanIndirectDrawBuffer::drawWithCount, so the CPU does not touch the object list at all. Requires draw indirect count support.
+    class VulkanCullingPass {
+    public:
+        struct Config {
+            uint32_t FrameCount = 2;
+        };
+
+        struct Statistics {
+            uint32_t TestedObjectCount = 0;
+            uint32_t DrawnObjectCount = 0;
+        };
+
+    private:
+        // Matches local_size_x of cull.comp
+        static constexpr uint32_t WORKGROUP_SIZE = 64;
+
+    private:
+        Config config;
+        VulkanPhysicalDevice* vulkanPhysicalDevice;
+        VulkanDevice* vulkanDevice;
+        VulkanBindlessDescriptors* vulkanBindlessDescriptors;
+        VulkanComputePipeline pipeline;
+        VulkanBuffer objectBuffer;
+        uint32_t objectBufferIndex = VulkanBindlessDescriptors::INVALID_INDEX;
+        uint32_t objectCount = 0;
+        // Objects tested by the pass last recorded in each frame slot, 0 if the slot was drawn without culling
+        std::vector<uint32_t> testedObjectCounts;
+        uint32_t currentFrame = 0;
+        Statistics statistics;
+        bool supported = false;
+
+    public:
+        VulkanCullingPass(
+                Config config,
+                VulkanPhysicalDevice* vulkanPhysicalDevice,
+                VulkanDevice* vulkanDevice,
+                VulkanLayoutCache* vulkanLayoutCache,
+                VulkanBindlessDescriptors* vulkanBindlessDescriptors
+        );
+
+        // Succeeds without creating anything when the device cannot cull on the GPU or draw drawList with a count, see isSupported
+        bool initialize(const VulkanShader* computeShader, const std::vector<CullingObject>& objects, const VulkanIndirectDrawBuffer& drawList);
+
+        void terminate();
+
+        bool isSupported() const;
+
+        // Collects the statistics of the last pass recorded in the frame slot from drawList, call once the fence of the frame has been waited on
+        void beginFrame(uint32_t frameIndex, const VulkanIndirectDrawBuffer& drawList);
+
+        // Statistics of the most recent frame that has completed on the GPU
+        const Statistics& getStatistics() const;
+
+        // Must be recorded outside of a render pass. Instances are read from the bindless storage buffer instanceBufferIndex, in the same order as the
+        // objects given to initialize, their world matrices from transformBufferIndex, and drawList must be registered with the bindless descriptors.
+        // The draw list is written in the compute shader stage, the barrier before it is drawn or read back is left to the render graph.
+        void record(const VulkanCommandBuffer& vulkanCommandBuffer, const Frustum& frustum, uint32_t instanceBufferIndex, uint32_t transformBufferIndex, const VulkanIndirectDrawBuffer& drawList);
+    };
+
+}
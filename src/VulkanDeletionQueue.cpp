@@ -0,0 +1,46 @@
+#include "VulkanDeletionQueue.h"
+
+#include <algorithm>
+
+namespace Vulkandemo {
+
+    uint64_t VulkanDeletionQueue::addSubmission() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return ++lastSubmission;
+    }
+
+    void VulkanDeletionQueue::destroyLater(const std::function<void()>& destroy) {
+        std::lock_guard<std::mutex> lock(mutex);
+        deletions.push_back({lastSubmission, destroy});
+    }
+
+    void VulkanDeletionQueue::complete(uint64_t submission) {
+        // Destroyed outside the lock, so destroying an object may retire others
+        std::vector<Deletion> completedDeletions;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            completedSubmission = std::max(completedSubmission, submission);
+            auto iterator = std::stable_partition(deletions.begin(), deletions.end(), [this](const Deletion& deletion) {
+                return deletion.Submission > completedSubmission;
+            });
+            completedDeletions.assign(std::make_move_iterator(iterator), std::make_move_iterator(deletions.end()));
+            deletions.erase(iterator, deletions.end());
+        }
+        for (const Deletion& deletion : completedDeletions) {
+            deletion.Destroy();
+        }
+    }
+
+    void VulkanDeletionQueue::flush() {
+        std::vector<Deletion> completedDeletions;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            completedSubmission = lastSubmission;
+            completedDeletions.swap(deletions);
+        }
+        for (const Deletion& deletion : completedDeletions) {
+            deletion.Destroy();
+        }
+    }
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Vulkandemo {
+
+    // Postpones destroying Vulkan objects until the GPU is done with them. Every queue submission gets a value from addSubmission(), objects
+    // are destroyed once the submission that last used them has been reported complete, so they can be replaced without idling the device.
+    class VulkanDeletionQueue {
+    private:
+        struct Deletion {
+            uint64_t Submission;
+            std::function<void()> Destroy;
+        };
+
+    private:
+        std::mutex mutex;
+        std::vector<Deletion> deletions;
+        uint64_t lastSubmission = 0;
+        uint64_t completedSubmission = 0;
+
+    public:
+        // Returns the value of a submission about to be made, values start at 1 and increase by 1
+        uint64_t addSubmission();
+
+        // Destroys once every submission made so far has completed. Never destroys right away, even if they already have.
+        void destroyLater(const std::function<void()>& destroy);
+
+        // Destroys everything waiting for the submission or an earlier one. Submissions to one queue complete in order, so reporting the last
+        // completed one is enough.
+        void complete(uint64_t submission);
+
+        // Destroys everything, the device has to be idle
+        void flush();
+    };
+
+}
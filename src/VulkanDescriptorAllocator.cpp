@@ -0,0 +1,207 @@
+#include "VulkanDescriptorAllocator.h"
+#include "Hash.h"
+#include "Log.h"
+
+#include <algorithm>
+
+namespace Vulkandemo {
+
+    const VkAllocationCallbacks* VulkanDescriptorAllocator::ALLOCATOR = VK_NULL_HANDLE;
+
+    bool VulkanDescriptorAllocator::CacheKey::operator==(const CacheKey& other) const {
+        auto writesEqual = [](const DescriptorWrite& a, const DescriptorWrite& b) {
+            if (a.Binding != b.Binding || a.ArrayElement != b.ArrayElement || a.DescriptorType != b.DescriptorType) {
+                return false;
+            }
+            if (isImageDescriptor(a.DescriptorType)) {
+                return a.ImageInfo.sampler == b.ImageInfo.sampler && a.ImageInfo.imageView == b.ImageInfo.imageView && a.ImageInfo.imageLayout == b.ImageInfo.imageLayout;
+            }
+            return a.BufferInfo.buffer == b.BufferInfo.buffer && a.BufferInfo.offset == b.BufferInfo.offset && a.BufferInfo.range == b.BufferInfo.range;
+        };
+        return Layout == other.Layout && std::equal(Writes.begin(), Writes.end(), other.Writes.begin(), other.Writes.end(), writesEqual);
+    }
+
+    size_t VulkanDescriptorAllocator::CacheKeyHash::operator()(const CacheKey& key) const {
+        uint64_t hash = hashValue((uint64_t) key.Layout);
+        for (const DescriptorWrite& write : key.Writes) {
+            hash = hashValue(write.Binding, hash);
+            hash = hashValue(write.ArrayElement, hash);
+            hash = hashValue(write.DescriptorType, hash);
+            if (isImageDescriptor(write.DescriptorType)) {
+                hash = hashValue((uint64_t) write.ImageInfo.sampler, hash);
+                hash = hashValue((uint64_t) write.ImageInfo.imageView, hash);
+                hash = hashValue(write.ImageInfo.imageLayout, hash);
+            } else {
+                hash = hashValue((uint64_t) write.BufferInfo.buffer, hash);
+                hash = hashValue(write.BufferInfo.offset, hash);
+                hash = hashValue(write.BufferInfo.range, hash);
+            }
+        }
+        return (size_t) hash;
+    }
+
+    VulkanDescriptorAllocator::VulkanDescriptorAllocator(Config config, VulkanDevice* vulkanDevice) : config(std::move(config)), vulkanDevice(vulkanDevice) {
+    }
+
+    bool VulkanDescriptorAllocator::initialize() {
+        framePools.resize(std::max(config.FrameCount, 1u));
+        for (PoolList& poolList : framePools) {
+            poolList.SetsPerPool = config.InitialSetsPerPool;
+        }
+        cachePools.SetsPerPool = config.InitialSetsPerPool;
+        VD_LOG_INFO("Initialized Vulkan descriptor allocator for [{}] frames", framePools.size());
+        return true;
+    }
+
+    void VulkanDescriptorAllocator::terminate() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (PoolList& poolList : framePools) {
+            destroyPools(poolList);
+        }
+        framePools.clear();
+        destroyPools(cachePools);
+        cachedSets.clear();
+        VD_LOG_INFO("Destroyed Vulkan descriptor pools");
+    }
+
+    void VulkanDescriptorAllocator::beginFrame(uint32_t frameIndex) {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentFrame = frameIndex % (uint32_t) framePools.size();
+        resetPools(framePools[currentFrame]);
+    }
+
+    VkDescriptorSet VulkanDescriptorAllocator::allocate(VkDescriptorSetLayout layout) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return allocate(framePools[currentFrame], layout);
+    }
+
+    VkDescriptorSet VulkanDescriptorAllocator::getDescriptorSet(VkDescriptorSetLayout layout, const std::vector<DescriptorWrite>& writes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        CacheKey key{layout, writes};
+        auto iterator = cachedSets.find(key);
+        if (iterator != cachedSets.end()) {
+            return iterator->second;
+        }
+
+        VkDescriptorSet descriptorSet = allocate(cachePools, layout);
+        if (descriptorSet == VK_NULL_HANDLE) {
+            return VK_NULL_HANDLE;
+        }
+        std::vector<VkWriteDescriptorSet> descriptorWrites;
+        descriptorWrites.reserve(writes.size());
+        for (const DescriptorWrite& write : writes) {
+            VkWriteDescriptorSet descriptorWrite{};
+            descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrite.dstSet = descriptorSet;
+            descriptorWrite.dstBinding = write.Binding;
+            descriptorWrite.dstArrayElement = write.ArrayElement;
+            descriptorWrite.descriptorType = write.DescriptorType;
+            descriptorWrite.descriptorCount = 1;
+            if (isImageDescriptor(write.DescriptorType)) {
+                descriptorWrite.pImageInfo = &write.ImageInfo;
+            } else {
+                descriptorWrite.pBufferInfo = &write.BufferInfo;
+            }
+            descriptorWrites.push_back(descriptorWrite);
+        }
+        vkUpdateDescriptorSets(vulkanDevice->getDevice(), (uint32_t) descriptorWrites.size(), descriptorWrites.data(), 0, nullptr);
+        cachedSets.emplace(std::move(key), descriptorSet);
+        return descriptorSet;
+    }
+
+    void VulkanDescriptorAllocator::clearCache() {
+        std::lock_guard<std::mutex> lock(mutex);
+        resetPools(cachePools);
+        cachedSets.clear();
+    }
+
+    VkDescriptorSet VulkanDescriptorAllocator::allocate(PoolList& poolList, VkDescriptorSetLayout layout) {
+        VkDescriptorSetAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.descriptorSetCount = 1;
+        allocateInfo.pSetLayouts = &layout;
+
+        // The first attempt may hit a pool that ran out of memory, the second one uses a fresh pool
+        for (int attempt = 0; attempt < 2; attempt++) {
+            if (poolList.CurrentPool == VK_NULL_HANDLE) {
+                if (!poolList.FreePools.empty()) {
+                    poolList.CurrentPool = poolList.FreePools.back();
+                    poolList.FreePools.pop_back();
+                } else {
+                    poolList.CurrentPool = createPool(poolList.SetsPerPool);
+                    if (poolList.CurrentPool == VK_NULL_HANDLE) {
+                        return VK_NULL_HANDLE;
+                    }
+                    poolList.SetsPerPool = std::min(poolList.SetsPerPool * 2, config.MaxSetsPerPool);
+                }
+            }
+            allocateInfo.descriptorPool = poolList.CurrentPool;
+
+            VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+            VkResult result = vkAllocateDescriptorSets(vulkanDevice->getDevice(), &allocateInfo, &descriptorSet);
+            if (result == VK_SUCCESS) {
+                return descriptorSet;
+            }
+            if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) {
+                break;
+            }
+            poolList.FullPools.push_back(poolList.CurrentPool);
+            poolList.CurrentPool = VK_NULL_HANDLE;
+        }
+        VD_LOG_ERROR("Could not allocate Vulkan descriptor set");
+        return VK_NULL_HANDLE;
+    }
+
+    VkDescriptorPool VulkanDescriptorAllocator::createPool(uint32_t setCount) const {
+        std::vector<VkDescriptorPoolSize> poolSizes;
+        for (const auto& [descriptorType, ratio] : config.PoolSizeRatios) {
+            VkDescriptorPoolSize poolSize{};
+            poolSize.type = descriptorType;
+            poolSize.descriptorCount = std::max((uint32_t) (ratio * (float) setCount), 1u);
+            poolSizes.push_back(poolSize);
+        }
+
+        VkDescriptorPoolCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        createInfo.maxSets = setCount;
+        createInfo.poolSizeCount = (uint32_t) poolSizes.size();
+        createInfo.pPoolSizes = poolSizes.data();
+
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+        if (vkCreateDescriptorPool(vulkanDevice->getDevice(), &createInfo, ALLOCATOR, &pool) != VK_SUCCESS) {
+            VD_LOG_ERROR("Could not create Vulkan descriptor pool for [{}] sets", setCount);
+            return VK_NULL_HANDLE;
+        }
+        VD_LOG_DEBUG("Created Vulkan descriptor pool for [{}] sets", setCount);
+        return pool;
+    }
+
+    void VulkanDescriptorAllocator::resetPools(PoolList& poolList) const {
+        if (poolList.CurrentPool != VK_NULL_HANDLE) {
+            poolList.FullPools.push_back(poolList.CurrentPool);
+            poolList.CurrentPool = VK_NULL_HANDLE;
+        }
+        for (VkDescriptorPool pool : poolList.FullPools) {
+            vkResetDescriptorPool(vulkanDevice->getDevice(), pool, 0);
+            poolList.FreePools.push_back(pool);
+        }
+        poolList.FullPools.clear();
+    }
+
+    void VulkanDescriptorAllocator::destroyPools(PoolList& poolList) const {
+        resetPools(poolList);
+        for (VkDescriptorPool pool : poolList.FreePools) {
+            vkDestroyDescriptorPool(vulkanDevice->getDevice(), pool, ALLOCATOR);
+        }
+        poolList.FreePools.clear();
+    }
+
+    bool VulkanDescriptorAllocator::isImageDescriptor(VkDescriptorType descriptorType) {
+        return descriptorType == VK_DESCRIPTOR_TYPE_SAMPLER
+               || descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
+               || descriptorType == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE
+               || descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+               || descriptorType == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    }
+
+}
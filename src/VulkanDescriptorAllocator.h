@@ -0,0 +1,111 @@
+#pragma once
+
+#include "VulkanDevice.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Vulkandemo {
+
+    struct DescriptorWrite {
+        uint32_t Binding = 0;
+        uint32_t ArrayElement = 0;
+        VkDescriptorType DescriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        // Only the info matching the descriptor type is used
+        VkDescriptorBufferInfo BufferInfo{};
+        VkDescriptorImageInfo ImageInfo{};
+    };
+
+}
+
+namespace Vulkandemo {
+
+    // Allocates descriptor sets from lists of pools that grow on demand instead of sizing one pool up front.
+    // Per-frame sets are never freed individually, the pools of a frame are reset wholesale once the frame has completed.
+    class VulkanDescriptorAllocator {
+    public:
+        struct Config {
+            uint32_t FrameCount = 2;
+            uint32_t InitialSetsPerPool = 64;
+            uint32_t MaxSetsPerPool = 4096;
+            // Descriptors of each type per set in a pool
+            std::vector<std::pair<VkDescriptorType, float>> PoolSizeRatios = {
+                    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.0f},
+                    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f},
+                    {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.0f},
+                    {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.0f},
+                    {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 2.0f},
+                    {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f},
+                    {VK_DESCRIPTOR_TYPE_SAMPLER, 1.0f}
+            };
+        };
+
+    private:
+        static const VkAllocationCallbacks* ALLOCATOR;
+
+    private:
+        struct PoolList {
+            std::vector<VkDescriptorPool> FullPools;
+            std::vector<VkDescriptorPool> FreePools;
+            VkDescriptorPool CurrentPool = VK_NULL_HANDLE;
+            uint32_t SetsPerPool = 0;
+        };
+
+        struct CacheKey {
+            VkDescriptorSetLayout Layout;
+            std::vector<DescriptorWrite> Writes;
+
+            bool operator==(const CacheKey& other) const;
+        };
+
+        struct CacheKeyHash {
+            size_t operator()(const CacheKey& key) const;
+        };
+
+    private:
+        Config config;
+        VulkanDevice* vulkanDevice;
+        std::mutex mutex;
+        std::vector<PoolList> framePools;
+        uint32_t currentFrame = 0;
+        // Sets written through getDescriptorSet live until clearCache, since their contents never change they can be shared by all frames
+        PoolList cachePools;
+        std::unordered_map<CacheKey, VkDescriptorSet, CacheKeyHash> cachedSets;
+
+    public:
+        VulkanDescriptorAllocator(Config config, VulkanDevice* vulkanDevice);
+
+        bool initialize();
+
+        void terminate();
+
+        // Resets the pools of the frame, call once its fence has been waited on
+        void beginFrame(uint32_t frameIndex);
+
+        // Valid until the frame is begun again, the caller writes the set
+        VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+
+        // Returns a set with the given contents, only allocating and writing one the first time the contents are requested
+        VkDescriptorSet getDescriptorSet(VkDescriptorSetLayout layout, const std::vector<DescriptorWrite>& writes);
+
+        // Drops every cached set, e.g. when a buffer or image referenced by one is destroyed. No frame in flight may use the sets.
+        void clearCache();
+
+    private:
+        VkDescriptorSet allocate(PoolList& poolList, VkDescriptorSetLayout layout);
+
+        VkDescriptorPool createPool(uint32_t setCount) const;
+
+        void resetPools(PoolList& poolList) const;
+
+        void destroyPools(PoolList& poolList) const;
+
+        static bool isImageDescriptor(VkDescriptorType descriptorType);
+    };
+
+}
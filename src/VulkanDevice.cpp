@@ -14,6 +14,18 @@ namespace Vulkandemo {
         return device;
     }
 
+    const VulkanPhysicalDevice* VulkanDevice::getVulkanPhysicalDevice() const {
+        return vulkanPhysicalDevice;
+    }
+
+    PFN_vkCmdDrawIndexedIndirectCount VulkanDevice::getCmdDrawIndexedIndirectCount() const {
+        return cmdDrawIndexedIndirectCount;
+    }
+
+    PFN_vkCmdPipelineBarrier2KHR VulkanDevice::getCmdPipelineBarrier2() const {
+        return cmdPipelineBarrier2;
+    }
+
     const VkQueue VulkanDevice::getGraphicsQueue() const {
         return graphicsQueue;
     }
@@ -22,6 +34,10 @@ namespace Vulkandemo {
         return presentQueue;
     }
 
+    VulkanDeletionQueue* VulkanDevice::getDeletionQueue() {
+        return &deletionQueue;
+    }
+
     bool VulkanDevice::initialize() {
         const QueueFamilyIndices& queueFamilyIndices = vulkanPhysicalDevice->getQueueFamilyIndices();
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos = getDeviceQueueCreateInfos(queueFamilyIndices);
@@ -35,6 +51,14 @@ namespace Vulkandemo {
         }
         VD_LOG_INFO("Created Vulkan device");
 
+        if (vulkanPhysicalDevice->isDrawIndirectCountSupported()) {
+            const char* name = vulkanPhysicalDevice->isVulkan12Supported() ? "vkCmdDrawIndexedIndirectCount" : "vkCmdDrawIndexedIndirectCountKHR";
+            cmdDrawIndexedIndirectCount = (PFN_vkCmdDrawIndexedIndirectCount) vkGetDeviceProcAddr(device, name);
+        }
+        if (vulkanPhysicalDevice->isSynchronization2Supported()) {
+            cmdPipelineBarrier2 = (PFN_vkCmdPipelineBarrier2KHR) vkGetDeviceProcAddr(device, "vkCmdPipelineBarrier2KHR");
+        }
+
         if (!findDeviceQueues(queueFamilyIndices)) {
             VD_LOG_ERROR("Could not find any Vulkan device queues");
             return false;
@@ -43,7 +67,8 @@ namespace Vulkandemo {
         return true;
     }
 
-    void VulkanDevice::terminate() const {
+    void VulkanDevice::terminate() {
+        deletionQueue.flush();
         vkDestroyDevice(device, ALLOCATOR);
         VD_LOG_INFO("Destroyed Vulkan device");
     }
@@ -71,9 +96,52 @@ namespace Vulkandemo {
     }
 
     bool VulkanDevice::createDevice(const std::vector<VkDeviceQueueCreateInfo>& deviceQueueCreateInfos) {
+        // Only what the bindless descriptor set uses is enabled, see VulkanBindlessDescriptors
+        VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures{};
+        descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+        descriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+        descriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+        descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        descriptorIndexingFeatures.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+        descriptorIndexingFeatures.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+
+        // Vulkan 1.2 devices only expose some features (e.g. drawIndirectCount) in VkPhysicalDeviceVulkan12Features,
+        // which may not be chained together with the descriptor indexing features it contains
+        VkPhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        vulkan12Features.runtimeDescriptorArray = descriptorIndexingFeatures.runtimeDescriptorArray;
+        vulkan12Features.descriptorBindingPartiallyBound = descriptorIndexingFeatures.descriptorBindingPartiallyBound;
+        vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind;
+        vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind = descriptorIndexingFeatures.descriptorBindingStorageBufferUpdateAfterBind;
+        vulkan12Features.descriptorBindingUpdateUnusedWhilePending = descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending;
+        vulkan12Features.shaderSampledImageArrayNonUniformIndexing = descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing;
+        vulkan12Features.shaderStorageBufferArrayNonUniformIndexing = descriptorIndexingFeatures.shaderStorageBufferArrayNonUniformIndexing;
+        vulkan12Features.drawIndirectCount = vulkanPhysicalDevice->isDrawIndirectCountSupported();
+
+        // Features chained through pNext require the core features to be passed in VkPhysicalDeviceFeatures2 as well
+        VkPhysicalDeviceFeatures2 features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.features = vulkanPhysicalDevice->getFeatures();
+        if (vulkanPhysicalDevice->isVulkan12Supported()) {
+            features.pNext = &vulkan12Features;
+        } else {
+            features.pNext = &descriptorIndexingFeatures;
+        }
+
+        VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features{};
+        synchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+        synchronization2Features.synchronization2 = VK_TRUE;
+        if (vulkanPhysicalDevice->isSynchronization2Supported()) {
+            synchronization2Features.pNext = features.pNext;
+            features.pNext = &synchronization2Features;
+        }
+
         VkDeviceCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-        createInfo.pEnabledFeatures = &vulkanPhysicalDevice->getFeatures();
+        createInfo.pNext = &features;
+        createInfo.pEnabledFeatures = nullptr;
         createInfo.enabledExtensionCount = vulkanPhysicalDevice->getExtensions().size();
         createInfo.ppEnabledExtensionNames = vulkanPhysicalDevice->getExtensions().data();
         createInfo.queueCreateInfoCount = deviceQueueCreateInfos.size();
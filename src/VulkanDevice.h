@@ -1,5 +1,6 @@
 #pragma once
 
+#include "VulkanDeletionQueue.h"
 #include "VulkanPhysicalDevice.h"
 
 #include <vulkan/vulkan.h>
@@ -16,19 +17,34 @@ namespace Vulkandemo {
         VkDevice device = VK_NULL_HANDLE;
         VkQueue graphicsQueue = VK_NULL_HANDLE;
         VkQueue presentQueue = VK_NULL_HANDLE;
+        PFN_vkCmdDrawIndexedIndirectCount cmdDrawIndexedIndirectCount = nullptr;
+        PFN_vkCmdPipelineBarrier2KHR cmdPipelineBarrier2 = nullptr;
+        VulkanDeletionQueue deletionQueue;
 
     public:
         VulkanDevice(Vulkan* vulkan, VulkanPhysicalDevice* vulkanPhysicalDevice);
 
         const VkDevice getDevice() const;
 
+        const VulkanPhysicalDevice* getVulkanPhysicalDevice() const;
+
+        // nullptr when the device does not support drawing with a count read from a buffer
+        PFN_vkCmdDrawIndexedIndirectCount getCmdDrawIndexedIndirectCount() const;
+
+        // nullptr when the device does not support VK_KHR_synchronization2, vkCmdPipelineBarrier has to be used instead
+        PFN_vkCmdPipelineBarrier2KHR getCmdPipelineBarrier2() const;
+
         const VkQueue getGraphicsQueue() const;
 
         const VkQueue getPresentQueue() const;
 
+        // Objects that submitted work may still use are destroyed through this queue
+        VulkanDeletionQueue* getDeletionQueue();
+
         bool initialize();
 
-        void terminate() const;
+        // Destroys what is left in the deletion queue first, the device has to be idle
+        void terminate();
 
         void waitUntilIdle() const;
 
@@ -35,7 +35,10 @@ namespace Vulkandemo {
     }
 
     void VulkanFramebuffer::terminate() {
-        vkDestroyFramebuffer(vulkanDevice->getDevice(), framebuffer, ALLOCATOR);
+        vulkanDevice->getDeletionQueue()->destroyLater([device = vulkanDevice->getDevice(), framebuffer = framebuffer]() {
+            vkDestroyFramebuffer(device, framebuffer, ALLOCATOR);
+        });
+        framebuffer = VK_NULL_HANDLE;
     }
 
 }
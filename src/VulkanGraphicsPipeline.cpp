@@ -1,72 +1,177 @@
 #include "VulkanGraphicsPipeline.h"
+#include "Hash.h"
 #include "Log.h"
 
+#include <algorithm>
+#include <map>
+
 namespace Vulkandemo {
 
+    uint64_t GraphicsPipelineDescription::getHash() const {
+        uint64_t hash = HASH_SEED;
+        hash = hashValue(VertexShader != nullptr ? VertexShader->getCodeHash() : 0, hash);
+        hash = hashValue(FragmentShader != nullptr ? FragmentShader->getCodeHash() : 0, hash);
+        hash = hashValue(Specialization.getHash(), hash);
+        hash = hashValue(PushConstants.stageFlags, hash);
+        hash = hashValue(PushConstants.offset, hash);
+        hash = hashValue(PushConstants.size, hash);
+        for (const auto& [set, setLayout] : SetLayouts) {
+            hash = hashValue(set, hash);
+        }
+        for (const VkVertexInputBindingDescription& binding : VertexBindings) {
+            hash = hashValue(binding.binding, hash);
+            hash = hashValue(binding.stride, hash);
+            hash = hashValue(binding.inputRate, hash);
+        }
+        for (const VkVertexInputAttributeDescription& attribute : VertexAttributes) {
+            hash = hashValue(attribute.location, hash);
+            hash = hashValue(attribute.binding, hash);
+            hash = hashValue(attribute.format, hash);
+            hash = hashValue(attribute.offset, hash);
+        }
+        hash = hashValue(Topology, hash);
+        hash = hashValue(PolygonMode, hash);
+        hash = hashValue(CullMode, hash);
+        hash = hashValue(FrontFace, hash);
+        hash = hashValue(DepthTestEnabled, hash);
+        hash = hashValue(DepthWriteEnabled, hash);
+        hash = hashValue(DepthCompareOp, hash);
+        hash = hashValue(Blend, hash);
+        // Render passes with the same attachment formats are compatible, so the format stands in for the handle
+        hash = hashValue(RenderPass != nullptr ? RenderPass->getColorFormat() : VK_FORMAT_UNDEFINED, hash);
+        hash = hashValue(Subpass, hash);
+        return hash;
+    }
+
+    bool GraphicsPipelineDescription::operator==(const GraphicsPipelineDescription& other) const {
+        auto bindingsEqual = [](const VkVertexInputBindingDescription& a, const VkVertexInputBindingDescription& b) {
+            return a.binding == b.binding && a.stride == b.stride && a.inputRate == b.inputRate;
+        };
+        auto attributesEqual = [](const VkVertexInputAttributeDescription& a, const VkVertexInputAttributeDescription& b) {
+            return a.location == b.location && a.binding == b.binding && a.format == b.format && a.offset == b.offset;
+        };
+        return VertexShader == other.VertexShader
+               && FragmentShader == other.FragmentShader
+               && Specialization == other.Specialization
+               && PushConstants.stageFlags == other.PushConstants.stageFlags
+               && PushConstants.offset == other.PushConstants.offset
+               && PushConstants.size == other.PushConstants.size
+               && SetLayouts == other.SetLayouts
+               && std::equal(VertexBindings.begin(), VertexBindings.end(), other.VertexBindings.begin(), other.VertexBindings.end(), bindingsEqual)
+               && std::equal(VertexAttributes.begin(), VertexAttributes.end(), other.VertexAttributes.begin(), other.VertexAttributes.end(), attributesEqual)
+               && Topology == other.Topology
+               && PolygonMode == other.PolygonMode
+               && CullMode == other.CullMode
+               && FrontFace == other.FrontFace
+               && DepthTestEnabled == other.DepthTestEnabled
+               && DepthWriteEnabled == other.DepthWriteEnabled
+               && DepthCompareOp == other.DepthCompareOp
+               && Blend == other.Blend
+               && RenderPass == other.RenderPass
+               && Subpass == other.Subpass;
+    }
+
     const VkAllocationCallbacks* VulkanGraphicsPipeline::ALLOCATOR = VK_NULL_HANDLE;
 
-    VulkanGraphicsPipeline::VulkanGraphicsPipeline(VulkanRenderPass* vulkanRenderPass, VulkanSwapChain* vulkanSwapChain, VulkanDevice* vulkanDevice)
-        : vulkanRenderPass(vulkanRenderPass), vulkanSwapChain(vulkanSwapChain), vulkanDevice(vulkanDevice) {
+    VulkanGraphicsPipeline::VulkanGraphicsPipeline(VulkanDevice* vulkanDevice, VulkanLayoutCache* vulkanLayoutCache)
+        : vulkanDevice(vulkanDevice), vulkanLayoutCache(vulkanLayoutCache) {
     }
 
-    bool VulkanGraphicsPipeline::initialize(const VulkanShader& vertexShader, const VulkanShader& fragmentShader) {
+    bool VulkanGraphicsPipeline::initialize(const GraphicsPipelineDescription& description, VkPipelineCache pipelineCache) {
+        if (description.VertexShader == nullptr || description.FragmentShader == nullptr || description.RenderPass == nullptr) {
+            VD_LOG_ERROR("Could not use incomplete description for Vulkan graphics pipeline");
+            return false;
+        }
+        const VulkanShader& vertexShader = *description.VertexShader;
+        const VulkanShader& fragmentShader = *description.FragmentShader;
+        const ShaderSpecialization& specialization = description.Specialization;
+        if (vertexShader.getReflection().getStage() != VK_SHADER_STAGE_VERTEX_BIT || fragmentShader.getReflection().getStage() != VK_SHADER_STAGE_FRAGMENT_BIT) {
+            VD_LOG_ERROR("Could not use shaders of the wrong stage for Vulkan graphics pipeline");
+            return false;
+        }
+
+        // Constant IDs are shared between stages, each stage only gets the constants it declares
+        std::vector<VkSpecializationMapEntry> vertexMapEntries;
+        std::vector<uint32_t> vertexSpecializationData;
+        specialization.getMapEntries(vertexShader.getReflection(), vertexMapEntries, vertexSpecializationData);
+        VkSpecializationInfo vertexSpecializationInfo{};
+        vertexSpecializationInfo.mapEntryCount = (uint32_t) vertexMapEntries.size();
+        vertexSpecializationInfo.pMapEntries = vertexMapEntries.data();
+        vertexSpecializationInfo.dataSize = vertexSpecializationData.size() * sizeof(uint32_t);
+        vertexSpecializationInfo.pData = vertexSpecializationData.data();
+
+        std::vector<VkSpecializationMapEntry> fragmentMapEntries;
+        std::vector<uint32_t> fragmentSpecializationData;
+        specialization.getMapEntries(fragmentShader.getReflection(), fragmentMapEntries, fragmentSpecializationData);
+        VkSpecializationInfo fragmentSpecializationInfo{};
+        fragmentSpecializationInfo.mapEntryCount = (uint32_t) fragmentMapEntries.size();
+        fragmentSpecializationInfo.pMapEntries = fragmentMapEntries.data();
+        fragmentSpecializationInfo.dataSize = fragmentSpecializationData.size() * sizeof(uint32_t);
+        fragmentSpecializationInfo.pData = fragmentSpecializationData.data();
 
         VkPipelineShaderStageCreateInfo vertexShaderStageInfo{};
         vertexShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        vertexShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+        vertexShaderStageInfo.stage = vertexShader.getReflection().getStage();
         vertexShaderStageInfo.module = vertexShader.getShaderModule();
-        vertexShaderStageInfo.pName = "main";
+        vertexShaderStageInfo.pName = vertexShader.getReflection().getEntryPoint().c_str();
+        vertexShaderStageInfo.pSpecializationInfo = vertexMapEntries.empty() ? nullptr : &vertexSpecializationInfo;
 
         VkPipelineShaderStageCreateInfo fragmentShaderStageInfo{};
         fragmentShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        fragmentShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        fragmentShaderStageInfo.stage = fragmentShader.getReflection().getStage();
         fragmentShaderStageInfo.module = fragmentShader.getShaderModule();
-        fragmentShaderStageInfo.pName = "main";
+        fragmentShaderStageInfo.pName = fragmentShader.getReflection().getEntryPoint().c_str();
+        fragmentShaderStageInfo.pSpecializationInfo = fragmentMapEntries.empty() ? nullptr : &fragmentSpecializationInfo;
 
         VkPipelineShaderStageCreateInfo shaderStages[] = {
                 vertexShaderStageInfo,
                 fragmentShaderStageInfo
         };
 
+        std::vector<VkVertexInputBindingDescription> vertexBindingDescriptions = description.VertexBindings;
+        std::vector<VkVertexInputAttributeDescription> vertexAttributeDescriptions = description.VertexAttributes;
+        if (vertexAttributeDescriptions.empty()) {
+            getVertexInputDescriptions(vertexShader, vertexBindingDescriptions, vertexAttributeDescriptions);
+        }
+
         VkPipelineVertexInputStateCreateInfo vertexInputState{};
         vertexInputState.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputState.pVertexBindingDescriptions = nullptr;
-        vertexInputState.vertexBindingDescriptionCount = 0;
-        vertexInputState.pVertexAttributeDescriptions = nullptr;
-        vertexInputState.vertexAttributeDescriptionCount = 0;
+        vertexInputState.pVertexBindingDescriptions = vertexBindingDescriptions.data();
+        vertexInputState.vertexBindingDescriptionCount = (uint32_t) vertexBindingDescriptions.size();
+        vertexInputState.pVertexAttributeDescriptions = vertexAttributeDescriptions.data();
+        vertexInputState.vertexAttributeDescriptionCount = (uint32_t) vertexAttributeDescriptions.size();
 
         VkPipelineInputAssemblyStateCreateInfo inputAssemblyState{};
         inputAssemblyState.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-        inputAssemblyState.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        inputAssemblyState.topology = description.Topology;
         inputAssemblyState.primitiveRestartEnable = VK_FALSE;
 
-        VkViewport viewport{};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = (float) vulkanSwapChain->getExtent().width;
-        viewport.height = (float) vulkanSwapChain->getExtent().height;
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-
-        VkRect2D scissor{};
-        scissor.offset = {0, 0};
-        scissor.extent = vulkanSwapChain->getExtent();
-
+        // Viewport and scissor are set when recording, see vkCmdSetViewport and vkCmdSetScissor
         VkPipelineViewportStateCreateInfo viewportState{};
         viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
         viewportState.viewportCount = 1;
-        viewportState.pViewports = &viewport;
+        viewportState.pViewports = nullptr;
         viewportState.scissorCount = 1;
-        viewportState.pScissors = &scissor;
+        viewportState.pScissors = nullptr;
+
+        VkDynamicState dynamicStates[] = {
+                VK_DYNAMIC_STATE_VIEWPORT,
+                VK_DYNAMIC_STATE_SCISSOR
+        };
+
+        VkPipelineDynamicStateCreateInfo dynamicState{};
+        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicState.dynamicStateCount = 2;
+        dynamicState.pDynamicStates = dynamicStates;
 
         VkPipelineRasterizationStateCreateInfo rasterizationState{};
         rasterizationState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
         rasterizationState.depthClampEnable = VK_FALSE;
         rasterizationState.rasterizerDiscardEnable = VK_FALSE;
-        rasterizationState.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterizationState.polygonMode = description.PolygonMode;
         rasterizationState.lineWidth = 1.0f;
-        rasterizationState.cullMode = VK_CULL_MODE_BACK_BIT;
-        rasterizationState.frontFace = VK_FRONT_FACE_CLOCKWISE;
+        rasterizationState.cullMode = description.CullMode;
+        rasterizationState.frontFace = description.FrontFace;
         rasterizationState.depthBiasEnable = VK_FALSE;
         rasterizationState.depthBiasConstantFactor = 0.0f;
         rasterizationState.depthBiasClamp = 0.0f;
@@ -81,15 +186,17 @@ namespace Vulkandemo {
         multisampleState.alphaToCoverageEnable = VK_FALSE;
         multisampleState.alphaToOneEnable = VK_FALSE;
 
-        VkPipelineColorBlendAttachmentState colorBlendAttachmentState{};
-        colorBlendAttachmentState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-        colorBlendAttachmentState.blendEnable = VK_FALSE;
-        colorBlendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
-        colorBlendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
-        colorBlendAttachmentState.colorBlendOp = VK_BLEND_OP_ADD;
-        colorBlendAttachmentState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-        colorBlendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-        colorBlendAttachmentState.alphaBlendOp = VK_BLEND_OP_ADD;
+        VkPipelineDepthStencilStateCreateInfo depthStencilState{};
+        depthStencilState.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencilState.depthTestEnable = description.DepthTestEnabled ? VK_TRUE : VK_FALSE;
+        depthStencilState.depthWriteEnable = description.DepthWriteEnabled ? VK_TRUE : VK_FALSE;
+        depthStencilState.depthCompareOp = description.DepthCompareOp;
+        depthStencilState.depthBoundsTestEnable = VK_FALSE;
+        depthStencilState.stencilTestEnable = VK_FALSE;
+        depthStencilState.minDepthBounds = 0.0f;
+        depthStencilState.maxDepthBounds = 1.0f;
+
+        VkPipelineColorBlendAttachmentState colorBlendAttachmentState = getColorBlendAttachmentState(description.Blend);
 
         VkPipelineColorBlendStateCreateInfo colorBlendState{};
         colorBlendState.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
@@ -102,18 +209,11 @@ namespace Vulkandemo {
         colorBlendState.blendConstants[2] = 0.0f;
         colorBlendState.blendConstants[3] = 0.0f;
 
-        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipelineLayoutInfo.setLayoutCount = 0;
-        pipelineLayoutInfo.pSetLayouts = nullptr;
-        pipelineLayoutInfo.pushConstantRangeCount = 0;
-        pipelineLayoutInfo.pPushConstantRanges = nullptr;
-
-        if (vkCreatePipelineLayout(vulkanDevice->getDevice(), &pipelineLayoutInfo, ALLOCATOR, &pipelineLayout) != VK_SUCCESS) {
+        pipelineLayout = vulkanLayoutCache->getPipelineLayout({&vertexShader, &fragmentShader}, description.SetLayouts, description.PushConstants, pushConstantRange);
+        if (pipelineLayout == VK_NULL_HANDLE) {
             VD_LOG_ERROR("Could not create Vulkan graphics pipeline layout");
             return false;
         }
-        VD_LOG_INFO("Created Vulkan graphics pipeline layout");
 
         VkGraphicsPipelineCreateInfo pipelineInfo{};
         pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -124,17 +224,16 @@ namespace Vulkandemo {
         pipelineInfo.pViewportState = &viewportState;
         pipelineInfo.pRasterizationState = &rasterizationState;
         pipelineInfo.pMultisampleState = &multisampleState;
-        pipelineInfo.pDepthStencilState = nullptr;
+        pipelineInfo.pDepthStencilState = description.DepthTestEnabled || description.DepthWriteEnabled ? &depthStencilState : nullptr;
         pipelineInfo.pColorBlendState = &colorBlendState;
-        pipelineInfo.pDynamicState = nullptr;
+        pipelineInfo.pDynamicState = &dynamicState;
         pipelineInfo.layout = pipelineLayout;
-        pipelineInfo.renderPass = vulkanRenderPass->getRenderPass();
-        pipelineInfo.subpass = 0;
+        pipelineInfo.renderPass = description.RenderPass->getRenderPass();
+        pipelineInfo.subpass = description.Subpass;
         pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
         pipelineInfo.basePipelineIndex = -1;
 
         constexpr int createInfoCount = 1;
-        VkPipelineCache pipelineCache = VK_NULL_HANDLE;
 
         if (vkCreateGraphicsPipelines(vulkanDevice->getDevice(), pipelineCache, createInfoCount, &pipelineInfo, ALLOCATOR, &pipeline) != VK_SUCCESS) {
             VD_LOG_ERROR("Could not create Vulkan graphics pipeline");
@@ -146,13 +245,70 @@ namespace Vulkandemo {
     }
 
     void VulkanGraphicsPipeline::terminate() {
-        vkDestroyPipeline(vulkanDevice->getDevice(), pipeline, ALLOCATOR);
-        VD_LOG_INFO("Destroyed Vulkan graphics pipeline");
-        vkDestroyPipelineLayout(vulkanDevice->getDevice(), pipelineLayout, ALLOCATOR);
-        VD_LOG_INFO("Destroyed Vulkan graphics pipeline layout");
+        vulkanDevice->getDeletionQueue()->destroyLater([device = vulkanDevice->getDevice(), pipeline = pipeline]() {
+            vkDestroyPipeline(device, pipeline, ALLOCATOR);
+            VD_LOG_INFO("Destroyed Vulkan graphics pipeline");
+        });
+        pipeline = VK_NULL_HANDLE;
     }
 
     void VulkanGraphicsPipeline::bind(const VulkanCommandBuffer& vulkanCommandBuffer) const {
         vkCmdBindPipeline(vulkanCommandBuffer.getCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
     }
+
+    VkPipelineLayout VulkanGraphicsPipeline::getPipelineLayout() const {
+        return pipelineLayout;
+    }
+
+    const VkPushConstantRange& VulkanGraphicsPipeline::getPushConstantRange() const {
+        return pushConstantRange;
+    }
+
+    void VulkanGraphicsPipeline::pushConstants(const VulkanCommandBuffer& vulkanCommandBuffer, const void* data, uint32_t size, uint32_t offset) const {
+        recordPushConstants(vulkanCommandBuffer, pipelineLayout, pushConstantRange, data, size, offset);
+    }
+
+    void VulkanGraphicsPipeline::getVertexInputDescriptions(const VulkanShader& vertexShader, std::vector<VkVertexInputBindingDescription>& bindingDescriptions, std::vector<VkVertexInputAttributeDescription>& attributeDescriptions) {
+        // All inputs are read interleaved from a single vertex buffer, tightly packed in location order
+        uint32_t offset = 0;
+        for (const ShaderInput& input : vertexShader.getReflection().getInputs()) {
+            VkVertexInputAttributeDescription attributeDescription{};
+            attributeDescription.location = input.Location;
+            attributeDescription.binding = 0;
+            attributeDescription.format = input.Format;
+            attributeDescription.offset = offset;
+            attributeDescriptions.push_back(attributeDescription);
+            offset += input.Size;
+        }
+        if (attributeDescriptions.empty()) {
+            return;
+        }
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 0;
+        bindingDescription.stride = offset;
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        bindingDescriptions.push_back(bindingDescription);
+    }
+
+    VkPipelineColorBlendAttachmentState VulkanGraphicsPipeline::getColorBlendAttachmentState(BlendMode blendMode) {
+        VkPipelineColorBlendAttachmentState colorBlendAttachmentState{};
+        colorBlendAttachmentState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        colorBlendAttachmentState.blendEnable = blendMode == BlendMode::Opaque ? VK_FALSE : VK_TRUE;
+        colorBlendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+        colorBlendAttachmentState.colorBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachmentState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        colorBlendAttachmentState.alphaBlendOp = VK_BLEND_OP_ADD;
+        if (blendMode == BlendMode::AlphaBlend) {
+            colorBlendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+            colorBlendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+            colorBlendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        } else if (blendMode == BlendMode::Additive) {
+            colorBlendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+            colorBlendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+            colorBlendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        }
+        return colorBlendAttachmentState;
+    }
 }
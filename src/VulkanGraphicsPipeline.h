@@ -1,12 +1,63 @@
 #pragma once
 
 #include "VulkanShader.h"
+#include "ShaderSpecialization.h"
+#include "VulkanLayoutCache.h"
 #include "VulkanRenderPass.h"
-#include "VulkanSwapChain.h"
 #include "VulkanDevice.h"
+#include "VulkanCommandBuffer.h"
+#include "VulkanPushConstants.h"
 
 #include <vulkan/vulkan.h>
 
+#include <map>
+#include <vector>
+
+namespace Vulkandemo {
+
+    enum class BlendMode {
+        Opaque = 0,
+        AlphaBlend,
+        Additive
+    };
+
+    // Everything that goes into a graphics pipeline. Viewport and scissor are dynamic, so pipelines do not depend on the swap chain extent.
+    struct GraphicsPipelineDescription {
+        const VulkanShader* VertexShader = nullptr;
+        const VulkanShader* FragmentShader = nullptr;
+        ShaderSpecialization Specialization;
+        // Push constant block declared by the application, e.g. with declarePushConstants. When empty the block reflected from the shaders is used,
+        // otherwise the reflected block must fit inside it.
+        VkPushConstantRange PushConstants{};
+        // Layouts of sets owned elsewhere by set number (e.g. the bindless set), used instead of layouts built from the reflected bindings of those sets
+        std::map<uint32_t, VkDescriptorSetLayout> SetLayouts;
+        // Derived from the vertex shader inputs when empty
+        std::vector<VkVertexInputBindingDescription> VertexBindings;
+        std::vector<VkVertexInputAttributeDescription> VertexAttributes;
+        VkPrimitiveTopology Topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        VkPolygonMode PolygonMode = VK_POLYGON_MODE_FILL;
+        VkCullModeFlags CullMode = VK_CULL_MODE_BACK_BIT;
+        VkFrontFace FrontFace = VK_FRONT_FACE_CLOCKWISE;
+        bool DepthTestEnabled = false;
+        bool DepthWriteEnabled = false;
+        VkCompareOp DepthCompareOp = VK_COMPARE_OP_LESS;
+        BlendMode Blend = BlendMode::Opaque;
+        const VulkanRenderPass* RenderPass = nullptr;
+        uint32_t Subpass = 0;
+
+        template<typename T>
+        void declarePushConstants(VkShaderStageFlags stageFlags, uint32_t offset = 0) {
+            PushConstants = getPushConstantRange<T>(stageFlags, offset);
+        }
+
+        // Built from shader code and state values only (no handles or addresses), so it is the same across runs
+        uint64_t getHash() const;
+
+        bool operator==(const GraphicsPipelineDescription& other) const;
+    };
+
+}
+
 namespace Vulkandemo {
 
     class VulkanGraphicsPipeline {
@@ -14,22 +65,40 @@ namespace Vulkandemo {
         static const VkAllocationCallbacks* ALLOCATOR;
 
     private:
-        VulkanRenderPass* vulkanRenderPass;
-        VulkanSwapChain* vulkanSwapChain;
         VulkanDevice* vulkanDevice;
+        VulkanLayoutCache* vulkanLayoutCache;
         VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
         VkPipeline pipeline = VK_NULL_HANDLE;
+        VkPushConstantRange pushConstantRange{};
 
     public:
-        VulkanGraphicsPipeline(VulkanRenderPass* vulkanRenderPass, VulkanSwapChain* vulkanSwapChain, VulkanDevice* vulkanDevice);
+        VulkanGraphicsPipeline(VulkanDevice* vulkanDevice, VulkanLayoutCache* vulkanLayoutCache);
 
-        bool initialize(const VulkanShader& vertexShader, const VulkanShader& fragmentShader);
+        // The pipeline cache may be shared by threads creating pipelines concurrently
+        bool initialize(const GraphicsPipelineDescription& description, VkPipelineCache pipelineCache = VK_NULL_HANDLE);
 
         void terminate();
 
         void bind(const VulkanCommandBuffer& vulkanCommandBuffer) const;
-    };
 
-}
+        // Owned by the layout cache and shared with every pipeline that has the same resource interface
+        VkPipelineLayout getPipelineLayout() const;
+
+        // Empty (zero stage flags) when the pipeline has no push constants
+        const VkPushConstantRange& getPushConstantRange() const;
+
+        // Records per-draw data directly into the command buffer, for every stage that can read the push constant block
+        void pushConstants(const VulkanCommandBuffer& vulkanCommandBuffer, const void* data, uint32_t size, uint32_t offset = 0) const;
 
+        template<typename T>
+        void pushConstants(const VulkanCommandBuffer& vulkanCommandBuffer, const T& constants, uint32_t offset = 0) const {
+            pushConstants(vulkanCommandBuffer, &constants, getPushConstantSize<T>(), offset);
+        }
 
+    private:
+        static void getVertexInputDescriptions(const VulkanShader& vertexShader, std::vector<VkVertexInputBindingDescription>& bindingDescriptions, std::vector<VkVertexInputAttributeDescription>& attributeDescriptions);
+
+        static VkPipelineColorBlendAttachmentState getColorBlendAttachmentState(BlendMode blendMode);
+    };
+
+}
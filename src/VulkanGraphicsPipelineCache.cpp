@@ -0,0 +1,329 @@
+#include "VulkanGraphicsPipelineCache.h"
+#include "Log.h"
+
+#include <algorithm>
+
+namespace Vulkandemo {
+
+    const VkAllocationCallbacks* VulkanGraphicsPipelineCache::ALLOCATOR = VK_NULL_HANDLE;
+
+    size_t VulkanGraphicsPipelineCache::DescriptionHash::operator()(const GraphicsPipelineDescription& description) const {
+        return (size_t) description.getHash();
+    }
+
+    VulkanGraphicsPipelineCache::VulkanGraphicsPipelineCache(VulkanDevice* vulkanDevice, VulkanLayoutCache* vulkanLayoutCache, JobSystem* jobSystem)
+            : vulkanDevice(vulkanDevice), vulkanLayoutCache(vulkanLayoutCache), jobSystem(jobSystem) {
+    }
+
+    VulkanGraphicsPipelineCache::~VulkanGraphicsPipelineCache() {
+        // Build jobs refer to the cache and must be done even if the app bailed out before calling terminate
+        if (running) {
+            stopBuildJobs();
+        }
+    }
+
+    bool VulkanGraphicsPipelineCache::initialize() {
+        // Shared by all build jobs, vkCreateGraphicsPipelines synchronizes access to it internally
+        VkPipelineCacheCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = nullptr;
+        if (vkCreatePipelineCache(vulkanDevice->getDevice(), &createInfo, ALLOCATOR, &pipelineCache) != VK_SUCCESS) {
+            VD_LOG_ERROR("Could not create Vulkan pipeline cache");
+            return false;
+        }
+        VD_LOG_INFO("Created Vulkan pipeline cache");
+
+        running = true;
+        VD_LOG_INFO("Initialized Vulkan graphics pipeline cache with [{}] compile threads", std::max(jobSystem->getThreadCount() - 1, 1u));
+        return true;
+    }
+
+    void VulkanGraphicsPipelineCache::terminate() {
+        stopBuildJobs();
+        clear();
+        // Only left if a thread was still building synchronously when the cache stopped
+        for (VulkanShader* shader : retiredShaders) {
+            shader->terminate();
+            delete shader;
+        }
+        retiredShaders.clear();
+        vkDestroyPipelineCache(vulkanDevice->getDevice(), pipelineCache, ALLOCATOR);
+        VD_LOG_INFO("Destroyed Vulkan pipeline cache");
+        Stats finalStats = getStats();
+        VD_LOG_INFO("Vulkan graphics pipeline cache had [{}] hits, [{}] misses and [{}] failures, spent [{:.2f}] ms compiling", finalStats.Hits, finalStats.Misses, finalStats.Failures, finalStats.CompileSeconds * 1000.0);
+    }
+
+    VulkanGraphicsPipeline* VulkanGraphicsPipelineCache::getPipeline(const GraphicsPipelineDescription& description) {
+        std::shared_future<VulkanGraphicsPipeline*> pipeline;
+        std::shared_ptr<Build> pendingBuild;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto iterator = pipelines.find(description);
+            if (iterator != pipelines.end()) {
+                pipeline = iterator->second.Pipeline;
+                pendingBuild = iterator->second.PendingBuild;
+                std::lock_guard<std::mutex> statsLock(statsMutex);
+                stats.Hits++;
+            } else {
+                pendingBuild = addBuild(description, false);
+            }
+        }
+        if (pendingBuild != nullptr && !pendingBuild->Claimed.exchange(true)) {
+            return build(*pendingBuild);
+        }
+        return pipeline.get();
+    }
+
+    VulkanGraphicsPipeline* VulkanGraphicsPipelineCache::tryGetPipeline(const GraphicsPipelineDescription& description) {
+        std::shared_ptr<Build> newBuild;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto iterator = pipelines.find(description);
+            if (iterator != pipelines.end()) {
+                const std::shared_future<VulkanGraphicsPipeline*>& pipeline = iterator->second.Pipeline;
+                if (pipeline.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                    return nullptr;
+                }
+                std::lock_guard<std::mutex> statsLock(statsMutex);
+                stats.Hits++;
+                return pipeline.get();
+            }
+            newBuild = addBuild(description, true);
+        }
+        if (newBuild != nullptr) {
+            scheduleBuilds({newBuild});
+        }
+        return nullptr;
+    }
+
+    void VulkanGraphicsPipelineCache::precompile(const std::vector<GraphicsPipelineDescription>& descriptions) {
+        std::vector<std::shared_ptr<Build>> newBuilds;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const GraphicsPipelineDescription& description : descriptions) {
+                if (pipelines.find(description) == pipelines.end()) {
+                    if (std::shared_ptr<Build> newBuild = addBuild(description, true)) {
+                        newBuilds.push_back(newBuild);
+                    }
+                }
+            }
+        }
+        scheduleBuilds(newBuilds);
+    }
+
+    void VulkanGraphicsPipelineCache::waitForPrecompile() {
+        std::unique_lock<std::mutex> lock(mutex);
+        idleCondition.wait(lock, [this]() {
+            return pendingBuildCount == 0;
+        });
+    }
+
+    void VulkanGraphicsPipelineCache::evict(VulkanShader* shader) {
+        bool retired;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            uint32_t evictedCount = 0;
+            for (auto iterator = pipelines.begin(); iterator != pipelines.end();) {
+                const GraphicsPipelineDescription& description = iterator->first;
+                if (description.VertexShader != shader && description.FragmentShader != shader) {
+                    ++iterator;
+                    continue;
+                }
+                if (VulkanGraphicsPipeline* pipeline = evictEntry(iterator->second)) {
+                    pipeline->terminate();
+                    delete pipeline;
+                }
+                evictedCount++;
+                iterator = pipelines.erase(iterator);
+            }
+            if (evictedCount > 0) {
+                VD_LOG_INFO("Evicted [{}] Vulkan graphics pipelines", evictedCount);
+            }
+            retired = isUsedByEvictedBuild(shader);
+            if (retired) {
+                retiredShaders.push_back(shader);
+            }
+        }
+        if (!retired) {
+            shader->terminate();
+            delete shader;
+        }
+    }
+
+    void VulkanGraphicsPipelineCache::clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& [description, entry] : pipelines) {
+            if (VulkanGraphicsPipeline* pipeline = evictEntry(entry)) {
+                pipeline->terminate();
+                delete pipeline;
+            }
+        }
+        if (!pipelines.empty()) {
+            VD_LOG_INFO("Destroyed [{}] Vulkan graphics pipelines", pipelines.size());
+        }
+        pipelines.clear();
+    }
+
+    VulkanGraphicsPipelineCache::Stats VulkanGraphicsPipelineCache::getStats() {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        return stats;
+    }
+
+    void VulkanGraphicsPipelineCache::runBuildJob(const std::shared_ptr<Build>& queuedBuild) {
+        if (queuedBuild->Claimed.exchange(true)) {
+            return;
+        }
+        bool stopped;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = !running;
+        }
+        if (!stopped) {
+            build(*queuedBuild);
+            return;
+        }
+        // Builds nobody got to are resolved as failed so that waiting threads do not block forever
+        std::vector<VulkanShader*> releasedShaders;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            releasedShaders = finishBuild(*queuedBuild, nullptr);
+        }
+        for (VulkanShader* shader : releasedShaders) {
+            shader->terminate();
+            delete shader;
+        }
+    }
+
+    void VulkanGraphicsPipelineCache::stopBuildJobs() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+        // Jobs that start from now on only resolve their build
+        jobSystem->wait(buildJobs);
+        idleCondition.notify_all();
+    }
+
+    std::shared_ptr<VulkanGraphicsPipelineCache::Build> VulkanGraphicsPipelineCache::addBuild(const GraphicsPipelineDescription& description, bool queued) {
+        if (queued && !running) {
+            return nullptr;
+        }
+        auto newBuild = std::make_shared<Build>();
+        newBuild->Description = description;
+        newBuild->Queued = queued;
+        pipelines.emplace(description, Entry{newBuild->Promise.get_future().share(), newBuild});
+        {
+            std::lock_guard<std::mutex> statsLock(statsMutex);
+            stats.Misses++;
+        }
+        if (newBuild->Queued) {
+            if (pendingBuildCount++ == 0) {
+                batchStartTime = std::chrono::steady_clock::now();
+                batchBuildCount = 0;
+            }
+        }
+        return newBuild;
+    }
+
+    void VulkanGraphicsPipelineCache::scheduleBuilds(const std::vector<std::shared_ptr<Build>>& newBuilds) {
+        for (const std::shared_ptr<Build>& newBuild : newBuilds) {
+            if (newBuild->Queued) {
+                // Compiling takes long, a thread that waits for its own jobs must not end up stuck in one
+                jobSystem->scheduleBackground([this, newBuild]() {
+                    runBuildJob(newBuild);
+                }, &buildJobs);
+            }
+        }
+    }
+
+    VulkanGraphicsPipeline* VulkanGraphicsPipelineCache::build(Build& build) {
+        auto startTime = std::chrono::steady_clock::now();
+        auto* pipeline = new VulkanGraphicsPipeline(vulkanDevice, vulkanLayoutCache);
+        bool initialized = pipeline->initialize(build.Description, pipelineCache);
+        double compileSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (!initialized) {
+            VD_LOG_ERROR("Could not build Vulkan graphics pipeline [{:016x}]", build.Description.getHash());
+            pipeline->terminate();
+            delete pipeline;
+            pipeline = nullptr;
+        } else {
+            VD_LOG_INFO("Built Vulkan graphics pipeline [{:016x}] in [{:.2f}] ms", build.Description.getHash(), compileSeconds * 1000.0);
+        }
+        {
+            std::lock_guard<std::mutex> statsLock(statsMutex);
+            stats.CompileSeconds += compileSeconds;
+            if (pipeline == nullptr) {
+                stats.Failures++;
+            }
+        }
+
+        std::vector<VulkanShader*> releasedShaders;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (build.Evicted && pipeline != nullptr) {
+                pipeline->terminate();
+                delete pipeline;
+                pipeline = nullptr;
+            }
+            releasedShaders = finishBuild(build, pipeline);
+        }
+        for (VulkanShader* shader : releasedShaders) {
+            shader->terminate();
+            delete shader;
+        }
+        return pipeline;
+    }
+
+    VulkanGraphicsPipeline* VulkanGraphicsPipelineCache::evictEntry(Entry& entry) {
+        // Builds are resolved under the mutex, so a build that is not ready here sees that it was evicted when it finishes
+        if (entry.Pipeline.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            return entry.Pipeline.get();
+        }
+        Build& build = *entry.PendingBuild;
+        if (!build.Claimed.exchange(true)) {
+            // Its job has not started yet, and returns right away once it does
+            build.Evicted = true;
+            finishBuild(build, nullptr);
+            return nullptr;
+        }
+        build.Evicted = true;
+        evictedBuilds.push_back(entry.PendingBuild);
+        return nullptr;
+    }
+
+    std::vector<VulkanShader*> VulkanGraphicsPipelineCache::finishBuild(Build& build, VulkanGraphicsPipeline* pipeline) {
+        build.Promise.set_value(pipeline);
+        if (build.Queued) {
+            batchBuildCount++;
+            if (--pendingBuildCount == 0) {
+                double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - batchStartTime).count();
+                VD_LOG_INFO("Finished [{}] queued Vulkan graphics pipeline builds in [{:.2f}] ms", batchBuildCount, milliseconds);
+                idleCondition.notify_all();
+            }
+        }
+        std::vector<VulkanShader*> releasedShaders;
+        if (!build.Evicted) {
+            return releasedShaders;
+        }
+        evictedBuilds.erase(std::remove_if(evictedBuilds.begin(), evictedBuilds.end(), [&build](const std::shared_ptr<Build>& evictedBuild) {
+            return evictedBuild.get() == &build;
+        }), evictedBuilds.end());
+        for (auto iterator = retiredShaders.begin(); iterator != retiredShaders.end();) {
+            if (isUsedByEvictedBuild(*iterator)) {
+                ++iterator;
+                continue;
+            }
+            releasedShaders.push_back(*iterator);
+            iterator = retiredShaders.erase(iterator);
+        }
+        return releasedShaders;
+    }
+
+    bool VulkanGraphicsPipelineCache::isUsedByEvictedBuild(const VulkanShader* shader) const {
+        return std::any_of(evictedBuilds.begin(), evictedBuilds.end(), [shader](const std::shared_ptr<Build>& evictedBuild) {
+            return evictedBuild->Description.VertexShader == shader || evictedBuild->Description.FragmentShader == shader;
+        });
+    }
+
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "JobSystem.h"
+#include "VulkanDevice.h"
+#include "VulkanGraphicsPipeline.h"
+#include "VulkanLayoutCache.h"
+#include "VulkanShader.h"
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Vulkandemo {
+
+    // Builds each distinct pipeline description exactly once and hands out the existing pipeline for identical descriptions. Queued builds are
+    // compiled by jobs, so every thread of the job system can compile.
+    class VulkanGraphicsPipelineCache {
+    public:
+        struct Stats {
+            uint32_t Hits = 0;
+            uint32_t Misses = 0;
+            uint32_t Failures = 0;
+            double CompileSeconds = 0.0;
+        };
+
+    private:
+        static const VkAllocationCallbacks* ALLOCATOR;
+
+    private:
+        struct DescriptionHash {
+            size_t operator()(const GraphicsPipelineDescription& description) const;
+        };
+
+        // Whichever thread claims a build first compiles it, so a pipeline that is needed right away does not wait for its job to start
+        struct Build {
+            GraphicsPipelineDescription Description;
+            std::promise<VulkanGraphicsPipeline*> Promise;
+            std::atomic<bool> Claimed{false};
+            bool Queued = false;
+            // Set under the mutex when the entry was removed while the build was running, its pipeline is destroyed instead of published
+            bool Evicted = false;
+        };
+
+        struct Entry {
+            std::shared_future<VulkanGraphicsPipeline*> Pipeline;
+            std::shared_ptr<Build> PendingBuild;
+        };
+
+    private:
+        VulkanDevice* vulkanDevice;
+        VulkanLayoutCache* vulkanLayoutCache;
+        JobSystem* jobSystem;
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+        std::mutex mutex;
+        std::unordered_map<GraphicsPipelineDescription, Entry, DescriptionHash> pipelines;
+        // Removed from the map while still running
+        std::vector<std::shared_ptr<Build>> evictedBuilds;
+        // Taken over by evict, destroyed once no evicted build uses them anymore
+        std::vector<VulkanShader*> retiredShaders;
+        JobSystem::Counter buildJobs;
+        std::condition_variable idleCondition;
+        bool running = false;
+        uint32_t pendingBuildCount = 0;
+        uint32_t batchBuildCount = 0;
+        std::chrono::steady_clock::time_point batchStartTime;
+        std::mutex statsMutex;
+        Stats stats;
+
+    public:
+        VulkanGraphicsPipelineCache(VulkanDevice* vulkanDevice, VulkanLayoutCache* vulkanLayoutCache, JobSystem* jobSystem);
+
+        ~VulkanGraphicsPipelineCache();
+
+        bool initialize();
+
+        void terminate();
+
+        // Returns nullptr if the pipeline could not be built. Blocks while another thread is building the same description.
+        VulkanGraphicsPipeline* getPipeline(const GraphicsPipelineDescription& description);
+
+        // Returns nullptr while the pipeline is not built yet instead of blocking, and queues a build job if nobody requested it before
+        VulkanGraphicsPipeline* tryGetPipeline(const GraphicsPipelineDescription& description);
+
+        // Queues a build job per pipeline, so they are ready by the time they are first used
+        void precompile(const std::vector<GraphicsPipelineDescription>& descriptions);
+
+        void waitForPrecompile();
+
+        // Removes the pipelines built from the shader and takes over the shader. Neither waits for builds: finished pipelines are destroyed once
+        // the submissions made so far have completed, builds that have not started are dropped, and running builds destroy their pipeline instead
+        // of publishing it. The shader is destroyed once no build uses it anymore.
+        void evict(VulkanShader* shader);
+
+        // Removes every pipeline like evict, e.g. when the render pass they were built for is recreated. The device does not have to be idle,
+        // frames in flight may still use the pipelines, which are destroyed once the submissions made so far have completed.
+        void clear();
+
+        Stats getStats();
+
+    private:
+        void runBuildJob(const std::shared_ptr<Build>& queuedBuild);
+
+        // Resolves builds whose job has not started yet as failed and waits for the running ones
+        void stopBuildJobs();
+
+        // Must be called with the mutex locked. Returns nullptr without adding an entry for queued builds once the build jobs have stopped, since
+        // nothing would resolve them.
+        std::shared_ptr<Build> addBuild(const GraphicsPipelineDescription& description, bool queued);
+
+        // Must be called with the mutex unlocked, since a job may run right away on the calling thread
+        void scheduleBuilds(const std::vector<std::shared_ptr<Build>>& newBuilds);
+
+        VulkanGraphicsPipeline* build(Build& build);
+
+        // Must be called with the mutex locked. Returns the pipeline of a finished build, or nullptr if there is none (yet), in which case a running
+        // build is marked as evicted.
+        VulkanGraphicsPipeline* evictEntry(Entry& entry);
+
+        // Must be called with the mutex locked. Resolves the build and, if it was evicted, returns the retired shaders no evicted build uses anymore.
+        std::vector<VulkanShader*> finishBuild(Build& build, VulkanGraphicsPipeline* pipeline);
+
+        // Must be called with the mutex locked
+        bool isUsedByEvictedBuild(const VulkanShader* shader) const;
+    };
+
+}
@@ -0,0 +1,91 @@
+#include "VulkanIndirectDrawBuffer.h"
+#include "Assert.h"
+#include "Log.h"
+
+#include <algorithm>
+
+namespace Vulkandemo {
+
+    VulkanIndirectDrawBuffer::VulkanIndirectDrawBuffer(Config config, VulkanPhysicalDevice* vulkanPhysicalDevice, VulkanDevice* vulkanDevice, VulkanBindlessDescriptors* vulkanBindlessDescriptors)
+            : config(config),
+              vulkanPhysicalDevice(vulkanPhysicalDevice),
+              vulkanDevice(vulkanDevice),
+              buffer({
+                             config.FrameCount,
+                             COMMANDS_OFFSET + config.MaxDrawCount * sizeof(VkDrawIndexedIndirectCommand),
+                             VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                     }, vulkanPhysicalDevice, vulkanDevice, vulkanBindlessDescriptors) {
+    }
+
+    bool VulkanIndirectDrawBuffer::initialize() {
+        if (!buffer.initialize()) {
+            VD_LOG_ERROR("Could not create Vulkan indirect draw buffers");
+            return false;
+        }
+        VD_LOG_INFO("Created Vulkan indirect draw buffers for [{}] draws (multi-draw indirect [{}], draw count [{}])", config.MaxDrawCount, vulkanPhysicalDevice->getFeatures().multiDrawIndirect == VK_TRUE, isDrawCountSupported());
+        return true;
+    }
+
+    void VulkanIndirectDrawBuffer::terminate() {
+        buffer.terminate();
+    }
+
+    void VulkanIndirectDrawBuffer::beginFrame(uint32_t frameIndex) {
+        buffer.beginFrame(frameIndex);
+    }
+
+    uint32_t VulkanIndirectDrawBuffer::getMaxDrawCount() const {
+        return config.MaxDrawCount;
+    }
+
+    VkBuffer VulkanIndirectDrawBuffer::getBuffer() const {
+        return buffer.getBuffer();
+    }
+
+    uint32_t VulkanIndirectDrawBuffer::getBindlessIndex() const {
+        return buffer.getBindlessIndex();
+    }
+
+    VkDrawIndexedIndirectCommand* VulkanIndirectDrawBuffer::getCommands() const {
+        return (VkDrawIndexedIndirectCommand*) ((char*) buffer.getMappedData() + COMMANDS_OFFSET);
+    }
+
+    uint32_t VulkanIndirectDrawBuffer::getDrawCount() const {
+        return *(const uint32_t*) ((const char*) buffer.getMappedData() + DRAW_COUNT_OFFSET);
+    }
+
+    void VulkanIndirectDrawBuffer::setDrawCount(uint32_t drawCount) const {
+        *(uint32_t*) ((char*) buffer.getMappedData() + DRAW_COUNT_OFFSET) = drawCount;
+    }
+
+    uint32_t VulkanIndirectDrawBuffer::draw(const VulkanCommandBuffer& vulkanCommandBuffer, uint32_t drawCount) const {
+        drawCount = std::min(drawCount, config.MaxDrawCount);
+        constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+        if (vulkanPhysicalDevice->getFeatures().multiDrawIndirect != VK_TRUE) {
+            for (uint32_t i = 0; i < drawCount; i++) {
+                vkCmdDrawIndexedIndirect(vulkanCommandBuffer.getCommandBuffer(), buffer.getBuffer(), COMMANDS_OFFSET + i * stride, 1, stride);
+            }
+            return drawCount;
+        }
+        uint32_t maxDrawIndirectCount = std::max(vulkanPhysicalDevice->getProperties().limits.maxDrawIndirectCount, 1u);
+        uint32_t drawCallCount = 0;
+        for (uint32_t firstDraw = 0; firstDraw < drawCount; firstDraw += maxDrawIndirectCount) {
+            uint32_t chunkDrawCount = std::min(drawCount - firstDraw, maxDrawIndirectCount);
+            vkCmdDrawIndexedIndirect(vulkanCommandBuffer.getCommandBuffer(), buffer.getBuffer(), COMMANDS_OFFSET + firstDraw * stride, chunkDrawCount, stride);
+            drawCallCount++;
+        }
+        return drawCallCount;
+    }
+
+    bool VulkanIndirectDrawBuffer::isDrawCountSupported() const {
+        // maxDrawIndirectCount is 1 without multiDrawIndirect
+        return vulkanDevice->getCmdDrawIndexedIndirectCount() != nullptr && config.MaxDrawCount <= vulkanPhysicalDevice->getProperties().limits.maxDrawIndirectCount;
+    }
+
+    void VulkanIndirectDrawBuffer::drawWithCount(const VulkanCommandBuffer& vulkanCommandBuffer) const {
+        VD_ASSERT(isDrawCountSupported());
+        constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+        vulkanDevice->getCmdDrawIndexedIndirectCount()(vulkanCommandBuffer.getCommandBuffer(), buffer.getBuffer(), COMMANDS_OFFSET, buffer.getBuffer(), DRAW_COUNT_OFFSET, config.MaxDrawCount, stride);
+    }
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "VulkanPhysicalDevice.h"
+#include "VulkanDevice.h"
+#include "VulkanCommandBuffer.h"
+#include "VulkanPerFrameBuffer.h"
+#include "VulkanBindlessDescriptors.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+
+namespace Vulkandemo {
+
+    // Per-frame draw lists of VkDrawIndexedIndirectCommand, filled by the CPU or a compute shader and consumed with multi-draw indirect, so all draws
+    // sharing a pipeline take a single API call. As a storage buffer the layout is:
+    //   uint drawCount;                       // offset 0, read by drawWithCount
+    //   VkDrawIndexedIndirectCommand commands[]; // offset COMMANDS_OFFSET
+    class VulkanIndirectDrawBuffer {
+    public:
+        static constexpr VkDeviceSize DRAW_COUNT_OFFSET = 0;
+        static constexpr VkDeviceSize COMMANDS_OFFSET = 16;
+
+        struct Config {
+            uint32_t FrameCount = 2;
+            uint32_t MaxDrawCount = 1;
+        };
+
+    private:
+        Config config;
+        VulkanPhysicalDevice* vulkanPhysicalDevice;
+        VulkanDevice* vulkanDevice;
+        VulkanPerFrameBuffer buffer;
+
+    public:
+        VulkanIndirectDrawBuffer(Config config, VulkanPhysicalDevice* vulkanPhysicalDevice, VulkanDevice* vulkanDevice, VulkanBindlessDescriptors* vulkanBindlessDescriptors = nullptr);
+
+        bool initialize();
+
+        void terminate();
+
+        // Selects the draw list of the frame, call once its fence has been waited on
+        void beginFrame(uint32_t frameIndex);
+
+        uint32_t getMaxDrawCount() const;
+
+        VkBuffer getBuffer() const;
+
+        uint32_t getBindlessIndex() const;
+
+        VkDrawIndexedIndirectCommand* getCommands() const;
+
+        uint32_t getDrawCount() const;
+
+        void setDrawCount(uint32_t drawCount) const;
+
+        // Draws the first drawCount commands and returns the number of draw calls recorded, which is 1 unless the device lacks multiDrawIndirect
+        uint32_t draw(const VulkanCommandBuffer& vulkanCommandBuffer, uint32_t drawCount) const;
+
+        // The count is only read on the GPU, so the draws cannot be split like draw() does. Unsupported if the device lacks
+        // vkCmdDrawIndexedIndirectCount or cannot draw MaxDrawCount commands in one call.
+        bool isDrawCountSupported() const;
+
+        // Draws as many commands as the draw count in the buffer says, e.g. when it was written by a compute shader. Requires isDrawCountSupported.
+        void drawWithCount(const VulkanCommandBuffer& vulkanCommandBuffer) const;
+    };
+
+}
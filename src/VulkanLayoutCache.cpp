@@ -0,0 +1,202 @@
+#include "VulkanLayoutCache.h"
+#include "Log.h"
+
+#include <algorithm>
+
+namespace Vulkandemo {
+
+    const VkAllocationCallbacks* VulkanLayoutCache::ALLOCATOR = VK_NULL_HANDLE;
+
+    VulkanLayoutCache::VulkanLayoutCache(VulkanDevice* vulkanDevice) : vulkanDevice(vulkanDevice) {
+    }
+
+    void VulkanLayoutCache::terminate() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& [key, pipelineLayout] : pipelineLayouts) {
+            vkDestroyPipelineLayout(vulkanDevice->getDevice(), pipelineLayout, ALLOCATOR);
+        }
+        for (auto& [key, descriptorSetLayout] : descriptorSetLayouts) {
+            vkDestroyDescriptorSetLayout(vulkanDevice->getDevice(), descriptorSetLayout, ALLOCATOR);
+        }
+        VD_LOG_INFO("Destroyed [{}] Vulkan pipeline layouts and [{}] Vulkan descriptor set layouts", pipelineLayouts.size(), descriptorSetLayouts.size());
+        pipelineLayouts.clear();
+        descriptorSetLayouts.clear();
+    }
+
+    VkDescriptorSetLayout VulkanLayoutCache::getDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings) {
+        std::vector<VkDescriptorSetLayoutBinding> sortedBindings = bindings;
+        std::sort(sortedBindings.begin(), sortedBindings.end(), [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) {
+            return a.binding < b.binding;
+        });
+        std::vector<uint64_t> key;
+        key.reserve(sortedBindings.size() * 4);
+        for (const VkDescriptorSetLayoutBinding& binding : sortedBindings) {
+            key.push_back(binding.binding);
+            key.push_back(binding.descriptorType);
+            key.push_back(binding.descriptorCount);
+            key.push_back(binding.stageFlags);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto iterator = descriptorSetLayouts.find(key);
+        if (iterator != descriptorSetLayouts.end()) {
+            return iterator->second;
+        }
+
+        VkDescriptorSetLayoutCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        createInfo.bindingCount = (uint32_t) sortedBindings.size();
+        createInfo.pBindings = sortedBindings.data();
+
+        VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+        if (vkCreateDescriptorSetLayout(vulkanDevice->getDevice(), &createInfo, ALLOCATOR, &descriptorSetLayout) != VK_SUCCESS) {
+            VD_LOG_ERROR("Could not create Vulkan descriptor set layout");
+            return VK_NULL_HANDLE;
+        }
+        descriptorSetLayouts.emplace(std::move(key), descriptorSetLayout);
+        VD_LOG_INFO("Created Vulkan descriptor set layout with [{}] bindings", sortedBindings.size());
+        return descriptorSetLayout;
+    }
+
+    VkPipelineLayout VulkanLayoutCache::getPipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts, const std::vector<VkPushConstantRange>& pushConstantRanges) {
+        std::vector<uint64_t> key;
+        key.reserve(1 + setLayouts.size() + pushConstantRanges.size() * 3);
+        key.push_back(setLayouts.size());
+        for (VkDescriptorSetLayout setLayout : setLayouts) {
+            key.push_back((uint64_t) setLayout);
+        }
+        for (const VkPushConstantRange& pushConstantRange : pushConstantRanges) {
+            key.push_back(pushConstantRange.stageFlags);
+            key.push_back(pushConstantRange.offset);
+            key.push_back(pushConstantRange.size);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto iterator = pipelineLayouts.find(key);
+        if (iterator != pipelineLayouts.end()) {
+            return iterator->second;
+        }
+
+        VkPipelineLayoutCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        createInfo.setLayoutCount = (uint32_t) setLayouts.size();
+        createInfo.pSetLayouts = setLayouts.data();
+        createInfo.pushConstantRangeCount = (uint32_t) pushConstantRanges.size();
+        createInfo.pPushConstantRanges = pushConstantRanges.data();
+
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        if (vkCreatePipelineLayout(vulkanDevice->getDevice(), &createInfo, ALLOCATOR, &pipelineLayout) != VK_SUCCESS) {
+            VD_LOG_ERROR("Could not create Vulkan pipeline layout");
+            return VK_NULL_HANDLE;
+        }
+        pipelineLayouts.emplace(std::move(key), pipelineLayout);
+        VD_LOG_INFO("Created Vulkan pipeline layout with [{}] descriptor set layouts and [{}] push constant ranges", setLayouts.size(), pushConstantRanges.size());
+        return pipelineLayout;
+    }
+
+    VkPipelineLayout VulkanLayoutCache::getPipelineLayout(
+            const std::vector<const VulkanShader*>& shaders,
+            const std::map<uint32_t, VkDescriptorSetLayout>& setLayouts,
+            const VkPushConstantRange& declaredPushConstantRange,
+            VkPushConstantRange& pushConstantRange
+    ) {
+        // Bindings used by several stages are merged into one binding visible to all of them
+        std::map<uint32_t, std::map<uint32_t, VkDescriptorSetLayoutBinding>> sets;
+        VkPushConstantRange reflectedRange{};
+        for (const VulkanShader* shader : shaders) {
+            const VulkanShaderReflection& reflection = shader->getReflection();
+            for (const ShaderDescriptorBinding& descriptorBinding : reflection.getDescriptorBindings()) {
+                if (setLayouts.count(descriptorBinding.Set) > 0) {
+                    continue;
+                }
+                if (descriptorBinding.DescriptorCount == 0) {
+                    VD_LOG_ERROR("Could not use runtime sized descriptor array [{}] (set [{}], binding [{}])", descriptorBinding.Name, descriptorBinding.Set, descriptorBinding.Binding);
+                    return VK_NULL_HANDLE;
+                }
+                auto [iterator, inserted] = sets[descriptorBinding.Set].try_emplace(descriptorBinding.Binding);
+                VkDescriptorSetLayoutBinding& binding = iterator->second;
+                if (inserted) {
+                    binding.binding = descriptorBinding.Binding;
+                    binding.descriptorType = descriptorBinding.DescriptorType;
+                    binding.descriptorCount = descriptorBinding.DescriptorCount;
+                    binding.pImmutableSamplers = nullptr;
+                } else if (binding.descriptorType != descriptorBinding.DescriptorType || binding.descriptorCount != descriptorBinding.DescriptorCount) {
+                    VD_LOG_ERROR("Could not merge mismatching declarations of [{}] (set [{}], binding [{}]) across shader stages", descriptorBinding.Name, descriptorBinding.Set, descriptorBinding.Binding);
+                    return VK_NULL_HANDLE;
+                }
+                binding.stageFlags |= reflection.getStage();
+            }
+            for (const VkPushConstantRange& range : reflection.getPushConstantRanges()) {
+                uint32_t end = std::max(reflectedRange.offset + reflectedRange.size, range.offset + range.size);
+                reflectedRange.offset = reflectedRange.stageFlags == 0 ? range.offset : std::min(reflectedRange.offset, range.offset);
+                reflectedRange.size = end - reflectedRange.offset;
+                reflectedRange.stageFlags |= range.stageFlags;
+            }
+        }
+
+        // Set numbers are indices into the pipeline layout, so unused sets in between get an empty layout
+        std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
+        uint32_t setCount = sets.empty() ? 0 : sets.rbegin()->first + 1;
+        if (!setLayouts.empty()) {
+            setCount = std::max(setCount, setLayouts.rbegin()->first + 1);
+        }
+        for (uint32_t set = 0; set < setCount; set++) {
+            auto setLayoutIterator = setLayouts.find(set);
+            if (setLayoutIterator != setLayouts.end()) {
+                descriptorSetLayouts.push_back(setLayoutIterator->second);
+                continue;
+            }
+            std::vector<VkDescriptorSetLayoutBinding> bindings;
+            auto iterator = sets.find(set);
+            if (iterator != sets.end()) {
+                for (const auto& [bindingNumber, binding] : iterator->second) {
+                    bindings.push_back(binding);
+                }
+            }
+            VkDescriptorSetLayout descriptorSetLayout = getDescriptorSetLayout(bindings);
+            if (descriptorSetLayout == VK_NULL_HANDLE) {
+                return VK_NULL_HANDLE;
+            }
+            descriptorSetLayouts.push_back(descriptorSetLayout);
+        }
+
+        if (!getPushConstantRange(reflectedRange, declaredPushConstantRange, pushConstantRange)) {
+            return VK_NULL_HANDLE;
+        }
+        std::vector<VkPushConstantRange> pushConstantRanges;
+        if (pushConstantRange.stageFlags != 0) {
+            pushConstantRanges.push_back(pushConstantRange);
+        }
+        return getPipelineLayout(descriptorSetLayouts, pushConstantRanges);
+    }
+
+    bool VulkanLayoutCache::getPushConstantRange(const VkPushConstantRange& reflectedRange, const VkPushConstantRange& declaredRange, VkPushConstantRange& pushConstantRange) const {
+        pushConstantRange = reflectedRange;
+        if (declaredRange.stageFlags != 0) {
+            bool reflectedRangeFits = reflectedRange.stageFlags == 0 || (
+                    (reflectedRange.stageFlags & ~declaredRange.stageFlags) == 0
+                    && reflectedRange.offset >= declaredRange.offset
+                    && reflectedRange.offset + reflectedRange.size <= declaredRange.offset + declaredRange.size
+            );
+            if (!reflectedRangeFits) {
+                VD_LOG_ERROR("Could not fit push constant block of the shaders (offset [{}], size [{}]) into the declared block (offset [{}], size [{}])", reflectedRange.offset, reflectedRange.size, declaredRange.offset, declaredRange.size);
+                return false;
+            }
+            pushConstantRange = declaredRange;
+        }
+        if (pushConstantRange.stageFlags == 0) {
+            return true;
+        }
+        uint32_t maxPushConstantsSize = vulkanDevice->getVulkanPhysicalDevice()->getProperties().limits.maxPushConstantsSize;
+        if (pushConstantRange.offset + pushConstantRange.size > maxPushConstantsSize) {
+            VD_LOG_ERROR("Could not use push constant block of [{}] bytes at offset [{}], the device supports [{}] bytes", pushConstantRange.size, pushConstantRange.offset, maxPushConstantsSize);
+            return false;
+        }
+        if (pushConstantRange.offset % 4 != 0 || pushConstantRange.size % 4 != 0) {
+            VD_LOG_ERROR("Could not use push constant block of [{}] bytes at offset [{}], both must be multiples of 4", pushConstantRange.size, pushConstantRange.offset);
+            return false;
+        }
+        return true;
+    }
+
+}
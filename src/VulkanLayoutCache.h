@@ -0,0 +1,50 @@
+#pragma once
+
+#include "VulkanDevice.h"
+#include "VulkanShader.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace Vulkandemo {
+
+    // Deduplicates descriptor set layouts and pipeline layouts by contents, so pipelines with identical resource interfaces share their layouts
+    class VulkanLayoutCache {
+    private:
+        static const VkAllocationCallbacks* ALLOCATOR;
+
+    private:
+        VulkanDevice* vulkanDevice;
+        std::mutex mutex;
+        std::map<std::vector<uint64_t>, VkDescriptorSetLayout> descriptorSetLayouts;
+        std::map<std::vector<uint64_t>, VkPipelineLayout> pipelineLayouts;
+
+    public:
+        explicit VulkanLayoutCache(VulkanDevice* vulkanDevice);
+
+        void terminate();
+
+        // Immutable samplers are not supported
+        VkDescriptorSetLayout getDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+
+        VkPipelineLayout getPipelineLayout(const std::vector<VkDescriptorSetLayout>& descriptorSetLayouts, const std::vector<VkPushConstantRange>& pushConstantRanges);
+
+        // Builds the layout of a pipeline from the descriptor bindings and push constant blocks reflected from its shaders. Sets in setLayouts use the
+        // given layouts instead of reflected ones. When declaredPushConstantRange is not empty the reflected block must fit inside it and the declared
+        // block is used. pushConstantRange receives the block of the layout, empty (zero stage flags) if there is none.
+        VkPipelineLayout getPipelineLayout(
+                const std::vector<const VulkanShader*>& shaders,
+                const std::map<uint32_t, VkDescriptorSetLayout>& setLayouts,
+                const VkPushConstantRange& declaredPushConstantRange,
+                VkPushConstantRange& pushConstantRange
+        );
+
+    private:
+        bool getPushConstantRange(const VkPushConstantRange& reflectedRange, const VkPushConstantRange& declaredRange, VkPushConstantRange& pushConstantRange) const;
+    };
+
+}
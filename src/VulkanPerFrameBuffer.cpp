@@ -0,0 +1,68 @@
+#include "VulkanPerFrameBuffer.h"
+#include "Log.h"
+
+#include <algorithm>
+
+namespace Vulkandemo {
+
+    VulkanPerFrameBuffer::VulkanPerFrameBuffer(Config config, VulkanPhysicalDevice* vulkanPhysicalDevice, VulkanDevice* vulkanDevice, VulkanBindlessDescriptors* vulkanBindlessDescriptors)
+            : config(config), vulkanPhysicalDevice(vulkanPhysicalDevice), vulkanDevice(vulkanDevice), vulkanBindlessDescriptors(vulkanBindlessDescriptors) {
+    }
+
+    bool VulkanPerFrameBuffer::initialize() {
+        uint32_t frameCount = std::max(config.FrameCount, 1u);
+        VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        bool bindless = vulkanBindlessDescriptors != nullptr && (config.Usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        for (uint32_t i = 0; i < frameCount; i++) {
+            VulkanBuffer buffer(vulkanPhysicalDevice, vulkanDevice);
+            if (!buffer.initialize(config.Size, config.Usage, memoryProperties)) {
+                VD_LOG_ERROR("Could not create per-frame Vulkan buffer for frame [{}]", i);
+                return false;
+            }
+            buffers.push_back(buffer);
+            if (!bindless) {
+                continue;
+            }
+            uint32_t bindlessIndex = vulkanBindlessDescriptors->registerStorageBuffer(buffer.getBuffer());
+            if (bindlessIndex == VulkanBindlessDescriptors::INVALID_INDEX) {
+                return false;
+            }
+            bindlessIndices.push_back(bindlessIndex);
+        }
+        VD_LOG_INFO("Created [{}] per-frame Vulkan buffers of [{}] bytes", buffers.size(), config.Size);
+        return true;
+    }
+
+    void VulkanPerFrameBuffer::terminate() {
+        for (uint32_t bindlessIndex : bindlessIndices) {
+            vulkanBindlessDescriptors->releaseStorageBuffer(bindlessIndex);
+        }
+        bindlessIndices.clear();
+        for (VulkanBuffer& buffer : buffers) {
+            buffer.terminate();
+        }
+        buffers.clear();
+        VD_LOG_INFO("Destroyed per-frame Vulkan buffers");
+    }
+
+    void VulkanPerFrameBuffer::beginFrame(uint32_t frameIndex) {
+        currentFrame = frameIndex % (uint32_t) buffers.size();
+    }
+
+    VkBuffer VulkanPerFrameBuffer::getBuffer() const {
+        return buffers[currentFrame].getBuffer();
+    }
+
+    VkDeviceSize VulkanPerFrameBuffer::getSize() const {
+        return config.Size;
+    }
+
+    void* VulkanPerFrameBuffer::getMappedData() const {
+        return buffers[currentFrame].getMappedData();
+    }
+
+    uint32_t VulkanPerFrameBuffer::getBindlessIndex() const {
+        return bindlessIndices.empty() ? VulkanBindlessDescriptors::INVALID_INDEX : bindlessIndices[currentFrame];
+    }
+
+}
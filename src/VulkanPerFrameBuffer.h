@@ -0,0 +1,59 @@
+#pragma once
+
+#include "VulkanPhysicalDevice.h"
+#include "VulkanDevice.h"
+#include "VulkanBuffer.h"
+#include "VulkanBindlessDescriptors.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace Vulkandemo {
+
+    // One persistently mapped buffer per frame in flight, so the CPU writes the data of the next frame while the GPU still reads the previous ones.
+    // Storage buffers are registered with the bindless descriptors when given, shaders then read the current frame's buffer through getBindlessIndex.
+    class VulkanPerFrameBuffer {
+    public:
+        struct Config {
+            uint32_t FrameCount = 2;
+            VkDeviceSize Size = 0;
+            VkBufferUsageFlags Usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        };
+
+    private:
+        Config config;
+        VulkanPhysicalDevice* vulkanPhysicalDevice;
+        VulkanDevice* vulkanDevice;
+        VulkanBindlessDescriptors* vulkanBindlessDescriptors;
+        std::vector<VulkanBuffer> buffers;
+        std::vector<uint32_t> bindlessIndices;
+        uint32_t currentFrame = 0;
+
+    public:
+        VulkanPerFrameBuffer(Config config, VulkanPhysicalDevice* vulkanPhysicalDevice, VulkanDevice* vulkanDevice, VulkanBindlessDescriptors* vulkanBindlessDescriptors = nullptr);
+
+        bool initialize();
+
+        void terminate();
+
+        // Selects the buffer of the frame, call once its fence has been waited on
+        void beginFrame(uint32_t frameIndex);
+
+        VkBuffer getBuffer() const;
+
+        VkDeviceSize getSize() const;
+
+        void* getMappedData() const;
+
+        template<typename T>
+        T* getMappedDataAs() const {
+            return (T*) getMappedData();
+        }
+
+        // VulkanBindlessDescriptors::INVALID_INDEX when the buffers are not registered
+        uint32_t getBindlessIndex() const;
+    };
+
+}
@@ -13,10 +13,34 @@ namespace Vulkandemo {
         return deviceInfo.PhysicalDevice;
     }
 
+    const VkPhysicalDeviceProperties& VulkanPhysicalDevice::getProperties() const {
+        return deviceInfo.Properties;
+    }
+
     const VkPhysicalDeviceFeatures& VulkanPhysicalDevice::getFeatures() const {
         return deviceInfo.Features;
     }
 
+    const VkPhysicalDeviceDescriptorIndexingFeatures& VulkanPhysicalDevice::getDescriptorIndexingFeatures() const {
+        return deviceInfo.DescriptorIndexingFeatures;
+    }
+
+    const VkPhysicalDeviceDescriptorIndexingProperties& VulkanPhysicalDevice::getDescriptorIndexingProperties() const {
+        return deviceInfo.DescriptorIndexingProperties;
+    }
+
+    bool VulkanPhysicalDevice::isDrawIndirectCountSupported() const {
+        return deviceInfo.DrawIndirectCountSupported;
+    }
+
+    bool VulkanPhysicalDevice::isSynchronization2Supported() const {
+        return deviceInfo.Synchronization2Supported;
+    }
+
+    bool VulkanPhysicalDevice::isVulkan12Supported() const {
+        return deviceInfo.Properties.apiVersion >= VK_API_VERSION_1_2;
+    }
+
     const QueueFamilyIndices& VulkanPhysicalDevice::getQueueFamilyIndices() const {
         return deviceInfo.QueueFamilyIndices;
     }
@@ -64,11 +88,31 @@ namespace Vulkandemo {
             VkPhysicalDeviceFeatures vkPhysicalDeviceFeatures;
             vkGetPhysicalDeviceFeatures(vkPhysicalDevice, &vkPhysicalDeviceFeatures);
 
+            VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures{};
+            descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+            VkPhysicalDeviceFeatures2 vkPhysicalDeviceFeatures2{};
+            vkPhysicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            vkPhysicalDeviceFeatures2.pNext = &descriptorIndexingFeatures;
+            vkGetPhysicalDeviceFeatures2(vkPhysicalDevice, &vkPhysicalDeviceFeatures2);
+
+            VkPhysicalDeviceDescriptorIndexingProperties descriptorIndexingProperties{};
+            descriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+            VkPhysicalDeviceProperties2 vkPhysicalDeviceProperties2{};
+            vkPhysicalDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+            vkPhysicalDeviceProperties2.pNext = &descriptorIndexingProperties;
+            vkGetPhysicalDeviceProperties2(vkPhysicalDevice, &vkPhysicalDeviceProperties2);
+
             DeviceInfo device{};
             device.PhysicalDevice = vkPhysicalDevice;
             device.Properties = vkPhysicalDeviceProperties;
             device.Features = vkPhysicalDeviceFeatures;
+            device.DescriptorIndexingFeatures = descriptorIndexingFeatures;
+            device.DescriptorIndexingFeatures.pNext = nullptr;
+            device.DescriptorIndexingProperties = descriptorIndexingProperties;
+            device.DescriptorIndexingProperties.pNext = nullptr;
             device.Extensions = findExtensions(vkPhysicalDevice);
+            device.DrawIndirectCountSupported = findDrawIndirectCountSupport(vkPhysicalDevice, vkPhysicalDeviceProperties.apiVersion, device.Extensions);
+            device.Synchronization2Supported = findSynchronization2Support(vkPhysicalDevice, device.Extensions);
             device.QueueFamilyIndices = findQueueFamilyIndices(vkPhysicalDevice);
             device.SwapChainInfo = findSwapChainInfo(vkPhysicalDevice);
 
@@ -90,7 +134,13 @@ namespace Vulkandemo {
 
     const std::vector<const char*>& VulkanPhysicalDevice::getOptionalExtensions() const {
         static std::vector<const char*> extensions = {
-                "VK_KHR_portability_subset"
+                "VK_KHR_portability_subset",
+                // Promoted to Vulkan 1.2, only needed on devices that report an older API version
+                "VK_KHR_maintenance3",
+                "VK_EXT_descriptor_indexing",
+                "VK_KHR_draw_indirect_count",
+                // Promoted to Vulkan 1.3, the render graph uses it on every Vulkan 1.2 device that has it
+                "VK_KHR_synchronization2"
         };
         return extensions;
     }
@@ -116,6 +166,39 @@ namespace Vulkandemo {
         return extensions;
     }
 
+    bool VulkanPhysicalDevice::findDrawIndirectCountSupport(VkPhysicalDevice device, uint32_t apiVersion, const std::vector<VkExtensionProperties>& extensions) const {
+        if (apiVersion >= VK_API_VERSION_1_2) {
+            VkPhysicalDeviceVulkan12Features vulkan12Features{};
+            vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+            VkPhysicalDeviceFeatures2 features{};
+            features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features.pNext = &vulkan12Features;
+            vkGetPhysicalDeviceFeatures2(device, &features);
+            return vulkan12Features.drawIndirectCount;
+        }
+        for (const VkExtensionProperties& extension : extensions) {
+            if (strcmp(extension.extensionName, "VK_KHR_draw_indirect_count") == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool VulkanPhysicalDevice::findSynchronization2Support(VkPhysicalDevice device, const std::vector<VkExtensionProperties>& extensions) const {
+        for (const VkExtensionProperties& extension : extensions) {
+            if (strcmp(extension.extensionName, "VK_KHR_synchronization2") == 0) {
+                VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features{};
+                synchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+                VkPhysicalDeviceFeatures2 features{};
+                features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+                features.pNext = &synchronization2Features;
+                vkGetPhysicalDeviceFeatures2(device, &features);
+                return synchronization2Features.synchronization2;
+            }
+        }
+        return false;
+    }
+
     QueueFamilyIndices VulkanPhysicalDevice::findQueueFamilyIndices(VkPhysicalDevice device) const {
         uint32_t queueFamilyCount = 0;
         vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
@@ -190,6 +273,10 @@ namespace Vulkandemo {
             VD_LOG_DEBUG("{0} does not have required queue family indices", deviceInfo.Properties.deviceName);
             return 0;
         }
+        if (!hasRequiredDescriptorIndexingFeatures(deviceInfo.DescriptorIndexingFeatures)) {
+            VD_LOG_DEBUG("{0} does not have required descriptor indexing features", deviceInfo.Properties.deviceName);
+            return 0;
+        }
         int rating = (int) deviceInfo.Properties.limits.maxImageDimension2D;
         if (deviceInfo.Properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
             rating += 1000;
@@ -222,6 +309,16 @@ namespace Vulkandemo {
         return queueFamilyIndices.GraphicsFamily.has_value() && queueFamilyIndices.PresentationFamily.has_value();
     }
 
+    bool VulkanPhysicalDevice::hasRequiredDescriptorIndexingFeatures(const VkPhysicalDeviceDescriptorIndexingFeatures& features) const {
+        return features.runtimeDescriptorArray
+               && features.descriptorBindingPartiallyBound
+               && features.descriptorBindingSampledImageUpdateAfterBind
+               && features.descriptorBindingStorageBufferUpdateAfterBind
+               && features.descriptorBindingUpdateUnusedWhilePending
+               && features.shaderSampledImageArrayNonUniformIndexing
+               && features.shaderStorageBufferArrayNonUniformIndexing;
+    }
+
     std::string VulkanPhysicalDevice::getDeviceTypeAsString(VkPhysicalDeviceType deviceType) const {
         switch (deviceType) {
             case VK_PHYSICAL_DEVICE_TYPE_OTHER:
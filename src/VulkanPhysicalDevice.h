@@ -29,6 +29,10 @@ namespace Vulkandemo {
             VkPhysicalDevice PhysicalDevice = nullptr;
             VkPhysicalDeviceProperties Properties{};
             VkPhysicalDeviceFeatures Features{};
+            VkPhysicalDeviceDescriptorIndexingFeatures DescriptorIndexingFeatures{};
+            VkPhysicalDeviceDescriptorIndexingProperties DescriptorIndexingProperties{};
+            bool DrawIndirectCountSupported = false;
+            bool Synchronization2Supported = false;
             std::vector<VkExtensionProperties> Extensions{};
             QueueFamilyIndices QueueFamilyIndices{};
             SwapChainInfo SwapChainInfo{};
@@ -43,8 +47,23 @@ namespace Vulkandemo {
 
         VkPhysicalDevice getPhysicalDevice() const;
 
+        const VkPhysicalDeviceProperties& getProperties() const;
+
         const VkPhysicalDeviceFeatures& getFeatures() const;
 
+        // Core in Vulkan 1.2 (VK_EXT_descriptor_indexing before), required for the bindless descriptor set
+        const VkPhysicalDeviceDescriptorIndexingFeatures& getDescriptorIndexingFeatures() const;
+
+        const VkPhysicalDeviceDescriptorIndexingProperties& getDescriptorIndexingProperties() const;
+
+        // vkCmdDrawIndexedIndirectCount, core in Vulkan 1.2 behind the drawIndirectCount feature (VK_KHR_draw_indirect_count before)
+        bool isDrawIndirectCountSupported() const;
+
+        // vkCmdPipelineBarrier2 through VK_KHR_synchronization2, the device is created for Vulkan 1.2 where it is not core
+        bool isSynchronization2Supported() const;
+
+        bool isVulkan12Supported() const;
+
         const QueueFamilyIndices& getQueueFamilyIndices() const;
 
         const SwapChainInfo& getSwapChainInfo() const;
@@ -68,6 +87,10 @@ namespace Vulkandemo {
 
         std::vector<VkExtensionProperties> findExtensions(VkPhysicalDevice device) const;
 
+        bool findDrawIndirectCountSupport(VkPhysicalDevice device, uint32_t apiVersion, const std::vector<VkExtensionProperties>& extensions) const;
+
+        bool findSynchronization2Support(VkPhysicalDevice device, const std::vector<VkExtensionProperties>& extensions) const;
+
         QueueFamilyIndices findQueueFamilyIndices(VkPhysicalDevice device) const;
 
         SwapChainInfo findSwapChainInfo(VkPhysicalDevice device) const;
@@ -78,6 +101,8 @@ namespace Vulkandemo {
 
         bool hasRequiredQueueFamilyIndices(const QueueFamilyIndices& queueFamilyIndices) const;
 
+        bool hasRequiredDescriptorIndexingFeatures(const VkPhysicalDeviceDescriptorIndexingFeatures& features) const;
+
         int getSuitabilityRating(const DeviceInfo& deviceInfo) const;
     };
 
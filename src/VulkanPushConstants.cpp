@@ -0,0 +1,11 @@
+#include "VulkanPushConstants.h"
+#include "Assert.h"
+
+namespace Vulkandemo {
+
+    void recordPushConstants(const VulkanCommandBuffer& vulkanCommandBuffer, VkPipelineLayout pipelineLayout, const VkPushConstantRange& pushConstantRange, const void* data, uint32_t size, uint32_t offset) {
+        VD_ASSERT(offset >= pushConstantRange.offset && offset + size <= pushConstantRange.offset + pushConstantRange.size);
+        vkCmdPushConstants(vulkanCommandBuffer.getCommandBuffer(), pipelineLayout, pushConstantRange.stageFlags, offset, size, data);
+    }
+
+}
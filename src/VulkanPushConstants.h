@@ -0,0 +1,29 @@
+#pragma once
+
+#include "VulkanCommandBuffer.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace Vulkandemo {
+
+    // Push constant blocks are plain structs matching the layout(push_constant) block of the shaders, shared by graphics and compute pipelines
+
+    template<typename T>
+    constexpr uint32_t getPushConstantSize() {
+        static_assert(sizeof(T) % 4 == 0, "Push constant blocks must be a multiple of 4 bytes");
+        static_assert(std::is_trivially_copyable_v<T>, "Push constant blocks are copied into the command buffer");
+        return (uint32_t) sizeof(T);
+    }
+
+    template<typename T>
+    VkPushConstantRange getPushConstantRange(VkShaderStageFlags stageFlags, uint32_t offset = 0) {
+        return {stageFlags, offset, getPushConstantSize<T>()};
+    }
+
+    // The pushed bytes must lie inside the range the pipeline layout was created with
+    void recordPushConstants(const VulkanCommandBuffer& vulkanCommandBuffer, VkPipelineLayout pipelineLayout, const VkPushConstantRange& pushConstantRange, const void* data, uint32_t size, uint32_t offset);
+
+}
@@ -0,0 +1,657 @@
+#include "VulkanRenderGraph.h"
+#include "Assert.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace Vulkandemo {
+
+    const VkAllocationCallbacks* VulkanRenderGraph::ALLOCATOR = VK_NULL_HANDLE;
+
+    VulkanRenderGraph::VulkanRenderGraph(VulkanPhysicalDevice* vulkanPhysicalDevice, VulkanDevice* vulkanDevice)
+            : vulkanPhysicalDevice(vulkanPhysicalDevice), vulkanDevice(vulkanDevice) {
+    }
+
+    void VulkanRenderGraph::terminate() {
+        destroyTransientImages();
+        transientImages.clear();
+        resources.clear();
+        passes.clear();
+        VD_LOG_INFO("Destroyed Vulkan render graph");
+    }
+
+    void VulkanRenderGraph::reset() {
+        resources.clear();
+        passes.clear();
+        for (TransientImage& transientImage : transientImages) {
+            transientImage.Declared = false;
+        }
+    }
+
+    RenderGraphResource VulkanRenderGraph::importImage(const std::string& name, VkImage image, VkImageAspectFlags aspect, RenderGraphAccess initialAccess, RenderGraphAccess finalAccess) {
+        AccessInfo initialAccessInfo = getAccessInfo(initialAccess);
+        Resource resource;
+        resource.Name = name;
+        resource.Image = image;
+        resource.Aspect = aspect;
+        resource.FinalAccess = finalAccess;
+        resource.State.Layout = initialAccessInfo.Layout;
+        resource.State.WriteStages = initialAccessInfo.Stages;
+        resource.State.WriteAccess = initialAccessInfo.Access;
+        resources.push_back(resource);
+        return resources.size() - 1;
+    }
+
+    RenderGraphResource VulkanRenderGraph::importBuffer(const std::string& name, VkBuffer buffer, RenderGraphAccess initialAccess, RenderGraphAccess finalAccess) {
+        AccessInfo initialAccessInfo = getAccessInfo(initialAccess);
+        Resource resource;
+        resource.Name = name;
+        resource.Buffer = buffer;
+        resource.FinalAccess = finalAccess;
+        resource.State.WriteStages = initialAccessInfo.Stages;
+        resource.State.WriteAccess = initialAccessInfo.Access;
+        resources.push_back(resource);
+        return resources.size() - 1;
+    }
+
+    RenderGraphResource VulkanRenderGraph::createImage(const std::string& name, const RenderGraphImageDescription& description) {
+        uint32_t transientImageIndex = 0;
+        while (transientImageIndex < transientImages.size() && transientImages[transientImageIndex].Name != name) {
+            transientImageIndex++;
+        }
+        if (transientImageIndex == transientImages.size()) {
+            TransientImage transientImage;
+            transientImage.Name = name;
+            transientImages.push_back(transientImage);
+            transientImagesChanged = true;
+        }
+        TransientImage& transientImage = transientImages[transientImageIndex];
+        VD_ASSERT(!transientImage.Declared);
+        const RenderGraphImageDescription& previousDescription = transientImage.Description;
+        bool changed = previousDescription.Format != description.Format
+                       || previousDescription.Extent.width != description.Extent.width
+                       || previousDescription.Extent.height != description.Extent.height
+                       || previousDescription.Usage != description.Usage
+                       || previousDescription.Aspect != description.Aspect;
+        if (changed) {
+            transientImage.Description = description;
+            transientImagesChanged = true;
+        }
+        transientImage.Declared = true;
+
+        Resource resource;
+        resource.Name = name;
+        resource.Aspect = description.Aspect;
+        resource.TransientImage = transientImageIndex;
+        resources.push_back(resource);
+        return resources.size() - 1;
+    }
+
+    void VulkanRenderGraph::setOutput(RenderGraphResource resource) {
+        resources.at(resource).Output = true;
+    }
+
+    RenderGraphPass VulkanRenderGraph::addPass(const std::string& name, const std::function<void(const VulkanCommandBuffer&)>& record) {
+        Pass pass;
+        pass.Name = name;
+        pass.Record = record;
+        passes.push_back(pass);
+        return passes.size() - 1;
+    }
+
+    void VulkanRenderGraph::read(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access) {
+        addUsage(pass, resource, access, true, false);
+    }
+
+    void VulkanRenderGraph::write(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access) {
+        addUsage(pass, resource, access, false, true);
+    }
+
+    VkImage VulkanRenderGraph::getImage(RenderGraphResource resource) const {
+        const Resource& graphResource = resources.at(resource);
+        if (graphResource.TransientImage != UINT32_MAX) {
+            return transientImages[graphResource.TransientImage].Image;
+        }
+        return graphResource.Image;
+    }
+
+    VkImageView VulkanRenderGraph::getImageView(RenderGraphResource resource) const {
+        const Resource& graphResource = resources.at(resource);
+        if (graphResource.TransientImage != UINT32_MAX) {
+            return transientImages[graphResource.TransientImage].ImageView;
+        }
+        return VK_NULL_HANDLE;
+    }
+
+    bool VulkanRenderGraph::compile() {
+        cullPasses();
+
+        // Images no longer declared give their memory back, which changes how the others alias
+        bool undeclared = std::any_of(transientImages.begin(), transientImages.end(), [](const TransientImage& transientImage) {
+            return !transientImage.Declared;
+        });
+        if (undeclared) {
+            destroyTransientImages();
+            std::vector<uint32_t> transientImageIndices(transientImages.size(), UINT32_MAX);
+            uint32_t declaredCount = 0;
+            for (uint32_t i = 0; i < transientImages.size(); i++) {
+                if (transientImages[i].Declared) {
+                    transientImageIndices[i] = declaredCount;
+                    transientImages[declaredCount++] = transientImages[i];
+                }
+            }
+            transientImages.resize(declaredCount);
+            for (Resource& resource : resources) {
+                if (resource.TransientImage != UINT32_MAX) {
+                    resource.TransientImage = transientImageIndices[resource.TransientImage];
+                }
+            }
+            transientImagesChanged = true;
+        }
+
+        if (transientImagesChanged) {
+            destroyTransientImages();
+            if (!createTransientImages()) {
+                return false;
+            }
+            transientImagesChanged = false;
+        }
+        if (transientImages.empty()) {
+            return true;
+        }
+
+        // Images are bound to memory for good, so when culling changes which of them alias they are created again
+        findTransientImageLifetimes();
+        std::vector<VkDeviceSize> offsets = findTransientImageOffsets();
+        if (transientMemory != VK_NULL_HANDLE) {
+            bool aliasingChanged = false;
+            for (uint32_t i = 0; i < transientImages.size(); i++) {
+                aliasingChanged |= transientImages[i].MemoryOffset != offsets[i];
+            }
+            if (!aliasingChanged) {
+                return true;
+            }
+            destroyTransientImages();
+            if (!createTransientImages()) {
+                return false;
+            }
+        }
+        return allocateTransientMemory(offsets);
+    }
+
+    void VulkanRenderGraph::execute(const VulkanCommandBuffer& vulkanCommandBuffer) {
+        for (Pass& pass : passes) {
+            if (!pass.Live) {
+                continue;
+            }
+            for (const ResourceUsage& usage : pass.Usages) {
+                Resource& resource = resources[usage.Resource];
+                if (!resource.Accessed && resource.TransientImage != UINT32_MAX) {
+                    beginTransientImage(resource);
+                }
+                resource.Accessed = true;
+                addBarrier(resource, usage.Access, usage.Write);
+            }
+            recordBarriers(vulkanCommandBuffer);
+            pass.Record(vulkanCommandBuffer);
+        }
+
+        // Resources no live pass touched are still in their initial state
+        for (Resource& resource : resources) {
+            if (resource.Accessed && resource.FinalAccess != RenderGraphAccess::None) {
+                addBarrier(resource, getAccessInfo(resource.FinalAccess), false);
+            }
+        }
+        recordBarriers(vulkanCommandBuffer);
+    }
+
+    VulkanRenderGraph::AccessInfo VulkanRenderGraph::getAccessInfo(RenderGraphAccess access) {
+        switch (access) {
+            case RenderGraphAccess::None:
+                return {VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_UNDEFINED};
+            case RenderGraphAccess::SwapChainAcquire:
+                return {VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_UNDEFINED};
+            case RenderGraphAccess::IndirectCommandRead:
+                return {VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT, VK_IMAGE_LAYOUT_GENERAL};
+            case RenderGraphAccess::ComputeShaderRead:
+                return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL};
+            case RenderGraphAccess::ComputeShaderWrite:
+                return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL};
+            case RenderGraphAccess::FragmentShaderRead:
+                return {VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+            case RenderGraphAccess::ColorAttachmentWrite:
+                return {
+                        VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                        VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+                };
+            case RenderGraphAccess::DepthAttachmentWrite:
+                return {
+                        VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                        VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+                };
+            case RenderGraphAccess::HostRead:
+                return {VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_READ_BIT, VK_IMAGE_LAYOUT_GENERAL};
+            case RenderGraphAccess::Present:
+                // Presentation waits on a semaphore, which makes the image visible to it
+                return {VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR};
+        }
+        return {VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_UNDEFINED};
+    }
+
+    void VulkanRenderGraph::addUsage(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access, bool read, bool write) {
+        AccessInfo accessInfo = getAccessInfo(access);
+        std::vector<ResourceUsage>& usages = passes.at(pass).Usages;
+        for (ResourceUsage& usage : usages) {
+            if (usage.Resource == resource) {
+                // An image can only be in one layout during a pass
+                VD_ASSERT(resources.at(resource).Buffer != VK_NULL_HANDLE || usage.Access.Layout == accessInfo.Layout);
+                usage.Access.Stages |= accessInfo.Stages;
+                usage.Access.Access |= accessInfo.Access;
+                usage.Read |= read;
+                usage.Write |= write;
+                return;
+            }
+        }
+        usages.push_back({resource, accessInfo, read, write});
+    }
+
+    void VulkanRenderGraph::cullPasses() {
+        std::vector<bool> needed(resources.size());
+        for (uint32_t i = 0; i < resources.size(); i++) {
+            needed[i] = resources[i].Output;
+        }
+        for (uint32_t i = passes.size(); i-- > 0;) {
+            Pass& pass = passes[i];
+            pass.Live = std::any_of(pass.Usages.begin(), pass.Usages.end(), [&needed](const ResourceUsage& usage) {
+                return usage.Write && needed[usage.Resource];
+            });
+            if (!pass.Live) {
+                continue;
+            }
+            // What a pass overwrites without reading does not need the passes that wrote it before
+            for (const ResourceUsage& usage : pass.Usages) {
+                if (usage.Write && !usage.Read) {
+                    needed[usage.Resource] = false;
+                }
+            }
+            for (const ResourceUsage& usage : pass.Usages) {
+                if (usage.Read) {
+                    needed[usage.Resource] = true;
+                }
+            }
+        }
+    }
+
+    void VulkanRenderGraph::findTransientImageLifetimes() {
+        for (TransientImage& transientImage : transientImages) {
+            transientImage.FirstPass = UINT32_MAX;
+            transientImage.LastPass = 0;
+        }
+        for (uint32_t i = 0; i < passes.size(); i++) {
+            if (!passes[i].Live) {
+                continue;
+            }
+            for (const ResourceUsage& usage : passes[i].Usages) {
+                uint32_t transientImageIndex = resources[usage.Resource].TransientImage;
+                if (transientImageIndex != UINT32_MAX) {
+                    TransientImage& transientImage = transientImages[transientImageIndex];
+                    transientImage.FirstPass = std::min(transientImage.FirstPass, i);
+                    transientImage.LastPass = std::max(transientImage.LastPass, i);
+                }
+            }
+        }
+    }
+
+    std::vector<VkDeviceSize> VulkanRenderGraph::findTransientImageOffsets() const {
+        // Largest first, each image goes to the lowest offset not taken by an image whose lifetime overlaps
+        std::vector<uint32_t> order(transientImages.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+            return transientImages[a].MemoryRequirements.size > transientImages[b].MemoryRequirements.size;
+        });
+
+        std::vector<VkDeviceSize> offsets(transientImages.size(), 0);
+        std::vector<uint32_t> placed;
+        std::vector<std::pair<VkDeviceSize, VkDeviceSize>> takenRanges;
+        for (uint32_t i : order) {
+            const TransientImage& transientImage = transientImages[i];
+            // Not used this frame, can alias anything
+            if (transientImage.FirstPass > transientImage.LastPass) {
+                continue;
+            }
+            takenRanges.clear();
+            for (uint32_t j : placed) {
+                const TransientImage& placedImage = transientImages[j];
+                bool overlapping = transientImage.FirstPass <= placedImage.LastPass && placedImage.FirstPass <= transientImage.LastPass;
+                if (overlapping) {
+                    takenRanges.emplace_back(offsets[j], offsets[j] + placedImage.MemoryRequirements.size);
+                }
+            }
+            std::sort(takenRanges.begin(), takenRanges.end());
+
+            VkDeviceSize size = transientImage.MemoryRequirements.size;
+            VkDeviceSize alignment = transientImage.MemoryRequirements.alignment;
+            VkDeviceSize offset = 0;
+            for (const std::pair<VkDeviceSize, VkDeviceSize>& takenRange : takenRanges) {
+                if (offset + size <= takenRange.first) {
+                    break;
+                }
+                VkDeviceSize alignedEnd = (takenRange.second + alignment - 1) / alignment * alignment;
+                offset = std::max(offset, alignedEnd);
+            }
+            offsets[i] = offset;
+            placed.push_back(i);
+        }
+        return offsets;
+    }
+
+    bool VulkanRenderGraph::createTransientImages() {
+        for (TransientImage& transientImage : transientImages) {
+            const RenderGraphImageDescription& description = transientImage.Description;
+            VkImageCreateInfo imageInfo{};
+            imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            imageInfo.imageType = VK_IMAGE_TYPE_2D;
+            imageInfo.format = description.Format;
+            imageInfo.extent.width = description.Extent.width;
+            imageInfo.extent.height = description.Extent.height;
+            imageInfo.extent.depth = 1;
+            imageInfo.mipLevels = 1;
+            imageInfo.arrayLayers = 1;
+            imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+            imageInfo.usage = description.Usage;
+            imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            if (vkCreateImage(vulkanDevice->getDevice(), &imageInfo, ALLOCATOR, &transientImage.Image) != VK_SUCCESS) {
+                VD_LOG_ERROR("Could not create Vulkan transient image [{}]", transientImage.Name);
+                return false;
+            }
+            vkGetImageMemoryRequirements(vulkanDevice->getDevice(), transientImage.Image, &transientImage.MemoryRequirements);
+        }
+        return true;
+    }
+
+    bool VulkanRenderGraph::allocateTransientMemory(const std::vector<VkDeviceSize>& offsets) {
+        VkDeviceSize memorySize = 0;
+        VkDeviceSize unaliasedMemorySize = 0;
+        uint32_t memoryTypeBits = UINT32_MAX;
+        for (uint32_t i = 0; i < transientImages.size(); i++) {
+            const VkMemoryRequirements& memoryRequirements = transientImages[i].MemoryRequirements;
+            memorySize = std::max(memorySize, offsets[i] + memoryRequirements.size);
+            unaliasedMemorySize += memoryRequirements.size;
+            memoryTypeBits &= memoryRequirements.memoryTypeBits;
+        }
+
+        uint32_t memoryTypeIndex;
+        if (!findMemoryType(memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, memoryTypeIndex)) {
+            VD_LOG_ERROR("Could not find Vulkan memory type shared by [{}] transient images", transientImages.size());
+            return false;
+        }
+
+        VkMemoryAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = memorySize;
+        allocateInfo.memoryTypeIndex = memoryTypeIndex;
+        if (vkAllocateMemory(vulkanDevice->getDevice(), &allocateInfo, ALLOCATOR, &transientMemory) != VK_SUCCESS) {
+            VD_LOG_ERROR("Could not allocate [{}] bytes of Vulkan memory for transient images", memorySize);
+            return false;
+        }
+
+        for (uint32_t i = 0; i < transientImages.size(); i++) {
+            TransientImage& transientImage = transientImages[i];
+            transientImage.MemoryOffset = offsets[i];
+            if (vkBindImageMemory(vulkanDevice->getDevice(), transientImage.Image, transientMemory, transientImage.MemoryOffset) != VK_SUCCESS) {
+                VD_LOG_ERROR("Could not bind Vulkan memory of transient image [{}]", transientImage.Name);
+                return false;
+            }
+
+            VkImageViewCreateInfo imageViewInfo{};
+            imageViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            imageViewInfo.image = transientImage.Image;
+            imageViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            imageViewInfo.format = transientImage.Description.Format;
+            imageViewInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+            imageViewInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+            imageViewInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+            imageViewInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+            imageViewInfo.subresourceRange.aspectMask = transientImage.Description.Aspect;
+            imageViewInfo.subresourceRange.baseMipLevel = 0;
+            imageViewInfo.subresourceRange.levelCount = 1;
+            imageViewInfo.subresourceRange.baseArrayLayer = 0;
+            imageViewInfo.subresourceRange.layerCount = 1;
+            if (vkCreateImageView(vulkanDevice->getDevice(), &imageViewInfo, ALLOCATOR, &transientImage.ImageView) != VK_SUCCESS) {
+                VD_LOG_ERROR("Could not create Vulkan image view of transient image [{}]", transientImage.Name);
+                return false;
+            }
+        }
+        VD_LOG_INFO("Allocated [{}] bytes of Vulkan memory for [{}] transient images, [{}] bytes without aliasing", memorySize, transientImages.size(), unaliasedMemorySize);
+        return true;
+    }
+
+    void VulkanRenderGraph::destroyTransientImages() {
+        std::vector<VkImageView> imageViews;
+        std::vector<VkImage> images;
+        for (TransientImage& transientImage : transientImages) {
+            if (transientImage.ImageView != VK_NULL_HANDLE) {
+                imageViews.push_back(transientImage.ImageView);
+            }
+            if (transientImage.Image != VK_NULL_HANDLE) {
+                images.push_back(transientImage.Image);
+            }
+            transientImage.ImageView = VK_NULL_HANDLE;
+            transientImage.Image = VK_NULL_HANDLE;
+            transientImage.MemoryOffset = 0;
+            // The images that replace these get new memory nothing has to wait for
+            transientImage.State = {};
+        }
+        if (images.empty() && transientMemory == VK_NULL_HANDLE) {
+            return;
+        }
+        vulkanDevice->getDeletionQueue()->destroyLater([device = vulkanDevice->getDevice(), imageViews, images, memory = transientMemory]() {
+            for (VkImageView imageView : imageViews) {
+                vkDestroyImageView(device, imageView, ALLOCATOR);
+            }
+            for (VkImage image : images) {
+                vkDestroyImage(device, image, ALLOCATOR);
+            }
+            vkFreeMemory(device, memory, ALLOCATOR);
+            VD_LOG_DEBUG("Destroyed [{}] Vulkan transient images", images.size());
+        });
+        transientMemory = VK_NULL_HANDLE;
+    }
+
+    bool VulkanRenderGraph::isMemoryOverlapping(const TransientImage& transientImage, const TransientImage& otherTransientImage) const {
+        return transientImage.MemoryOffset < otherTransientImage.MemoryOffset + otherTransientImage.MemoryRequirements.size
+               && otherTransientImage.MemoryOffset < transientImage.MemoryOffset + transientImage.MemoryRequirements.size;
+    }
+
+    void VulkanRenderGraph::beginTransientImage(const Resource& resource) {
+        // Includes the image itself, as the previous frame may still be using it
+        TransientImage& transientImage = transientImages[resource.TransientImage];
+        VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 access = VK_ACCESS_2_NONE;
+        for (const TransientImage& otherTransientImage : transientImages) {
+            if (isMemoryOverlapping(transientImage, otherTransientImage)) {
+                stages |= otherTransientImage.State.WriteStages | otherTransientImage.State.ReadStages;
+                access |= otherTransientImage.State.WriteAccess;
+            }
+        }
+        transientImage.State = {};
+        transientImage.State.WriteStages = stages;
+        transientImage.State.WriteAccess = access;
+    }
+
+    void VulkanRenderGraph::addBarrier(Resource& resource, const AccessInfo& access, bool write) {
+        constexpr VkAccessFlags2 writeAccess = VK_ACCESS_2_SHADER_WRITE_BIT
+                                               | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT
+                                               | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+                                               | VK_ACCESS_2_TRANSFER_WRITE_BIT
+                                               | VK_ACCESS_2_HOST_WRITE_BIT
+                                               | VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+        bool transient = resource.TransientImage != UINT32_MAX;
+        ResourceState& state = transient ? transientImages[resource.TransientImage].State : resource.State;
+        VkImage image = transient ? transientImages[resource.TransientImage].Image : resource.Image;
+        VkImageLayout oldLayout = state.Layout;
+        bool layoutChange = image != VK_NULL_HANDLE && access.Layout != state.Layout;
+
+        VkPipelineStageFlags2 srcStages;
+        VkAccessFlags2 srcAccess;
+        VkPipelineStageFlags2 dstStages;
+        VkAccessFlags2 dstAccess;
+        if (write || layoutChange) {
+            // Writes and layout transitions wait for the last write and every read since
+            srcStages = state.WriteStages | state.ReadStages;
+            srcAccess = state.WriteAccess;
+            dstStages = access.Stages;
+            dstAccess = access.Access;
+            state.Layout = image != VK_NULL_HANDLE ? access.Layout : state.Layout;
+            state.WriteStages = access.Stages;
+            state.WriteAccess = write ? access.Access & writeAccess : VK_ACCESS_2_NONE;
+            state.ReadStages = VK_PIPELINE_STAGE_2_NONE;
+            // A layout transition is visible to the access it was made for, a write to nothing but the pass that made it
+            state.VisibleStages = write ? VK_PIPELINE_STAGE_2_NONE : access.Stages;
+            state.VisibleAccess = write ? VK_ACCESS_2_NONE : access.Access;
+            if (srcStages == VK_PIPELINE_STAGE_2_NONE && !layoutChange) {
+                return;
+            }
+        } else {
+            // Reads only wait for the last write, unless an earlier barrier already made it visible to them
+            state.ReadStages |= access.Stages;
+            if (state.WriteStages == VK_PIPELINE_STAGE_2_NONE) {
+                return;
+            }
+            bool visible = (access.Stages & ~state.VisibleStages) == 0 && (access.Access & ~state.VisibleAccess) == 0;
+            if (visible) {
+                return;
+            }
+            state.VisibleStages |= access.Stages;
+            state.VisibleAccess |= access.Access;
+            srcStages = state.WriteStages;
+            srcAccess = state.WriteAccess;
+            dstStages = state.VisibleStages;
+            dstAccess = state.VisibleAccess;
+        }
+
+        if (image != VK_NULL_HANDLE) {
+            VkImageMemoryBarrier2KHR barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+            barrier.srcStageMask = srcStages;
+            barrier.srcAccessMask = srcAccess;
+            barrier.dstStageMask = dstStages;
+            barrier.dstAccessMask = dstAccess;
+            barrier.oldLayout = oldLayout;
+            barrier.newLayout = state.Layout;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = image;
+            barrier.subresourceRange.aspectMask = resource.Aspect;
+            barrier.subresourceRange.baseMipLevel = 0;
+            barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+            imageBarriers.push_back(barrier);
+        } else {
+            VkBufferMemoryBarrier2KHR barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+            barrier.srcStageMask = srcStages;
+            barrier.srcAccessMask = srcAccess;
+            barrier.dstStageMask = dstStages;
+            barrier.dstAccessMask = dstAccess;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.buffer = resource.Buffer;
+            barrier.offset = 0;
+            barrier.size = VK_WHOLE_SIZE;
+            bufferBarriers.push_back(barrier);
+        }
+    }
+
+    void VulkanRenderGraph::recordBarriers(const VulkanCommandBuffer& vulkanCommandBuffer) {
+        if (imageBarriers.empty() && bufferBarriers.empty()) {
+            return;
+        }
+        PFN_vkCmdPipelineBarrier2KHR cmdPipelineBarrier2 = vulkanDevice->getCmdPipelineBarrier2();
+        if (cmdPipelineBarrier2 != nullptr) {
+            VkDependencyInfoKHR dependencyInfo{};
+            dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+            dependencyInfo.imageMemoryBarrierCount = imageBarriers.size();
+            dependencyInfo.pImageMemoryBarriers = imageBarriers.data();
+            dependencyInfo.bufferMemoryBarrierCount = bufferBarriers.size();
+            dependencyInfo.pBufferMemoryBarriers = bufferBarriers.data();
+            cmdPipelineBarrier2(vulkanCommandBuffer.getCommandBuffer(), &dependencyInfo);
+        } else {
+            // The stages and access used by the graph have the same bits in both versions, only the stages of all barriers are merged
+            VkPipelineStageFlags srcStages = 0;
+            VkPipelineStageFlags dstStages = 0;
+            std::vector<VkImageMemoryBarrier> legacyImageBarriers;
+            for (const VkImageMemoryBarrier2KHR& imageBarrier : imageBarriers) {
+                srcStages |= (VkPipelineStageFlags) imageBarrier.srcStageMask;
+                dstStages |= (VkPipelineStageFlags) imageBarrier.dstStageMask;
+                VkImageMemoryBarrier barrier{};
+                barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+                barrier.srcAccessMask = (VkAccessFlags) imageBarrier.srcAccessMask;
+                barrier.dstAccessMask = (VkAccessFlags) imageBarrier.dstAccessMask;
+                barrier.oldLayout = imageBarrier.oldLayout;
+                barrier.newLayout = imageBarrier.newLayout;
+                barrier.srcQueueFamilyIndex = imageBarrier.srcQueueFamilyIndex;
+                barrier.dstQueueFamilyIndex = imageBarrier.dstQueueFamilyIndex;
+                barrier.image = imageBarrier.image;
+                barrier.subresourceRange = imageBarrier.subresourceRange;
+                legacyImageBarriers.push_back(barrier);
+            }
+            std::vector<VkBufferMemoryBarrier> legacyBufferBarriers;
+            for (const VkBufferMemoryBarrier2KHR& bufferBarrier : bufferBarriers) {
+                srcStages |= (VkPipelineStageFlags) bufferBarrier.srcStageMask;
+                dstStages |= (VkPipelineStageFlags) bufferBarrier.dstStageMask;
+                VkBufferMemoryBarrier barrier{};
+                barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+                barrier.srcAccessMask = (VkAccessFlags) bufferBarrier.srcAccessMask;
+                barrier.dstAccessMask = (VkAccessFlags) bufferBarrier.dstAccessMask;
+                barrier.srcQueueFamilyIndex = bufferBarrier.srcQueueFamilyIndex;
+                barrier.dstQueueFamilyIndex = bufferBarrier.dstQueueFamilyIndex;
+                barrier.buffer = bufferBarrier.buffer;
+                barrier.offset = bufferBarrier.offset;
+                barrier.size = bufferBarrier.size;
+                legacyBufferBarriers.push_back(barrier);
+            }
+            // Without synchronization2 a stage mask may not be empty
+            if (srcStages == 0) {
+                srcStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            }
+            if (dstStages == 0) {
+                dstStages = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+            }
+            constexpr VkDependencyFlags dependencyFlags = 0;
+            vkCmdPipelineBarrier(
+                    vulkanCommandBuffer.getCommandBuffer(),
+                    srcStages,
+                    dstStages,
+                    dependencyFlags,
+                    0, nullptr,
+                    legacyBufferBarriers.size(), legacyBufferBarriers.data(),
+                    legacyImageBarriers.size(), legacyImageBarriers.data()
+            );
+        }
+        imageBarriers.clear();
+        bufferBarriers.clear();
+    }
+
+    bool VulkanRenderGraph::findMemoryType(uint32_t memoryTypeBits, VkMemoryPropertyFlags memoryProperties, uint32_t& memoryTypeIndex) const {
+        VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(vulkanPhysicalDevice->getPhysicalDevice(), &physicalDeviceMemoryProperties);
+        for (uint32_t i = 0; i < physicalDeviceMemoryProperties.memoryTypeCount; i++) {
+            bool allowed = memoryTypeBits & (1u << i);
+            bool hasProperties = (physicalDeviceMemoryProperties.memoryTypes[i].propertyFlags & memoryProperties) == memoryProperties;
+            if (allowed && hasProperties) {
+                memoryTypeIndex = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+}
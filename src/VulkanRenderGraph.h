@@ -0,0 +1,192 @@
+#pragma once
+
+#include "VulkanPhysicalDevice.h"
+#include "VulkanDevice.h"
+#include "VulkanCommandBuffer.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Vulkandemo {
+
+    // How a pass uses a resource, selects the pipeline stages, access and image layout barriers are built from
+    enum class RenderGraphAccess {
+        None,
+        // Initial access of a swap chain image, the acquire semaphore is waited on in the color attachment output stage
+        SwapChainAcquire,
+        IndirectCommandRead,
+        ComputeShaderRead,
+        ComputeShaderWrite,
+        FragmentShaderRead,
+        ColorAttachmentWrite,
+        DepthAttachmentWrite,
+        HostRead,
+        Present
+    };
+
+    struct RenderGraphImageDescription {
+        VkFormat Format = VK_FORMAT_UNDEFINED;
+        VkExtent2D Extent{};
+        VkImageUsageFlags Usage = 0;
+        VkImageAspectFlags Aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+    };
+
+    using RenderGraphResource = uint32_t;
+    using RenderGraphPass = uint32_t;
+
+}
+
+namespace Vulkandemo {
+
+    // Records a frame from passes that declare which resources they read and write, instead of passes synchronizing with each other by hand.
+    // The graph is declared again every frame and executed in declaration order:
+    //   - Passes that write nothing an output or a later live pass reads are culled and never recorded
+    //   - Barriers are derived from the declared accesses, only hazards and layout changes get one, and all of a pass are issued as one batch
+    //     with vkCmdPipelineBarrier2 (vkCmdPipelineBarrier when the device lacks VK_KHR_synchronization2)
+    //   - Transient images are owned by the graph and share memory when the passes using them do not overlap. Their contents do not survive
+    //     the frame. They are kept between frames and only recreated when their descriptions or the way they alias changes.
+    class VulkanRenderGraph {
+    private:
+        static const VkAllocationCallbacks* ALLOCATOR;
+
+        struct AccessInfo {
+            VkPipelineStageFlags2 Stages;
+            VkAccessFlags2 Access;
+            VkImageLayout Layout;
+        };
+
+        struct ResourceState {
+            VkImageLayout Layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            // The last write (or layout transition), which every later access has to wait for
+            VkPipelineStageFlags2 WriteStages = VK_PIPELINE_STAGE_2_NONE;
+            VkAccessFlags2 WriteAccess = VK_ACCESS_2_NONE;
+            // Stages that read since the last write, which the next write has to wait for
+            VkPipelineStageFlags2 ReadStages = VK_PIPELINE_STAGE_2_NONE;
+            // Where the last write has been made visible
+            VkPipelineStageFlags2 VisibleStages = VK_PIPELINE_STAGE_2_NONE;
+            VkAccessFlags2 VisibleAccess = VK_ACCESS_2_NONE;
+        };
+
+        struct TransientImage {
+            std::string Name;
+            RenderGraphImageDescription Description;
+            VkImage Image = VK_NULL_HANDLE;
+            VkImageView ImageView = VK_NULL_HANDLE;
+            VkMemoryRequirements MemoryRequirements{};
+            VkDeviceSize MemoryOffset = 0;
+            ResourceState State;
+            bool Declared = false;
+            // Live passes of the current frame using the image, FirstPass > LastPass if there are none
+            uint32_t FirstPass = 0;
+            uint32_t LastPass = 0;
+        };
+
+        struct Resource {
+            std::string Name;
+            VkImage Image = VK_NULL_HANDLE;
+            VkImageAspectFlags Aspect = 0;
+            VkBuffer Buffer = VK_NULL_HANDLE;
+            // Index into transientImages, UINT32_MAX for imported resources
+            uint32_t TransientImage = UINT32_MAX;
+            RenderGraphAccess FinalAccess = RenderGraphAccess::None;
+            ResourceState State;
+            bool Output = false;
+            bool Accessed = false;
+        };
+
+        struct ResourceUsage {
+            RenderGraphResource Resource;
+            AccessInfo Access;
+            bool Read;
+            bool Write;
+        };
+
+        struct Pass {
+            std::string Name;
+            std::function<void(const VulkanCommandBuffer&)> Record;
+            std::vector<ResourceUsage> Usages;
+            bool Live = false;
+        };
+
+    private:
+        VulkanPhysicalDevice* vulkanPhysicalDevice;
+        VulkanDevice* vulkanDevice;
+        std::vector<Resource> resources;
+        std::vector<Pass> passes;
+        std::vector<TransientImage> transientImages;
+        VkDeviceMemory transientMemory = VK_NULL_HANDLE;
+        bool transientImagesChanged = false;
+        std::vector<VkImageMemoryBarrier2KHR> imageBarriers;
+        std::vector<VkBufferMemoryBarrier2KHR> bufferBarriers;
+
+    public:
+        VulkanRenderGraph(VulkanPhysicalDevice* vulkanPhysicalDevice, VulkanDevice* vulkanDevice);
+
+        void terminate();
+
+        // Starts declaring the next frame, resources and passes of the previous one are invalid afterwards
+        void reset();
+
+        // The image is in the state of initialAccess when the frame starts and transitioned to finalAccess after the last live pass using it
+        RenderGraphResource importImage(const std::string& name, VkImage image, VkImageAspectFlags aspect, RenderGraphAccess initialAccess, RenderGraphAccess finalAccess);
+
+        RenderGraphResource importBuffer(const std::string& name, VkBuffer buffer, RenderGraphAccess initialAccess, RenderGraphAccess finalAccess);
+
+        // Images are identified by name between frames
+        RenderGraphResource createImage(const std::string& name, const RenderGraphImageDescription& description);
+
+        // Outputs keep the passes writing them, and the passes those depend on, from being culled
+        void setOutput(RenderGraphResource resource);
+
+        RenderGraphPass addPass(const std::string& name, const std::function<void(const VulkanCommandBuffer&)>& record);
+
+        void read(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access);
+
+        // Writes replace the contents, a pass that also depends on what was there before has to read the resource as well
+        void write(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access);
+
+        VkImage getImage(RenderGraphResource resource) const;
+
+        // Only created for transient images, valid once the graph has been compiled
+        VkImageView getImageView(RenderGraphResource resource) const;
+
+        // Culls passes and (re)creates transient images, returns false if they could not be created
+        bool compile();
+
+        // Records the live passes with the barriers they need, must be called outside of a render pass
+        void execute(const VulkanCommandBuffer& vulkanCommandBuffer);
+
+    private:
+        static AccessInfo getAccessInfo(RenderGraphAccess access);
+
+        void addUsage(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access, bool read, bool write);
+
+        void cullPasses();
+
+        void findTransientImageLifetimes();
+
+        std::vector<VkDeviceSize> findTransientImageOffsets() const;
+
+        bool createTransientImages();
+
+        bool allocateTransientMemory(const std::vector<VkDeviceSize>& offsets);
+
+        void destroyTransientImages();
+
+        bool isMemoryOverlapping(const TransientImage& transientImage, const TransientImage& otherTransientImage) const;
+
+        // Transient images start every frame undefined, after whatever used their memory last
+        void beginTransientImage(const Resource& resource);
+
+        void addBarrier(Resource& resource, const AccessInfo& access, bool write);
+
+        void recordBarriers(const VulkanCommandBuffer& vulkanCommandBuffer);
+
+        bool findMemoryType(uint32_t memoryTypeBits, VkMemoryPropertyFlags memoryProperties, uint32_t& memoryTypeIndex) const;
+    };
+
+}
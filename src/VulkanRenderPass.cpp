@@ -13,6 +13,10 @@ namespace Vulkandemo {
         return renderPass;
     }
 
+    VkFormat VulkanRenderPass::getColorFormat() const {
+        return vulkanSwapChain->getSurfaceFormat().format;
+    }
+
     bool VulkanRenderPass::initialize() {
         VkAttachmentDescription colorAttachment{};
         colorAttachment.format = vulkanSwapChain->getSurfaceFormat().format;
@@ -21,8 +25,9 @@ namespace Vulkandemo {
         colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
         colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        // Layout transitions and the dependency on the acquired swap chain image are recorded by the render graph
+        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
         VkAttachmentReference colorAttachmentRef{};
         colorAttachmentRef.attachment = 0;
@@ -33,22 +38,13 @@ namespace Vulkandemo {
         subpass.colorAttachmentCount = 1;
         subpass.pColorAttachments = &colorAttachmentRef;
 
-        VkSubpassDependency dependency{};
-        dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-        dependency.dstSubpass = 0;
-        dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependency.srcAccessMask = 0;
-        dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
         VkRenderPassCreateInfo renderPassInfo{};
         renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
         renderPassInfo.attachmentCount = 1;
         renderPassInfo.pAttachments = &colorAttachment;
         renderPassInfo.subpassCount = 1;
         renderPassInfo.pSubpasses = &subpass;
-        renderPassInfo.dependencyCount = 1;
-        renderPassInfo.pDependencies = &dependency;
+        renderPassInfo.dependencyCount = 0;
 
         if (vkCreateRenderPass(vulkanDevice->getDevice(), &renderPassInfo, ALLOCATOR, &renderPass) != VK_SUCCESS) {
             VD_LOG_ERROR("Could not create Vulkan render pass");
@@ -59,8 +55,11 @@ namespace Vulkandemo {
     }
 
     void VulkanRenderPass::terminate() {
-        vkDestroyRenderPass(vulkanDevice->getDevice(), renderPass, ALLOCATOR);
-        VD_LOG_INFO("Destroyed Vulkan render pass");
+        vulkanDevice->getDeletionQueue()->destroyLater([device = vulkanDevice->getDevice(), renderPass = renderPass]() {
+            vkDestroyRenderPass(device, renderPass, ALLOCATOR);
+            VD_LOG_INFO("Destroyed Vulkan render pass");
+        });
+        renderPass = VK_NULL_HANDLE;
     }
 
     void VulkanRenderPass::begin(const VulkanCommandBuffer& vulkanCommandBuffer, const VulkanFramebuffer& vulkanFramebuffer) const {
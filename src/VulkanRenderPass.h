@@ -25,6 +25,8 @@ namespace Vulkandemo {
 
         const VkRenderPass getRenderPass() const;
 
+        VkFormat getColorFormat() const;
+
         bool initialize();
 
         void terminate();
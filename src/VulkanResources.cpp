@@ -0,0 +1,77 @@
+#include "VulkanResources.h"
+#include "Log.h"
+
+namespace Vulkandemo {
+
+    VulkanResources::VulkanResources(VulkanPhysicalDevice* vulkanPhysicalDevice, VulkanDevice* vulkanDevice)
+            : vulkanPhysicalDevice(vulkanPhysicalDevice), vulkanDevice(vulkanDevice) {
+    }
+
+    void VulkanResources::terminate() {
+        if (buffers.getCount() > 0 || framebuffers.getCount() > 0) {
+            VD_LOG_WARN("Destroying [{}] Vulkan buffers and [{}] Vulkan framebuffers that are still alive", buffers.getCount(), framebuffers.getCount());
+        }
+        for (VulkanBuffer& buffer : buffers) {
+            buffer.terminate();
+        }
+        buffers.clear();
+        for (VulkanFramebuffer& framebuffer : framebuffers) {
+            framebuffer.terminate();
+        }
+        framebuffers.clear();
+        VD_LOG_INFO("Destroyed Vulkan resources");
+    }
+
+    VulkanBufferHandle VulkanResources::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags memoryProperties) {
+        VulkanBuffer buffer(vulkanPhysicalDevice, vulkanDevice);
+        if (!buffer.initialize(size, usage, memoryProperties)) {
+            buffer.terminate();
+            return {};
+        }
+        return buffers.add(buffer);
+    }
+
+    VulkanBuffer* VulkanResources::getBuffer(VulkanBufferHandle handle) {
+        return buffers.get(handle);
+    }
+
+    void VulkanResources::destroyBuffer(VulkanBufferHandle handle) {
+        VulkanBuffer* buffer = buffers.get(handle);
+        if (buffer == nullptr) {
+            return;
+        }
+        buffer->terminate();
+        buffers.remove(handle);
+    }
+
+    VkDeviceSize VulkanResources::getBufferMemorySize() const {
+        VkDeviceSize size = 0;
+        for (const VulkanBuffer& buffer : buffers) {
+            size += buffer.getSize();
+        }
+        return size;
+    }
+
+    VulkanFramebufferHandle VulkanResources::createFramebuffer(VulkanSwapChain* vulkanSwapChain, VulkanRenderPass* vulkanRenderPass, VkImageView imageView) {
+        VulkanFramebuffer framebuffer(vulkanDevice, vulkanSwapChain, vulkanRenderPass);
+        if (!framebuffer.initialize(imageView)) {
+            return {};
+        }
+        return framebuffers.add(framebuffer);
+    }
+
+    VulkanFramebuffer* VulkanResources::getFramebuffer(VulkanFramebufferHandle handle) {
+        return framebuffers.get(handle);
+    }
+
+    void VulkanResources::destroyFramebuffer(VulkanFramebufferHandle handle) {
+        VulkanFramebuffer* framebuffer = framebuffers.get(handle);
+        if (framebuffer == nullptr) {
+            return;
+        }
+        // Destroyed by the deletion queue once no frame in flight uses it
+        framebuffer->terminate();
+        framebuffers.remove(handle);
+    }
+
+}
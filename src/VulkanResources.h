@@ -0,0 +1,58 @@
+#pragma once
+
+#include "ResourcePool.h"
+#include "VulkanBuffer.h"
+#include "VulkanDevice.h"
+#include "VulkanFramebuffer.h"
+#include "VulkanPhysicalDevice.h"
+#include "VulkanRenderPass.h"
+#include "VulkanSwapChain.h"
+
+#include <vulkan/vulkan.h>
+
+namespace Vulkandemo {
+
+    using VulkanBufferHandle = ResourceHandle<VulkanBuffer>;
+    using VulkanFramebufferHandle = ResourceHandle<VulkanFramebuffer>;
+
+}
+
+namespace Vulkandemo {
+
+    // Owns buffers and framebuffers by value in dense pools and hands out 32-bit handles instead of pointers, so a handle that outlives its
+    // resource is detected instead of dangling. Not thread safe, resources are created and looked up by the thread that renders.
+    class VulkanResources {
+    private:
+        VulkanPhysicalDevice* vulkanPhysicalDevice;
+        VulkanDevice* vulkanDevice;
+        ResourcePool<VulkanBuffer> buffers;
+        ResourcePool<VulkanFramebuffer> framebuffers;
+
+    public:
+        VulkanResources(VulkanPhysicalDevice* vulkanPhysicalDevice, VulkanDevice* vulkanDevice);
+
+        // Destroys the resources that are still alive
+        void terminate();
+
+        // Returns an invalid handle if the buffer could not be created
+        VulkanBufferHandle createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags memoryProperties);
+
+        // Returns nullptr for stale handles. The pointer is only valid until the next buffer is created or destroyed.
+        VulkanBuffer* getBuffer(VulkanBufferHandle handle);
+
+        // The handle is stale right away, the buffer is destroyed once the submissions made so far have completed
+        void destroyBuffer(VulkanBufferHandle handle);
+
+        // Sum of the sizes of all buffers
+        VkDeviceSize getBufferMemorySize() const;
+
+        // Returns an invalid handle if the framebuffer could not be created
+        VulkanFramebufferHandle createFramebuffer(VulkanSwapChain* vulkanSwapChain, VulkanRenderPass* vulkanRenderPass, VkImageView imageView);
+
+        // Returns nullptr for stale handles. The pointer is only valid until the next framebuffer is created or destroyed.
+        VulkanFramebuffer* getFramebuffer(VulkanFramebufferHandle handle);
+
+        void destroyFramebuffer(VulkanFramebufferHandle handle);
+    };
+
+}
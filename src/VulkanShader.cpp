@@ -1,4 +1,5 @@
 #include "VulkanShader.h"
+#include "Hash.h"
 #include "Log.h"
 
 namespace Vulkandemo {
@@ -12,11 +13,30 @@ namespace Vulkandemo {
         return shaderModule;
     }
 
-    bool VulkanShader::initialize(const std::vector<char>& bytes) {
+    const VulkanShaderReflection& VulkanShader::getReflection() const {
+        return reflection;
+    }
+
+    uint64_t VulkanShader::getCodeHash() const {
+        return codeHash;
+    }
+
+    bool VulkanShader::initialize(const uint32_t* code, size_t codeSize) {
+        // SPIR-V is a stream of 32-bit words, so the code size must be a non-zero multiple of 4 bytes
+        if (code == nullptr || codeSize == 0 || codeSize % sizeof(uint32_t) != 0) {
+            VD_LOG_ERROR("Could not use shader code with size [{}]", codeSize);
+            return false;
+        }
+        if (!reflection.parse(code, codeSize)) {
+            VD_LOG_ERROR("Could not reflect shader code");
+            return false;
+        }
+        codeHash = hashBytes(code, codeSize);
+
         VkShaderModuleCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        createInfo.codeSize = bytes.size();
-        createInfo.pCode = (const uint32_t*) bytes.data();
+        createInfo.codeSize = codeSize;
+        createInfo.pCode = code;
 
         if (vkCreateShaderModule(vulkanDevice->getDevice(), &createInfo, ALLOCATOR, &shaderModule) != VK_SUCCESS) {
             VD_LOG_ERROR("Could not create Vulkan shader module");
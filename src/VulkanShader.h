@@ -1,10 +1,11 @@
 #pragma once
 
 #include "VulkanDevice.h"
+#include "VulkanShaderReflection.h"
 
 #include <vulkan/vulkan.h>
 
-#include <vector>
+#include <cstdint>
 
 namespace Vulkandemo {
 
@@ -15,13 +16,20 @@ namespace Vulkandemo {
     private:
         VulkanDevice* vulkanDevice;
         VkShaderModule shaderModule = VK_NULL_HANDLE;
+        VulkanShaderReflection reflection;
+        uint64_t codeHash = 0;
 
     public:
         explicit VulkanShader(VulkanDevice* vulkanDevice);
 
         const VkShaderModule getShaderModule() const;
 
-        bool initialize(const std::vector<char>& bytes);
+        const VulkanShaderReflection& getReflection() const;
+
+        // Hash of the SPIR-V code, equal for shaders with identical code
+        uint64_t getCodeHash() const;
+
+        bool initialize(const uint32_t* code, size_t codeSize);
 
         void terminate();
     };
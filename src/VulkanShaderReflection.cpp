@@ -0,0 +1,494 @@
+#include "VulkanShaderReflection.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Vulkandemo {
+
+    // See the SPIR-V specification (https://registry.khronos.org/SPIR-V/specs/unified1/SPIRV.html) for the values below
+    constexpr uint32_t SPIRV_MAGIC_NUMBER = 0x07230203;
+    constexpr uint32_t SPIRV_HEADER_WORD_COUNT = 5;
+
+    enum SpirvOpcode : uint32_t {
+        OpName = 5,
+        OpEntryPoint = 15,
+        OpTypeBool = 20,
+        OpTypeInt = 21,
+        OpTypeFloat = 22,
+        OpTypeVector = 23,
+        OpTypeMatrix = 24,
+        OpTypeImage = 25,
+        OpTypeSampler = 26,
+        OpTypeSampledImage = 27,
+        OpTypeArray = 28,
+        OpTypeRuntimeArray = 29,
+        OpTypeStruct = 30,
+        OpTypePointer = 32,
+        OpConstantTrue = 41,
+        OpConstantFalse = 42,
+        OpConstant = 43,
+        OpSpecConstantTrue = 48,
+        OpSpecConstantFalse = 49,
+        OpSpecConstant = 50,
+        OpFunction = 54,
+        OpVariable = 59,
+        OpDecorate = 71,
+        OpMemberDecorate = 72,
+        OpTypeAccelerationStructureKHR = 5341
+    };
+
+    enum SpirvDecoration : uint32_t {
+        DecorationSpecId = 1,
+        DecorationBufferBlock = 3,
+        DecorationArrayStride = 6,
+        DecorationMatrixStride = 7,
+        DecorationBuiltIn = 11,
+        DecorationLocation = 30,
+        DecorationBinding = 33,
+        DecorationDescriptorSet = 34,
+        DecorationOffset = 35
+    };
+
+    enum SpirvStorageClass : uint32_t {
+        StorageClassUniformConstant = 0,
+        StorageClassInput = 1,
+        StorageClassUniform = 2,
+        StorageClassPushConstant = 9,
+        StorageClassStorageBuffer = 12
+    };
+
+    enum SpirvDim : uint32_t {
+        DimBuffer = 5,
+        DimSubpassData = 6
+    };
+
+    static VkShaderStageFlagBits getShaderStage(uint32_t executionModel) {
+        switch (executionModel) {
+            case 0:
+                return VK_SHADER_STAGE_VERTEX_BIT;
+            case 1:
+                return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+            case 2:
+                return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+            case 3:
+                return VK_SHADER_STAGE_GEOMETRY_BIT;
+            case 4:
+                return VK_SHADER_STAGE_FRAGMENT_BIT;
+            case 5:
+                return VK_SHADER_STAGE_COMPUTE_BIT;
+            default:
+                return VK_SHADER_STAGE_ALL;
+        }
+    }
+
+    // Literal strings are nul-terminated and padded to a whole number of words
+    static std::string readString(const uint32_t* words, uint32_t wordCount) {
+        const auto* characters = (const char*) words;
+        size_t maxLength = (size_t) wordCount * sizeof(uint32_t);
+        return {characters, strnlen(characters, maxLength)};
+    }
+
+    bool VulkanShaderReflection::parse(const uint32_t* code, size_t codeSize) {
+        size_t wordCount = codeSize / sizeof(uint32_t);
+        if (code == nullptr || wordCount < SPIRV_HEADER_WORD_COUNT || code[0] != SPIRV_MAGIC_NUMBER) {
+            VD_LOG_ERROR("Could not reflect shader code that is not SPIR-V");
+            return false;
+        }
+
+        size_t offset = SPIRV_HEADER_WORD_COUNT;
+        while (offset < wordCount) {
+            uint32_t instructionWordCount = code[offset] >> 16;
+            uint32_t opcode = code[offset] & 0xFFFF;
+            if (instructionWordCount == 0 || offset + instructionWordCount > wordCount) {
+                VD_LOG_ERROR("Could not reflect shader with malformed instruction at word [{}]", offset);
+                return false;
+            }
+            const uint32_t* operands = code + offset + 1;
+            uint32_t operandCount = instructionWordCount - 1;
+            offset += instructionWordCount;
+
+            // All declarations precede the function definitions
+            if (opcode == OpFunction) {
+                break;
+            }
+            switch (opcode) {
+                case OpEntryPoint:
+                    if (entryPoint.empty() && operandCount >= 3) {
+                        stage = getShaderStage(operands[0]);
+                        entryPoint = readString(operands + 2, operandCount - 2);
+                    }
+                    break;
+                case OpName:
+                    if (operandCount >= 2) {
+                        names[operands[0]] = readString(operands + 1, operandCount - 1);
+                    }
+                    break;
+                case OpDecorate: {
+                    if (operandCount < 2) {
+                        break;
+                    }
+                    Decorations& target = decorations[operands[0]];
+                    uint32_t value = operandCount >= 3 ? operands[2] : 0;
+                    switch (operands[1]) {
+                        case DecorationSpecId:
+                            target.SpecId = value;
+                            target.HasSpecId = true;
+                            break;
+                        case DecorationBufferBlock:
+                            target.BufferBlock = true;
+                            break;
+                        case DecorationArrayStride:
+                            target.ArrayStride = value;
+                            break;
+                        case DecorationBuiltIn:
+                            target.BuiltIn = true;
+                            break;
+                        case DecorationLocation:
+                            target.Location = value;
+                            target.HasLocation = true;
+                            break;
+                        case DecorationBinding:
+                            target.Binding = value;
+                            target.HasBinding = true;
+                            break;
+                        case DecorationDescriptorSet:
+                            target.Set = value;
+                            break;
+                        default:
+                            break;
+                    }
+                    break;
+                }
+                case OpMemberDecorate: {
+                    if (operandCount < 3) {
+                        break;
+                    }
+                    Decorations& target = decorations[operands[0]];
+                    uint32_t member = operands[1];
+                    uint32_t value = operandCount >= 4 ? operands[3] : 0;
+                    if (operands[2] == DecorationOffset) {
+                        target.MemberOffsets.resize(std::max((uint32_t) target.MemberOffsets.size(), member + 1));
+                        target.MemberOffsets[member] = value;
+                    } else if (operands[2] == DecorationMatrixStride) {
+                        target.MemberMatrixStrides.resize(std::max((uint32_t) target.MemberMatrixStrides.size(), member + 1));
+                        target.MemberMatrixStrides[member] = value;
+                    } else if (operands[2] == DecorationBuiltIn) {
+                        // Blocks of built-ins such as gl_PerVertex
+                        target.BuiltIn = true;
+                    }
+                    break;
+                }
+                case OpTypeBool:
+                case OpTypeSampler:
+                case OpTypeStruct:
+                case OpTypeAccelerationStructureKHR:
+                    if (operandCount >= 1) {
+                        types[operands[0]] = {opcode, std::vector<uint32_t>(operands + 1, operands + operandCount)};
+                    }
+                    break;
+                case OpTypeInt:
+                case OpTypeFloat:
+                case OpTypeSampledImage:
+                case OpTypeRuntimeArray:
+                    if (operandCount >= 2) {
+                        types[operands[0]] = {opcode, std::vector<uint32_t>(operands + 1, operands + operandCount)};
+                    }
+                    break;
+                case OpTypeVector:
+                case OpTypeMatrix:
+                case OpTypeArray:
+                case OpTypePointer:
+                case OpTypeImage:
+                    if (operandCount >= 3) {
+                        types[operands[0]] = {opcode, std::vector<uint32_t>(operands + 1, operands + operandCount)};
+                    }
+                    break;
+                case OpConstantTrue:
+                case OpConstantFalse:
+                case OpSpecConstantTrue:
+                case OpSpecConstantFalse:
+                    if (operandCount >= 2) {
+                        bool value = opcode == OpConstantTrue || opcode == OpSpecConstantTrue;
+                        bool specialization = opcode == OpSpecConstantTrue || opcode == OpSpecConstantFalse;
+                        constants[operands[1]] = {operands[0], value ? 1u : 0u, specialization};
+                    }
+                    break;
+                case OpConstant:
+                case OpSpecConstant:
+                    if (operandCount >= 3) {
+                        constants[operands[1]] = {operands[0], operands[2], opcode == OpSpecConstant};
+                    }
+                    break;
+                case OpVariable:
+                    if (operandCount >= 3) {
+                        variables.push_back({operands[1], operands[0], operands[2]});
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        if (entryPoint.empty()) {
+            VD_LOG_ERROR("Could not find entry point in shader");
+            return false;
+        }
+
+        reflectVariables();
+        reflectSpecializationConstants();
+
+        // Only needed while parsing
+        names.clear();
+        decorations.clear();
+        types.clear();
+        constants.clear();
+        variables.clear();
+        return true;
+    }
+
+    const std::string& VulkanShaderReflection::getEntryPoint() const {
+        return entryPoint;
+    }
+
+    VkShaderStageFlagBits VulkanShaderReflection::getStage() const {
+        return stage;
+    }
+
+    const std::vector<ShaderInput>& VulkanShaderReflection::getInputs() const {
+        return inputs;
+    }
+
+    const std::vector<ShaderDescriptorBinding>& VulkanShaderReflection::getDescriptorBindings() const {
+        return descriptorBindings;
+    }
+
+    const std::vector<VkPushConstantRange>& VulkanShaderReflection::getPushConstantRanges() const {
+        return pushConstantRanges;
+    }
+
+    const std::vector<ShaderSpecializationConstant>& VulkanShaderReflection::getSpecializationConstants() const {
+        return specializationConstants;
+    }
+
+    void VulkanShaderReflection::reflectVariables() {
+        for (const Variable& variable : variables) {
+            const Type* pointerType = findType(variable.PointerType);
+            if (pointerType == nullptr || pointerType->Opcode != OpTypePointer || pointerType->Operands.size() < 2) {
+                continue;
+            }
+            uint32_t typeId = pointerType->Operands[1];
+            const Decorations* variableDecorations = findDecorations(variable.Id);
+            const Decorations* typeDecorations = findDecorations(typeId);
+
+            switch (variable.StorageClass) {
+                case StorageClassInput: {
+                    bool builtIn = (variableDecorations != nullptr && variableDecorations->BuiltIn) || (typeDecorations != nullptr && typeDecorations->BuiltIn);
+                    if (builtIn || variableDecorations == nullptr || !variableDecorations->HasLocation) {
+                        break;
+                    }
+                    inputs.push_back({variableDecorations->Location, getFormat(typeId), getTypeSize(typeId), findName(variable.Id)});
+                    break;
+                }
+                case StorageClassUniformConstant:
+                case StorageClassUniform:
+                case StorageClassStorageBuffer: {
+                    if (variableDecorations == nullptr || !variableDecorations->HasBinding) {
+                        break;
+                    }
+                    VkDescriptorType descriptorType;
+                    uint32_t descriptorCount;
+                    if (!reflectDescriptorType(typeId, descriptorType, descriptorCount)) {
+                        VD_LOG_WARN("Could not reflect descriptor type of shader variable [{}]", findName(variable.Id));
+                        break;
+                    }
+                    if (variable.StorageClass == StorageClassStorageBuffer) {
+                        descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                    }
+                    descriptorBindings.push_back({variableDecorations->Set, variableDecorations->Binding, descriptorType, descriptorCount, findName(variable.Id)});
+                    break;
+                }
+                case StorageClassPushConstant: {
+                    uint32_t size = getTypeSize(typeId);
+                    uint32_t offset = size;
+                    if (typeDecorations != nullptr) {
+                        for (uint32_t memberOffset : typeDecorations->MemberOffsets) {
+                            offset = std::min(offset, memberOffset);
+                        }
+                    }
+                    if (size > offset) {
+                        pushConstantRanges.push_back({(VkShaderStageFlags) stage, offset, size - offset});
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+        std::sort(inputs.begin(), inputs.end(), [](const ShaderInput& a, const ShaderInput& b) {
+            return a.Location < b.Location;
+        });
+        std::sort(descriptorBindings.begin(), descriptorBindings.end(), [](const ShaderDescriptorBinding& a, const ShaderDescriptorBinding& b) {
+            return a.Set != b.Set ? a.Set < b.Set : a.Binding < b.Binding;
+        });
+    }
+
+    void VulkanShaderReflection::reflectSpecializationConstants() {
+        for (const auto& [id, constant] : constants) {
+            const Decorations* constantDecorations = findDecorations(id);
+            if (!constant.Specialization || constantDecorations == nullptr || !constantDecorations->HasSpecId) {
+                continue;
+            }
+            specializationConstants.push_back({constantDecorations->SpecId, getTypeSize(constant.Type), constant.Value, findName(id)});
+        }
+        std::sort(specializationConstants.begin(), specializationConstants.end(), [](const ShaderSpecializationConstant& a, const ShaderSpecializationConstant& b) {
+            return a.ConstantId < b.ConstantId;
+        });
+    }
+
+    bool VulkanShaderReflection::reflectDescriptorType(uint32_t typeId, VkDescriptorType& descriptorType, uint32_t& descriptorCount) const {
+        descriptorCount = 1;
+        const Type* type = findType(typeId);
+
+        // Arrays of resources are a single binding with one descriptor per element
+        while (type != nullptr && (type->Opcode == OpTypeArray || type->Opcode == OpTypeRuntimeArray)) {
+            if (type->Opcode == OpTypeRuntimeArray) {
+                descriptorCount = 0;
+            } else {
+                auto iterator = constants.find(type->Operands.size() >= 2 ? type->Operands[1] : 0);
+                descriptorCount *= iterator != constants.end() ? iterator->second.Value : 1;
+            }
+            typeId = type->Operands.empty() ? 0 : type->Operands[0];
+            type = findType(typeId);
+        }
+        if (type == nullptr) {
+            return false;
+        }
+
+        switch (type->Opcode) {
+            case OpTypeSampler:
+                descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+                return true;
+            case OpTypeSampledImage: {
+                const Type* imageType = findType(type->Operands.empty() ? 0 : type->Operands[0]);
+                bool texelBuffer = imageType != nullptr && imageType->Operands.size() >= 2 && imageType->Operands[1] == DimBuffer;
+                descriptorType = texelBuffer ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                return true;
+            }
+            case OpTypeImage: {
+                if (type->Operands.size() < 6) {
+                    return false;
+                }
+                uint32_t dim = type->Operands[1];
+                // 1 = used with a sampler, 2 = used without a sampler (storage)
+                bool storage = type->Operands[5] == 2;
+                if (dim == DimBuffer) {
+                    descriptorType = storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                } else if (dim == DimSubpassData) {
+                    descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                } else {
+                    descriptorType = storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                }
+                return true;
+            }
+            case OpTypeStruct: {
+                const Decorations* typeDecorations = findDecorations(typeId);
+                bool bufferBlock = typeDecorations != nullptr && typeDecorations->BufferBlock;
+                descriptorType = bufferBlock ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                return true;
+            }
+            case OpTypeAccelerationStructureKHR:
+                descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    uint32_t VulkanShaderReflection::getTypeSize(uint32_t typeId, uint32_t matrixStride) const {
+        const Type* type = findType(typeId);
+        if (type == nullptr) {
+            return 0;
+        }
+        switch (type->Opcode) {
+            case OpTypeBool:
+                return sizeof(VkBool32);
+            case OpTypeInt:
+            case OpTypeFloat:
+                return type->Operands[0] / 8;
+            case OpTypeVector:
+                return type->Operands[1] * getTypeSize(type->Operands[0]);
+            case OpTypeMatrix:
+                return type->Operands[1] * (matrixStride != 0 ? matrixStride : getTypeSize(type->Operands[0]));
+            case OpTypeArray: {
+                auto iterator = constants.find(type->Operands[1]);
+                uint32_t length = iterator != constants.end() ? iterator->second.Value : 0;
+                const Decorations* arrayDecorations = findDecorations(typeId);
+                uint32_t stride = arrayDecorations != nullptr && arrayDecorations->ArrayStride != 0 ? arrayDecorations->ArrayStride : getTypeSize(type->Operands[0], matrixStride);
+                return length * stride;
+            }
+            case OpTypeStruct: {
+                const Decorations* structDecorations = findDecorations(typeId);
+                uint32_t size = 0;
+                uint32_t packedOffset = 0;
+                for (uint32_t member = 0; member < type->Operands.size(); member++) {
+                    uint32_t memberMatrixStride = 0;
+                    uint32_t memberOffset = packedOffset;
+                    if (structDecorations != nullptr && member < structDecorations->MemberMatrixStrides.size()) {
+                        memberMatrixStride = structDecorations->MemberMatrixStrides[member];
+                    }
+                    if (structDecorations != nullptr && member < structDecorations->MemberOffsets.size()) {
+                        memberOffset = structDecorations->MemberOffsets[member];
+                    }
+                    packedOffset = memberOffset + getTypeSize(type->Operands[member], memberMatrixStride);
+                    size = std::max(size, packedOffset);
+                }
+                return size;
+            }
+            case OpTypePointer:
+                return sizeof(uint64_t);
+            default:
+                return 0;
+        }
+    }
+
+    VkFormat VulkanShaderReflection::getFormat(uint32_t typeId) const {
+        static const VkFormat formats[3][4] = {
+                {VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT},
+                {VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT},
+                {VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT}
+        };
+        const Type* type = findType(typeId);
+        uint32_t componentCount = 1;
+        if (type != nullptr && type->Opcode == OpTypeVector) {
+            componentCount = type->Operands[1];
+            type = findType(type->Operands[0]);
+        }
+        if (type == nullptr || componentCount < 1 || componentCount > 4 || type->Operands[0] != 32) {
+            return VK_FORMAT_UNDEFINED;
+        }
+        if (type->Opcode == OpTypeFloat) {
+            return formats[0][componentCount - 1];
+        }
+        if (type->Opcode == OpTypeInt) {
+            bool signedness = type->Operands.size() >= 2 && type->Operands[1] == 1;
+            return formats[signedness ? 1 : 2][componentCount - 1];
+        }
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    const VulkanShaderReflection::Type* VulkanShaderReflection::findType(uint32_t typeId) const {
+        auto iterator = types.find(typeId);
+        return iterator != types.end() ? &iterator->second : nullptr;
+    }
+
+    const VulkanShaderReflection::Decorations* VulkanShaderReflection::findDecorations(uint32_t id) const {
+        auto iterator = decorations.find(id);
+        return iterator != decorations.end() ? &iterator->second : nullptr;
+    }
+
+    std::string VulkanShaderReflection::findName(uint32_t id) const {
+        auto iterator = names.find(id);
+        return iterator != names.end() ? iterator->second : std::string();
+    }
+
+}
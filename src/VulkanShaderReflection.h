@@ -0,0 +1,124 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Vulkandemo {
+
+    struct ShaderInput {
+        uint32_t Location;
+        VkFormat Format;
+        uint32_t Size;
+        std::string Name;
+    };
+
+    struct ShaderDescriptorBinding {
+        uint32_t Set;
+        uint32_t Binding;
+        VkDescriptorType DescriptorType;
+        // 0 for runtime sized arrays
+        uint32_t DescriptorCount;
+        std::string Name;
+    };
+
+    struct ShaderSpecializationConstant {
+        uint32_t ConstantId;
+        uint32_t Size;
+        uint32_t DefaultValue;
+        std::string Name;
+    };
+
+}
+
+namespace Vulkandemo {
+
+    // Minimal SPIR-V parser that extracts what is needed to build pipeline layouts and vertex input state
+    class VulkanShaderReflection {
+    private:
+        struct Type {
+            uint32_t Opcode = 0;
+            std::vector<uint32_t> Operands;
+        };
+
+        struct Decorations {
+            uint32_t Set = 0;
+            uint32_t Binding = 0;
+            uint32_t Location = 0;
+            uint32_t SpecId = 0;
+            uint32_t ArrayStride = 0;
+            bool HasBinding = false;
+            bool HasLocation = false;
+            bool HasSpecId = false;
+            bool BuiltIn = false;
+            bool BufferBlock = false;
+            std::vector<uint32_t> MemberOffsets;
+            std::vector<uint32_t> MemberMatrixStrides;
+        };
+
+        struct Variable {
+            uint32_t Id;
+            uint32_t PointerType;
+            uint32_t StorageClass;
+        };
+
+        struct Constant {
+            uint32_t Type;
+            uint32_t Value;
+            bool Specialization;
+        };
+
+    private:
+        std::string entryPoint;
+        VkShaderStageFlagBits stage = VK_SHADER_STAGE_ALL;
+        std::vector<ShaderInput> inputs;
+        std::vector<ShaderDescriptorBinding> descriptorBindings;
+        std::vector<VkPushConstantRange> pushConstantRanges;
+        std::vector<ShaderSpecializationConstant> specializationConstants;
+
+        std::unordered_map<uint32_t, std::string> names;
+        std::unordered_map<uint32_t, Decorations> decorations;
+        std::unordered_map<uint32_t, Type> types;
+        std::unordered_map<uint32_t, Constant> constants;
+        std::vector<Variable> variables;
+
+    public:
+        bool parse(const uint32_t* code, size_t codeSize);
+
+        const std::string& getEntryPoint() const;
+
+        VkShaderStageFlagBits getStage() const;
+
+        // Vertex stage inputs sorted by location (built-ins excluded)
+        const std::vector<ShaderInput>& getInputs() const;
+
+        // Sorted by set, then binding
+        const std::vector<ShaderDescriptorBinding>& getDescriptorBindings() const;
+
+        // At most one range, covering every member of the push constant block
+        const std::vector<VkPushConstantRange>& getPushConstantRanges() const;
+
+        const std::vector<ShaderSpecializationConstant>& getSpecializationConstants() const;
+
+    private:
+        void reflectVariables();
+
+        void reflectSpecializationConstants();
+
+        bool reflectDescriptorType(uint32_t typeId, VkDescriptorType& descriptorType, uint32_t& descriptorCount) const;
+
+        uint32_t getTypeSize(uint32_t typeId, uint32_t matrixStride = 0) const;
+
+        VkFormat getFormat(uint32_t typeId) const;
+
+        const Type* findType(uint32_t typeId) const;
+
+        const Decorations* findDecorations(uint32_t id) const;
+
+        std::string findName(uint32_t id) const;
+    };
+
+}
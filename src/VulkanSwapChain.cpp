@@ -21,6 +21,10 @@ namespace Vulkandemo {
         return extent;
     }
 
+    const std::vector<VkImage>& VulkanSwapChain::getImages() const {
+        return images;
+    }
+
     const std::vector<VkImageView>& VulkanSwapChain::getImageViews() const {
         return imageViews;
     }
@@ -56,13 +60,19 @@ namespace Vulkandemo {
     }
 
     void VulkanSwapChain::terminate() {
-        for (VkImageView imageView : imageViews) {
-            vkDestroyImageView(vulkanDevice->getDevice(), imageView, ALLOCATOR);
-        }
+        vulkanDevice->getDeletionQueue()->destroyLater([device = vulkanDevice->getDevice(), swapChain = swapChain, imageViews = imageViews]() {
+            for (VkImageView imageView : imageViews) {
+                vkDestroyImageView(device, imageView, ALLOCATOR);
+            }
+            VD_LOG_INFO("Destroyed Vulkan swap chain image views");
+            vkDestroySwapchainKHR(device, swapChain, ALLOCATOR);
+            VD_LOG_INFO("Destroyed Vulkan swap chain");
+        });
         imageViews.clear();
-        VD_LOG_INFO("Destroyed Vulkan swap chain image views");
-        vkDestroySwapchainKHR(vulkanDevice->getDevice(), swapChain, ALLOCATOR);
-        VD_LOG_INFO("Destroyed Vulkan swap chain");
+        images.clear();
+        // Still alive when initialize() follows right away, since the deletion queue only destroys it after the next frame completes
+        retiredSwapChain = swapChain;
+        swapChain = VK_NULL_HANDLE;
     }
 
     VkSurfaceFormatKHR VulkanSwapChain::chooseSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats) const {
@@ -144,7 +154,9 @@ namespace Vulkandemo {
         createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
         createInfo.presentMode = presentMode;
         createInfo.clipped = VK_TRUE;
-        createInfo.oldSwapchain = VK_NULL_HANDLE;
+        // Presentation from the retired swap chain can finish while the new one is created for the same surface
+        createInfo.oldSwapchain = retiredSwapChain;
+        retiredSwapChain = VK_NULL_HANDLE;
 
         return vkCreateSwapchainKHR(vulkanDevice->getDevice(), &createInfo, ALLOCATOR, &swapChain) == VK_SUCCESS;
     }
@@ -23,6 +23,7 @@ namespace Vulkandemo {
         VkPresentModeKHR presentMode{};
         VkExtent2D extent{};
         VkSwapchainKHR swapChain = VK_NULL_HANDLE;
+        VkSwapchainKHR retiredSwapChain = VK_NULL_HANDLE;
         std::vector<VkImage> images;
         std::vector<VkImageView> imageViews;
 
@@ -35,6 +36,8 @@ namespace Vulkandemo {
 
         const VkExtent2D& getExtent() const;
 
+        const std::vector<VkImage>& getImages() const;
+
         const std::vector<VkImageView>& getImageViews() const;
 
         bool initialize();
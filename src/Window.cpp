@@ -13,14 +13,12 @@ namespace Vulkandemo {
     }
 
     Size Window::getSizeInPixels() const {
-        int width = 0;
-        int height = 0;
-        glfwGetFramebufferSize(glfwWindow, &width, &height);
-        return { width, height };
+        return { userPointer.FramebufferWidth.load(), userPointer.FramebufferHeight.load() };
     }
 
     void Window::getSizeInPixels(int* width, int* height) const {
-        glfwGetFramebufferSize(glfwWindow, width, height);
+        *width = userPointer.FramebufferWidth;
+        *height = userPointer.FramebufferHeight;
     }
 
     Size Window::getSizeInScreenCoordinates() const {
@@ -38,6 +36,10 @@ namespace Vulkandemo {
         userPointer.OnMinimize = onMinimize;
     }
 
+    void Window::setOnKeyPress(const std::function<void(int)>& onKeyPress) {
+        userPointer.OnKeyPress = onKeyPress;
+    }
+
     bool Window::initialize() {
         bool glfwInitialized = glfwInit();
         if (!glfwInitialized) {
@@ -58,6 +60,13 @@ namespace Vulkandemo {
         }
         VD_LOG_INFO("Created GLFW window");
 
+        int width = 0;
+        int height = 0;
+        glfwGetFramebufferSize(glfwWindow, &width, &height);
+        userPointer.FramebufferWidth = width;
+        userPointer.FramebufferHeight = height;
+        userPointer.Iconified = isIconified();
+
         glfwSetWindowUserPointer(glfwWindow, &userPointer);
         glfwSetFramebufferSizeCallback(glfwWindow, onFramebufferSizeChange);
         glfwSetWindowIconifyCallback(glfwWindow, onWindowIconifyChange);
@@ -77,22 +86,20 @@ namespace Vulkandemo {
         return glfwWindowShouldClose(glfwWindow);
     }
 
+    void Window::close() const {
+        glfwSetWindowShouldClose(glfwWindow, true);
+    }
+
     void Window::pollEvents() const {
         glfwPollEvents();
     }
 
-    void Window::waitUntilNotMinimized() const {
-        int width = 0;
-        int height = 0;
-        getSizeInPixels(&width, &height);
-
-        bool iconified = isIconified();
+    void Window::waitEvents(double timeoutSeconds) const {
+        glfwWaitEventsTimeout(timeoutSeconds);
+    }
 
-        while (width == 0 || height == 0 || iconified) {
-            getSizeInPixels(&width, &height);
-            iconified = isIconified();
-            glfwWaitEvents();
-        }
+    bool Window::isMinimized() const {
+        return userPointer.Iconified || userPointer.FramebufferWidth == 0 || userPointer.FramebufferHeight == 0;
     }
 
     bool Window::isIconified() const {
@@ -101,18 +108,26 @@ namespace Vulkandemo {
 
     void Window::onFramebufferSizeChange(GLFWwindow* glfWwindow, int width, int height) {
         auto userPointer = (UserPointer*) glfwGetWindowUserPointer(glfWwindow);
+        userPointer->FramebufferWidth = width;
+        userPointer->FramebufferHeight = height;
         userPointer->OnResize(width, height);
     }
 
     void Window::onWindowIconifyChange(GLFWwindow* glfWwindow, int iconified) {
         auto userPointer = (UserPointer*) glfwGetWindowUserPointer(glfWwindow);
         bool minimized = iconified == 1;
+        userPointer->Iconified = minimized;
         userPointer->OnMinimize(minimized);
     }
 
     void Window::onKeyChange(GLFWwindow* glfwWindow, int key, int scanCode, int action, int mods) {
         if (action == GLFW_PRESS && key == GLFW_KEY_ESCAPE) {
             glfwSetWindowShouldClose(glfwWindow, true);
+            return;
+        }
+        auto userPointer = (UserPointer*) glfwGetWindowUserPointer(glfwWindow);
+        if (action == GLFW_PRESS && userPointer->OnKeyPress) {
+            userPointer->OnKeyPress(key);
         }
     }
 
@@ -3,6 +3,7 @@
 #define GLFW_INCLUDE_VULKAN
 
 #include <GLFW/glfw3.h>
+#include <atomic>
 #include <functional>
 #include <string>
 
@@ -31,6 +32,11 @@ namespace Vulkandemo {
         struct UserPointer {
             std::function<void(int, int)> OnResize;
             std::function<void(bool)> OnMinimize;
+            std::function<void(int)> OnKeyPress;
+            // Kept up to date by the callbacks, so other threads can read them without calling GLFW
+            std::atomic<int> FramebufferWidth{0};
+            std::atomic<int> FramebufferHeight{0};
+            std::atomic<bool> Iconified{false};
         };
 
     private:
@@ -51,17 +57,29 @@ namespace Vulkandemo {
 
         void setOnMinimize(const std::function<void(bool)>& onMinimize);
 
+        // Called with the GLFW key code, e.g. GLFW_KEY_C
+        void setOnKeyPress(const std::function<void(int)>& onKeyPress);
+
+        // Safe to call from any thread, as of the last processed events
         Size getSizeInPixels() const;
 
+        // Safe to call from any thread, as of the last processed events
         void getSizeInPixels(int* width, int* height) const;
 
         Size getSizeInScreenCoordinates() const;
 
         bool shouldClose() const;
 
+        // Safe to call from any thread
+        void close() const;
+
         void pollEvents() const;
 
-        void waitUntilNotMinimized() const;
+        // Sleeps until there are events to process or the timeout has passed, then processes them
+        void waitEvents(double timeoutSeconds) const;
+
+        // Minimized or no framebuffer to render to. Safe to call from any thread, as of the last processed events.
+        bool isMinimized() const;
 
     private:
         bool isIconified() const;
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Assert.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace Vulkandemo {
+
+    // Fixed capacity Chase-Lev deque (with the memory orderings of Lê et al., "Correct and Efficient Work-Stealing for Weak Memory Models"). The
+    // owning thread pushes and pops at the bottom, any other thread steals from the top, so the owner works newest first while thieves take the
+    // oldest items, which tend to be the biggest pieces of work.
+    template<typename T>
+    class WorkStealingDeque {
+    private:
+        std::unique_ptr<std::atomic<T*>[]> items;
+        int64_t mask;
+        alignas(64) std::atomic<int64_t> top{0};
+        alignas(64) std::atomic<int64_t> bottom{0};
+
+    public:
+        // The capacity must be a power of two
+        explicit WorkStealingDeque(uint32_t capacity) : items(new std::atomic<T*>[capacity]), mask((int64_t) capacity - 1) {
+            VD_ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+        }
+
+        // Owner only. Returns false when the deque is full.
+        bool push(T* item) {
+            int64_t b = bottom.load(std::memory_order_relaxed);
+            int64_t t = top.load(std::memory_order_acquire);
+            if (b - t > mask) {
+                return false;
+            }
+            items[b & mask].store(item, std::memory_order_relaxed);
+            // Publishes the item (and what it points to) to thieves that read bottom with acquire
+            bottom.store(b + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Owner only. Returns the most recently pushed item, or nullptr when the deque is empty.
+        T* pop() {
+            int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top.load(std::memory_order_relaxed);
+            if (t > b) {
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            T* item = items[b & mask].load(std::memory_order_relaxed);
+            if (t == b) {
+                // Last item, races with thieves
+                if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    item = nullptr;
+                }
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return item;
+        }
+
+        // Any thread. Returns the oldest item, or nullptr when the deque is empty or another thread took the item first.
+        T* steal() {
+            int64_t t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t b = bottom.load(std::memory_order_acquire);
+            if (t >= b) {
+                return nullptr;
+            }
+            T* item = items[t & mask].load(std::memory_order_relaxed);
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            return item;
+        }
+
+        // Approximate when other threads are pushing or stealing
+        bool isEmpty() const {
+            return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+        }
+    };
+
+}
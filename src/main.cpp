@@ -2,7 +2,11 @@
 #include "Environment.h"
 #include "Log.h"
 
-int main()
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv)
 {
     Vulkandemo::App::Config config{};
     config.Name = "Vulkandemo";
@@ -14,6 +18,48 @@ int main()
 #ifdef VD_DEBUG
     config.Vulkan.ValidationLayersEnabled = true;
 #endif
+#ifdef VD_SHADER_HOT_RELOAD
+    config.ShaderWatcher.Enabled = true;
+    config.ShaderWatcher.SourceDirectory = VD_SHADER_SOURCE_DIR;
+    config.ShaderWatcher.CompilerPath = VD_SHADER_COMPILER;
+#endif
+
+    // --instances <count>: Draw a grid of rotating copies of a few meshes
+    // --animated <fraction>: Rotate only this share of the instances, the others cost nothing per frame once their transforms are uploaded
+    // --zoom <factor>: Show part of the grid with a camera circling over it, so culling has objects to reject
+    // --pin-workers: Pin every job system worker to its own core
+    // --step-rate <hz>: Simulate this many fixed steps per second (60 by default), frames in between are interpolated
+    // --benchmark: Compare per-draw, instanced, indirect, CPU culled and GPU culled submission of 100k instances (unless --instances is given) and exit
+    // --cull-benchmark: Compare scalar, SIMD and multithreaded frustum culling of 1M spheres (or --instances) on the CPU and exit
+    bool instanceCountGiven = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--instances") == 0 && i + 1 < argc) {
+            config.Scene.InstanceCount = (uint32_t) std::strtoul(argv[++i], nullptr, 10);
+            config.Scene.MeshCount = 3;
+            config.Scene.RotationSpeed = 1.0f;
+            instanceCountGiven = true;
+        } else if (strcmp(argv[i], "--animated") == 0 && i + 1 < argc) {
+            config.Scene.AnimatedFraction = std::strtof(argv[++i], nullptr);
+        } else if (strcmp(argv[i], "--zoom") == 0 && i + 1 < argc) {
+            config.Scene.CameraZoom = std::strtof(argv[++i], nullptr);
+        } else if (strcmp(argv[i], "--step-rate") == 0 && i + 1 < argc) {
+            config.Simulation.StepSeconds = 1.0 / std::max(std::strtod(argv[++i], nullptr), 1.0);
+        } else if (strcmp(argv[i], "--pin-workers") == 0) {
+            config.JobSystem.PinWorkers = true;
+        } else if (strcmp(argv[i], "--benchmark") == 0) {
+            config.Benchmark.Enabled = true;
+        } else if (strcmp(argv[i], "--cull-benchmark") == 0) {
+            config.CullingBenchmark.Enabled = true;
+        }
+    }
+    if (config.CullingBenchmark.Enabled && instanceCountGiven) {
+        config.CullingBenchmark.SphereCount = config.Scene.InstanceCount;
+    }
+    if (config.Benchmark.Enabled && !instanceCountGiven) {
+        config.Scene.InstanceCount = 100000;
+        config.Scene.MeshCount = 3;
+        config.Scene.RotationSpeed = 1.0f;
+    }
 
     auto* app = new Vulkandemo::App(config);
     app->run();